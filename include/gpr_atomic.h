@@ -0,0 +1,188 @@
+#ifndef GPR_ATOMIC_H
+#define GPR_ATOMIC_H
+
+#include "gpr_types.h"
+
+// -------------------------------------------------------------------------
+// Atomic operations
+// -------------------------------------------------------------------------
+// Thin wrappers over the compiler intrinsics.
+// Loads have acquire semantics, stores have release semantics and every
+// read-modify-write operation is a full barrier.
+// add/xchg return the previous value, cas returns 1 on success.
+// -------------------------------------------------------------------------
+
+#if defined(_MSC_VER)
+
+#include <intrin.h>
+
+#pragma intrinsic(_InterlockedExchangeAdd)
+#pragma intrinsic(_InterlockedExchange)
+#pragma intrinsic(_InterlockedCompareExchange)
+#pragma intrinsic(_ReadWriteBarrier)
+
+static U32 gpr_atomic_load_U32(volatile U32 *p)
+{
+  U32 v = *p;
+  _ReadWriteBarrier();
+  return v;
+}
+
+static void gpr_atomic_store_U32(volatile U32 *p, U32 v)
+{
+  _ReadWriteBarrier();
+  *p = v;
+}
+
+static U32 gpr_atomic_add_U32(volatile U32 *p, U32 v)
+{
+  return (U32)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+}
+
+static U32 gpr_atomic_xchg_U32(volatile U32 *p, U32 v)
+{
+  return (U32)_InterlockedExchange((volatile long*)p, (long)v);
+}
+
+static I32 gpr_atomic_cas_U32(volatile U32 *p, U32 expected, U32 desired)
+{
+  return (U32)_InterlockedCompareExchange((volatile long*)p,
+    (long)desired, (long)expected) == expected;
+}
+
+static U64 gpr_atomic_load_U64(volatile U64 *p)
+{
+  // a 64 bits load is not atomic on 32 bits targets: use a dummy cas
+  return (U64)_InterlockedCompareExchange64((volatile __int64*)p, 0, 0);
+}
+
+static void gpr_atomic_store_U64(volatile U64 *p, U64 v)
+{
+  U64 old = *p;
+  while ((U64)_InterlockedCompareExchange64((volatile __int64*)p,
+    (__int64)v, (__int64)old) != old) old = *p;
+}
+
+static U64 gpr_atomic_add_U64(volatile U64 *p, U64 v)
+{
+  U64 old = *p;
+  U64 cur;
+  while ((cur = (U64)_InterlockedCompareExchange64((volatile __int64*)p,
+    (__int64)(old + v), (__int64)old)) != old) old = cur;
+  return old;
+}
+
+static I32 gpr_atomic_cas_U64(volatile U64 *p, U64 expected, U64 desired)
+{
+  return (U64)_InterlockedCompareExchange64((volatile __int64*)p,
+    (__int64)desired, (__int64)expected) == expected;
+}
+
+static void *gpr_atomic_load_ptr(void * volatile *p)
+{
+  void *v = *p;
+  _ReadWriteBarrier();
+  return v;
+}
+
+static void gpr_atomic_store_ptr(void * volatile *p, void *v)
+{
+  _ReadWriteBarrier();
+  *p = v;
+}
+
+#if defined(_WIN64)
+static void *gpr_atomic_xchg_ptr(void * volatile *p, void *v)
+{
+  return _InterlockedExchangePointer(p, v);
+}
+
+static I32 gpr_atomic_cas_ptr(void * volatile *p, void *expected, void *desired)
+{
+  return _InterlockedCompareExchangePointer(p, desired, expected) == expected;
+}
+#else
+static void *gpr_atomic_xchg_ptr(void * volatile *p, void *v)
+{
+  return (void*)_InterlockedExchange((volatile long*)p, (long)v);
+}
+
+static I32 gpr_atomic_cas_ptr(void * volatile *p, void *expected, void *desired)
+{
+  return (void*)_InterlockedCompareExchange((volatile long*)p,
+    (long)desired, (long)expected) == expected;
+}
+#endif
+
+#define gpr_atomic_fence()         _mm_mfence()
+#define gpr_atomic_acquire_fence() _ReadWriteBarrier()
+#define gpr_atomic_release_fence() _ReadWriteBarrier()
+#define gpr_compiler_fence()       _ReadWriteBarrier()
+#define gpr_cpu_pause()            _mm_pause()
+
+#else // gcc & clang
+
+static U32 gpr_atomic_load_U32(volatile U32 *p)
+{ return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+static void gpr_atomic_store_U32(volatile U32 *p, U32 v)
+{ __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+static U32 gpr_atomic_add_U32(volatile U32 *p, U32 v)
+{ return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+
+static U32 gpr_atomic_xchg_U32(volatile U32 *p, U32 v)
+{ return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+
+static I32 gpr_atomic_cas_U32(volatile U32 *p, U32 expected, U32 desired)
+{
+  return __atomic_compare_exchange_n(p, &expected, desired, 0,
+    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static U64 gpr_atomic_load_U64(volatile U64 *p)
+{ return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+static void gpr_atomic_store_U64(volatile U64 *p, U64 v)
+{ __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+static U64 gpr_atomic_add_U64(volatile U64 *p, U64 v)
+{ return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST); }
+
+static I32 gpr_atomic_cas_U64(volatile U64 *p, U64 expected, U64 desired)
+{
+  return __atomic_compare_exchange_n(p, &expected, desired, 0,
+    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static void *gpr_atomic_load_ptr(void * volatile *p)
+{ return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+
+static void gpr_atomic_store_ptr(void * volatile *p, void *v)
+{ __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+static void *gpr_atomic_xchg_ptr(void * volatile *p, void *v)
+{ return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST); }
+
+static I32 gpr_atomic_cas_ptr(void * volatile *p, void *expected, void *desired)
+{
+  return __atomic_compare_exchange_n(p, &expected, desired, 0,
+    __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#define gpr_atomic_fence()         __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define gpr_atomic_acquire_fence() __atomic_thread_fence(__ATOMIC_ACQUIRE)
+#define gpr_atomic_release_fence() __atomic_thread_fence(__ATOMIC_RELEASE)
+#define gpr_compiler_fence()       __asm__ __volatile__("" ::: "memory")
+
+#if defined(__i386__) || defined(__x86_64__)
+  #define gpr_cpu_pause() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+  #define gpr_cpu_pause() __asm__ __volatile__("yield")
+#else
+  #define gpr_cpu_pause() gpr_compiler_fence()
+#endif
+
+#endif
+
+#endif // GPR_ATOMIC_H
@@ -0,0 +1,83 @@
+#ifndef GPR_CONCURRENT_HASH_H
+#define GPR_CONCURRENT_HASH_H
+
+#include "gpr_types.h"
+#include "gpr_hash.h"
+#include "gpr_sync.h"
+
+// -------------------------------------------------------------------------
+// Concurrent hash
+// -------------------------------------------------------------------------
+// Keys are spread by their high hash bits over shards, each one a 
+// gpr_hash_t behind its own reader-writer lock: threads only contend when
+// they hit the same shard.
+// Values are copied in and out under the shard lock, a pointer to a value
+// would be invalidated by a concurrent insertion.
+// The allocator is called from every thread: it must be thread-safe.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// shards are padded to this size to avoid false sharing
+#define GPR_CONCURRENT_HASH_ALIGN 64
+
+typedef struct
+{
+  gpr_rwlock_t lock;
+  gpr_hash_t   hash;
+} gpr_concurrent_hash_shard_t;
+
+typedef struct
+{
+  char            *shards;
+  U32              shard_stride;
+  U32              shard_mask;   // number of shards - 1
+  gpr_allocator_t *allocator;
+} gpr_concurrent_hash_t;
+
+// creates in value the value of a missing key
+typedef void (*gpr_concurrent_hash_func_t)(U64 key, void *value, void *arg);
+
+// num_shards is rounded up to a power of two
+void _gpr_concurrent_hash_init    (gpr_concurrent_hash_t *ch, const U32 s, 
+                                   U32 num_shards, gpr_allocator_t *a);
+void _gpr_concurrent_hash_destroy (gpr_concurrent_hash_t *ch);
+I32  _gpr_concurrent_hash_has     (gpr_concurrent_hash_t *ch, U64 key);
+// copies the value of key, returns 0 if missing
+I32  _gpr_concurrent_hash_get     (gpr_concurrent_hash_t *ch, const U32 s, U64 key, 
+                                   void *value);
+void _gpr_concurrent_hash_set     (gpr_concurrent_hash_t *ch, const U32 s, U64 key,
+                                   const void *value);
+// returns 0 if key was missing
+I32  _gpr_concurrent_hash_remove  (gpr_concurrent_hash_t *ch, const U32 s, U64 key);
+// inserts the value created by func(key, value, arg) if key is missing,
+// func is called at most once per key while the shard is locked. 
+// copies the value of key and returns 1 if it was created
+I32  _gpr_concurrent_hash_compute_if_absent (gpr_concurrent_hash_t *ch, 
+                                   const U32 s, U64 key, 
+                                   gpr_concurrent_hash_func_t func, void *arg,
+                                   void *value);
+// number of values, only exact when no thread is writing
+U32  _gpr_concurrent_hash_size    (gpr_concurrent_hash_t *ch);
+
+#define gpr_concurrent_hash_init(type, ch, num_shards, alct) \
+  _gpr_concurrent_hash_init(ch, sizeof(type), num_shards, alct)
+#define gpr_concurrent_hash_destroy(type, ch)        _gpr_concurrent_hash_destroy(ch)
+#define gpr_concurrent_hash_has(type, ch, key)       _gpr_concurrent_hash_has(ch, key)
+#define gpr_concurrent_hash_get(type, ch, key, value) \
+  _gpr_concurrent_hash_get(ch, sizeof(type), key, value)
+#define gpr_concurrent_hash_set(type, ch, key, value) \
+  _gpr_concurrent_hash_set(ch, sizeof(type), key, value)
+#define gpr_concurrent_hash_remove(type, ch, key) \
+  _gpr_concurrent_hash_remove(ch, sizeof(type), key)
+#define gpr_concurrent_hash_compute_if_absent(type, ch, key, func, arg, value) \
+  _gpr_concurrent_hash_compute_if_absent(ch, sizeof(type), key, func, arg, value)
+#define gpr_concurrent_hash_size(type, ch)           _gpr_concurrent_hash_size(ch)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_CONCURRENT_HASH_H
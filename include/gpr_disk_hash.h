@@ -0,0 +1,93 @@
+#ifndef GPR_DISK_HASH_H
+#define GPR_DISK_HASH_H
+
+#include "gpr_types.h"
+#include "gpr_file.h"
+
+// -------------------------------------------------------------------------
+// Disk resident hash
+// -------------------------------------------------------------------------
+// A chained hash living in a memory mapped file: the table is opened in
+// place, without loading, and may be larger than the memory since the page
+// cache keeps only the pages in use.
+//
+// File layout: header | entries | buckets
+// Entries hold the key, the chain link and the value. They are appended in
+// insertion order and removed ones are reused. When the entries are full,
+// the file grows and only the small bucket array is moved after them.
+// When the buckets are too loaded they are doubled and rebuilt with a
+// sequential scan of the entries: reserve the capacity up front to avoid
+// it on large tables.
+//
+// The file is written to the disk every sync_interval updates, at
+// gpr_disk_hash_sync and at gpr_disk_hash_close. Updates since the last
+// sync may be lost if the process or the system crashes.
+// A value pointer is valid until the next update: the file may be mapped
+// again when it grows.
+// Functions return 0 on failure, the table must then be closed. The values
+// are copied raw: the file is only portable between machines of the same
+// endianness.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPR_DISK_HASH_MAGIC 0x48445047u // 'GPDH'
+
+// the entries start at a multiple of this size
+#define GPR_DISK_HASH_ALIGN 64
+
+typedef struct
+{
+  U32 magic;
+  U32 value_size;
+  U32 entry_size;       // key, link & value, 8 bytes aligned
+  U32 num_values;
+  U32 num_entries;      // entries ever appended, free ones included
+  U32 entries_capacity;
+  U32 num_buckets;      // power of two
+  U32 free_head;        // removed entries, linked by their next field
+  U64 buckets_pos;      // right after the entries
+} gpr_disk_hash_header_t;
+
+typedef struct
+{
+  gpr_file_map_t map;
+  U32            sync_interval; // updates between syncs, 0: never
+  U32            num_unsynced;
+} gpr_disk_hash_t;
+
+// opens the table stored at path, or creates it if the file is missing
+// fails if the file holds another type of values
+I32   _gpr_disk_hash_open    (gpr_disk_hash_t *dh, const U32 s, const char *path,
+                              U32 sync_interval);
+// syncs & unmaps the file
+I32   gpr_disk_hash_close    (gpr_disk_hash_t *dh);
+I32   gpr_disk_hash_sync     (gpr_disk_hash_t *dh);
+
+I32   _gpr_disk_hash_has     (gpr_disk_hash_t *dh, U64 key);
+void *_gpr_disk_hash_get     (gpr_disk_hash_t *dh, U64 key);
+I32   _gpr_disk_hash_set     (gpr_disk_hash_t *dh, const U32 s, U64 key,
+                              const void *value);
+// returns 0 if key was missing
+I32   _gpr_disk_hash_remove  (gpr_disk_hash_t *dh, U64 key);
+// makes room for capacity values without growing the file
+I32   _gpr_disk_hash_reserve (gpr_disk_hash_t *dh, U32 capacity);
+U32   _gpr_disk_hash_size    (gpr_disk_hash_t *dh);
+
+#define gpr_disk_hash_open(type, dh, path, sync_interval) \
+  _gpr_disk_hash_open(dh, sizeof(type), path, sync_interval)
+#define gpr_disk_hash_has(type, dh, key)        _gpr_disk_hash_has(dh, key)
+#define gpr_disk_hash_get(type, dh, key)        ((type*)_gpr_disk_hash_get(dh, key))
+#define gpr_disk_hash_set(type, dh, key, value) \
+  _gpr_disk_hash_set(dh, sizeof(type), key, (const type*)(value))
+#define gpr_disk_hash_remove(type, dh, key)     _gpr_disk_hash_remove(dh, key)
+#define gpr_disk_hash_reserve(type, dh, c)      _gpr_disk_hash_reserve(dh, c)
+#define gpr_disk_hash_size(type, dh)            _gpr_disk_hash_size(dh)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_DISK_HASH_H
@@ -0,0 +1,89 @@
+#ifndef GPR_EPOCH_H
+#define GPR_EPOCH_H
+
+#include "gpr_types.h"
+#include "gpr_array.h"
+#include "gpr_sync.h"
+
+// -------------------------------------------------------------------------
+// Epoch based memory reclamation
+// -------------------------------------------------------------------------
+// Readers enter a critical section before they load shared pointers and
+// exit it when they are done with them. A writer that unlinks a block
+// retires it instead of deallocating it: the block is given back to its
+// allocator once every thread in a critical section has observed a newer
+// epoch, ie when no reader can still hold a reference to it.
+// Retired blocks are reclaimed by batches of GPR_EPOCH_BATCH.
+//
+// Each thread registers its own gpr_epoch_thread_t. The blocks retired by
+// a thread are deallocated by that same thread, so the allocators passed to
+// gpr_epoch_retire must accept calls from it.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// number of retired blocks that triggers a reclamation
+#define GPR_EPOCH_BATCH 64
+
+// frees a retired block that owns other allocations
+typedef void (*gpr_epoch_free_func_t)(void *p, gpr_allocator_t *a);
+
+typedef struct
+{
+  void                 *p;
+  gpr_allocator_t      *allocator;
+  gpr_epoch_free_func_t func;         // NULL for a plain gpr_deallocate
+} gpr_epoch_retired_t;
+
+typedef gpr_array_t(gpr_epoch_retired_t) gpr_epoch_limbo_t;
+
+typedef struct
+{
+  volatile U32      state;        // observed epoch | active flag
+  U32               nesting;      // critical sections depth
+  gpr_epoch_limbo_t limbo[3];     // retired blocks, one list per epoch
+  U32               limbo_epoch[3];
+  U32               num_retired;
+} gpr_epoch_thread_t;
+
+typedef struct
+{
+  volatile U32      epoch;        // global epoch
+  gpr_mutex_t       lock;         // protects threads & orphans
+  gpr_array_t(gpr_epoch_thread_t*)
+                    threads;      // registered threads
+  gpr_epoch_limbo_t orphans;      // blocks left by unregistered threads
+  U32               orphans_epoch;
+  gpr_allocator_t  *allocator;
+} gpr_epoch_t;
+
+void gpr_epoch_init       (gpr_epoch_t *e, gpr_allocator_t *a);
+// every thread must be unregistered, remaining blocks are deallocated
+void gpr_epoch_destroy    (gpr_epoch_t *e);
+
+// the allocator is used for the retire lists of the thread
+void gpr_epoch_register   (gpr_epoch_t *e, gpr_epoch_thread_t *t, gpr_allocator_t *a);
+void gpr_epoch_unregister (gpr_epoch_t *e, gpr_epoch_thread_t *t);
+
+// critical sections may be nested
+void gpr_epoch_enter      (gpr_epoch_t *e, gpr_epoch_thread_t *t);
+void gpr_epoch_exit       (gpr_epoch_t *e, gpr_epoch_thread_t *t);
+
+// defers gpr_deallocate(a, p) until no reader can reference p anymore
+void gpr_epoch_retire     (gpr_epoch_t *e, gpr_epoch_thread_t *t, void *p,
+                           gpr_allocator_t *a);
+// same, but func(p, a) is called instead of gpr_deallocate(a, p)
+void gpr_epoch_retire_func(gpr_epoch_t *e, gpr_epoch_thread_t *t, void *p,
+                           gpr_allocator_t *a, gpr_epoch_free_func_t func);
+
+// tries to advance the global epoch and deallocates the blocks retired by
+// the thread that became unreachable, returns the number of blocks freed
+U32  gpr_epoch_reclaim    (gpr_epoch_t *e, gpr_epoch_thread_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_EPOCH_H
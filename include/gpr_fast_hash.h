@@ -0,0 +1,50 @@
+#ifndef GPR_FAST_HASH_H
+#define GPR_FAST_HASH_H
+
+#include "gpr_types.h"
+
+// -------------------------------------------------------------------------
+// Fast non-cryptographic hash
+// -------------------------------------------------------------------------
+// Keys up to GPR_FAST_HASH_LONG bytes go through a wyhash style function:
+// a few 64x64->128 bits multiplications, no setup. Longer keys are
+// accumulated over 64 bytes stripes in 8 lanes, xxh3 style, which maps to
+// SSE2, AVX2 or NEON. The vector path is chosen at the first long key
+// from what the CPU supports; every path returns the same digests.
+// Keys are read with unaligned loads, little endian.
+// The digests are stable across platforms but differ from the reference
+// wyhash & xxh3 ones.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPR_FAST_HASH_LONG 1024
+
+// implementations of the long keys path
+#define GPR_FAST_HASH_SCALAR 0
+#define GPR_FAST_HASH_SSE2   1
+#define GPR_FAST_HASH_AVX2   2
+#define GPR_FAST_HASH_NEON   3
+
+typedef struct
+{
+  U64 lo, hi;
+} gpr_hash128_t;
+
+U64           gpr_fast_hash_64  (const void *key, U32 len, U64 seed);
+// the two halves are independent 64 bits hashes: the short keys path
+// costs twice as much as gpr_fast_hash_64
+gpr_hash128_t gpr_fast_hash_128 (const void *key, U32 len, U64 seed);
+
+// returns the implementation in use
+U32           gpr_fast_hash_impl (void);
+// forces an implementation, returns 0 if the CPU does not support it
+I32           gpr_fast_hash_use  (U32 impl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_FAST_HASH_H
@@ -0,0 +1,92 @@
+#ifndef GPR_FIBER_H
+#define GPR_FIBER_H
+
+#include "gpr_types.h"
+#include "gpr_array.h"
+
+// -------------------------------------------------------------------------
+// User-space fibers
+// -------------------------------------------------------------------------
+// A fiber is an execution context with its own stack that is switched to
+// explicitly. Contexts are switched with a few instructions on x86-64
+// (gcc/clang), with native fibers on windows and ucontext elsewhere.
+// A fiber function must never return: it switches to another fiber when
+// its work is done.
+// -------------------------------------------------------------------------
+
+#if defined(_WIN32)
+  #define GPR_FIBER_WIN32
+#elif defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+  #define GPR_FIBER_X64
+#else
+  #define GPR_FIBER_UCONTEXT
+  #include <ucontext.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPR_FIBER_DEFAULT_STACK_SIZE (64*1024)
+
+typedef void (*gpr_fiber_func_t)(void *arg);
+
+typedef struct
+{
+#if defined(GPR_FIBER_WIN32)
+  void       *handle;
+#elif defined(GPR_FIBER_X64)
+  void       *sp;
+#else
+  ucontext_t  context;
+#endif
+  gpr_fiber_func_t func;
+  void            *arg;
+} gpr_fiber_t;
+
+// prepares f to run func(arg) on the given stack at its first switch
+void gpr_fiber_init        (gpr_fiber_t *f, gpr_fiber_func_t func, void *arg,
+                            char *stack, U32 stack_size);
+// makes the calling thread a fiber that can be switched back to
+void gpr_fiber_init_thread (gpr_fiber_t *f);
+void gpr_fiber_destroy     (gpr_fiber_t *f);
+
+// saves the current context in from and resumes to
+void gpr_fiber_switch      (gpr_fiber_t *from, gpr_fiber_t *to);
+
+// ---------------------------------------------------------------
+// Fiber pool: recycles fibers and their stacks
+// ---------------------------------------------------------------
+// A pooled fiber is set up once and runs every function it is acquired
+// for, one after the other on the same stack: native fibers are not
+// recreated either. A function ends by switching away, after which the
+// fiber can be released. The switch returns when the fiber is acquired
+// again and resumed, the function must then return to let the next one
+// run.
+// Each fiber and its stack live in a single allocation, except native
+// fibers whose stack is allocated by the system. The pool grows when it's
+// empty.
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  gpr_allocator_t *allocator;
+  U32              stack_size;
+  gpr_array_t(gpr_fiber_t*)
+                   all;      // every fiber created by the pool
+  gpr_array_t(gpr_fiber_t*)
+                   freelist; // fibers available
+} gpr_fiber_pool_t;
+
+void         gpr_fiber_pool_init    (gpr_fiber_pool_t *p, U32 stack_size,
+                                     U32 count, gpr_allocator_t *a);
+void         gpr_fiber_pool_destroy (gpr_fiber_pool_t *p);
+gpr_fiber_t *gpr_fiber_pool_acquire (gpr_fiber_pool_t *p, gpr_fiber_func_t func,
+                                     void *arg);
+void         gpr_fiber_pool_release (gpr_fiber_pool_t *p, gpr_fiber_t *f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_FIBER_H
@@ -0,0 +1,46 @@
+#ifndef GPR_FILE_H
+#define GPR_FILE_H
+
+#include "gpr_types.h"
+
+// -------------------------------------------------------------------------
+// Memory mapped files
+// -------------------------------------------------------------------------
+// Functions return 0 on failure.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  char *data;
+  U64   size;
+#if defined(_WIN32)
+  void *file, *mapping;
+#else
+  int   fd;
+#endif
+} gpr_file_map_t;
+
+// maps a whole file read-only
+I32  gpr_file_map_read  (gpr_file_map_t *m, const char *path);
+// maps a whole file read-write, the file is created if missing and
+// extended with zeros to at least min_size bytes
+I32  gpr_file_map_write (gpr_file_map_t *m, const char *path, U64 min_size);
+// extends or truncates a file mapped read-write and maps it again: the
+// data pointer changes
+I32  gpr_file_map_resize(gpr_file_map_t *m, U64 size);
+// writes the modified pages of a read-write mapping to the disk
+I32  gpr_file_sync      (gpr_file_map_t *m);
+void gpr_file_unmap     (gpr_file_map_t *m);
+
+// creates or replaces a file with size bytes of data
+I32  gpr_file_write    (const char *path, const void *data, U64 size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_FILE_H
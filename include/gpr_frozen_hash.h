@@ -0,0 +1,82 @@
+#ifndef GPR_FROZEN_HASH_H
+#define GPR_FROZEN_HASH_H
+
+#include "gpr_types.h"
+#include "gpr_hash.h"
+#include "gpr_file.h"
+
+// -------------------------------------------------------------------------
+// Frozen hash
+// -------------------------------------------------------------------------
+// A read-only copy of a gpr_hash_t indexed by a minimal perfect hash
+// (hash & displace): each key has its own position in [0, n), found with
+// two hashes and one displacement lookup, with no probing.
+// Keys are first placed in a slightly larger table so that the last
+// buckets are easy to place, the few positions past n are then remapped to
+// the free ones below n.
+//
+// The table is a single relocatable blob: a header followed by the
+// displacements, the remapped positions, the keys and the values,
+// referenced by offsets. It can be saved as is and mapped back with no
+// parsing.
+// Blobs are only portable between hosts of the same endianness.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPR_FROZEN_HASH_MAGIC 0x48465047u // 'GPFH'
+
+typedef struct
+{
+  U32 magic;
+  U32 num_keys;
+  U32 num_buckets;
+  U32 table_size;   // positions before remapping
+  U32 value_size;
+  U32 pad;
+  U64 seed;
+  U32 pilots_pos;   // offsets from the start of the blob
+  U32 remap_pos;
+  U32 keys_pos;
+  U32 values_pos;
+  U32 size;         // of the whole blob
+} gpr_frozen_hash_header_t;
+
+typedef struct
+{
+  const gpr_frozen_hash_header_t *header;
+  const U32       *pilots;      // displacement of each bucket
+  const U32       *remap;       // final position of positions past num_keys
+  const U64       *keys;        // key at each position
+  const char      *values;      // value at each position
+  U32              num_keys, num_buckets, table_size, value_size;
+  U64              seed;
+  gpr_allocator_t *allocator;   // owner of a built blob
+  gpr_file_map_t   map;         // of a mapped blob
+} gpr_frozen_hash_t;
+
+// builds from the keys & values of a hash with unique keys, returns 0 when 
+// no perfect hash was found
+I32   _gpr_frozen_hash_build (gpr_frozen_hash_t *fh, const U32 s, gpr_hash_t *h,
+                              gpr_allocator_t *a);
+// uses a blob in place, it must outlive fh. returns 0 if it is invalid
+I32   gpr_frozen_hash_load   (gpr_frozen_hash_t *fh, const void *blob, U32 size);
+// maps a saved blob read-only, returns 0 if it can't be read or is invalid
+I32   gpr_frozen_hash_map    (gpr_frozen_hash_t *fh, const char *path);
+I32   gpr_frozen_hash_save   (gpr_frozen_hash_t *fh, const char *path);
+void  gpr_frozen_hash_destroy(gpr_frozen_hash_t *fh);
+
+I32   _gpr_frozen_hash_has   (gpr_frozen_hash_t *fh, U64 key);
+const void *_gpr_frozen_hash_get (gpr_frozen_hash_t *fh, U64 key);
+
+#define gpr_frozen_hash_build(type, fh, h, alct) _gpr_frozen_hash_build(fh, sizeof(type), h, alct)
+#define gpr_frozen_hash_has(type, fh, key)       _gpr_frozen_hash_has(fh, key)
+#define gpr_frozen_hash_get(type, fh, key)       ((const type*)_gpr_frozen_hash_get(fh, key))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_FROZEN_HASH_H
@@ -1,95 +1,212 @@
-#ifndef GPR_HASH_H
-#define GPR_HASH_H
-
-#include "gpr_types.h"
-#include "gpr_array.h"
-#include "gpr_buffer.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-typedef struct
-{
-  U64 key;
-  U32 next;
-  U32 value_pos;
-} gpr_hash_index_t;
-
-typedef struct
-{
-  gpr_array_t(U32) buckets;
-  gpr_array_t(gpr_hash_index_t)  
-                   indices;
-  gpr_array_t(U64) keys;
-  gpr_buffer_t     values;
-  U32              num_values;
-} gpr_hash_t;
-
-// ---------------------------------------------------------------
-// Hash
-// ---------------------------------------------------------------
-
-void  _gpr_hash_init    (gpr_hash_t *h, const U32 s, gpr_allocator_t *a);
-void  _gpr_hash_destroy (gpr_hash_t *h);
-I32   _gpr_hash_has     (gpr_hash_t *h, U64 key);
-void *_gpr_hash_get     (gpr_hash_t *h, U64 key);
-void  _gpr_hash_set     (gpr_hash_t *h, const U32 s, U64 key, const void *value);
-void  _gpr_hash_remove  (gpr_hash_t *h, const U32 s, U64 key);
-void  _gpr_hash_reserve (gpr_hash_t *h, const U32 s, U32 capacity);
-void *_gpr_hash_begin   (gpr_hash_t *h);
-void *_gpr_hash_end     (gpr_hash_t *h, const U32 s);
-
-#define gpr_hash_init(type, h, alct)        _gpr_hash_init(h, sizeof(type), alct)
-#define gpr_hash_destroy(type, h)           _gpr_hash_destroy(h)
-#define gpr_hash_has(type, h, key)          _gpr_hash_has(h, key)
-#define gpr_hash_get(type, h, key)          ((type*)_gpr_hash_get(h, key))
-#define gpr_hash_set(type, h, key, value)   _gpr_hash_set(h, sizeof(type), key, value)
-#define gpr_hash_remove(type, h, key)       _gpr_hash_remove(h, sizeof(type), key)
-#define gpr_hash_reserve(type, h, capacity) _gpr_hash_reserve(h, sizeof(type), capacity)
-#define gpr_hash_begin(type, h)             ((type*)_gpr_hash_begin(h))
-#define gpr_hash_end(type, h)               ((type*)_gpr_hash_end(h, sizeof(type)))
-
-// ---------------------------------------------------------------
-// Multi Hash
-// ---------------------------------------------------------------
-
-typedef struct
-{
-  U64 key;
-  U32 next;
-} gpr_hash_it;
-
-void *_gpr_multi_hash_find_first (gpr_hash_t *h, gpr_hash_it *it, U64 key);
-void *_gpr_multi_hash_find_next  (gpr_hash_t *h, gpr_hash_it *it);
-U32   _gpr_multi_hash_count      (gpr_hash_t *h, U64 key);
-void *_gpr_multi_hash_get        (gpr_hash_t *h, const U32 s, U64 key, gpr_buffer_t *values);
-void  _gpr_multi_hash_insert     (gpr_hash_t *h, const U32 s, U64 key, const void *value);
-void  _gpr_multi_hash_remove     (gpr_hash_t *h, const U32 s, void *e);
-void  _gpr_multi_hash_remove_all (gpr_hash_t *h, const U32 s, U64 key);
-
-#define gpr_multi_hash_init(type, h, alct)          _gpr_hash_init(h, sizeof(type), alct)
-#define gpr_multi_hash_destroy(type, h)             _gpr_hash_destroy(h)
-#define gpr_multi_hash_find_first(type, h, it, key) ((type*)_gpr_multi_hash_find_first(h, it, key))
-#define gpr_multi_hash_find_next(type, h, it)       ((type*)_gpr_multi_hash_find_next(h, it))
-#define gpr_multi_hash_count(type, h, key)          _gpr_multi_hash_count(h, key)
-#define gpr_multi_hash_insert(type, h, key, value)  _gpr_multi_hash_insert(h, sizeof(type), key, value)
-#define gpr_multi_hash_remove(type, h, e)           _gpr_multi_hash_remove(h, sizeof(type), e)
-#define gpr_multi_hash_remove_all(type, h, key)     _gpr_multi_hash_remove_all(h, sizeof(type), key)
-
-#define gpr_multi_hash_get(type, h, key, arr)             \
-do {                                                      \
-  gpr_hash_it it;                                         \
-  type *e = gpr_multi_hash_find_first(type, h, &it, key); \
-  while (e) {                                             \
-    gpr_array_push_back(type, arr, *e);                   \
-    e = gpr_multi_hash_find_next(type, h, &it);           \
-  }                                                       \
-} while(0)
-
-#ifdef __cplusplus
-}
-#endif
-
-#endif // GPR_HASH_H
-
+#ifndef GPR_HASH_H
+#define GPR_HASH_H
+
+#include "gpr_types.h"
+#include "gpr_array.h"
+#include "gpr_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// -------------------------------------------------------------------------
+// Keys & values are stored densely, in insertion order, and are indexed by
+// one of two backends selected at compile time:
+// - by default, buckets of chained indices
+// - with GPR_HASH_SWISS, an open addressing table probed by groups of
+//   control bytes with SSE2/NEON (Swiss table)
+// -------------------------------------------------------------------------
+
+#ifdef GPR_HASH_SWISS
+
+typedef struct
+{
+  U64 key;
+  U32 value_pos;
+} gpr_hash_slot_t;
+
+typedef struct
+{
+  U8              *ctrl;        // capacity + group width control bytes
+  gpr_hash_slot_t *slots;       // key & value position of each slot
+  U32              capacity;    // number of slots, a power of two or 0
+  U32              growth_left; // insertions left before a rehash
+  gpr_allocator_t *allocator;
+  gpr_array_t(U64) keys;
+  gpr_buffer_t     values;
+  U32              num_values;
+  U32              num_rehashes;
+#ifdef GPR_HASH_STATS
+  U64              num_lookups, num_probes;
+#endif
+} gpr_hash_t;
+
+#else
+
+typedef struct
+{
+  U64 key;
+  U32 next;
+  U32 value_pos;
+} gpr_hash_index_t;
+
+// the buckets are doubled past this number of values per bucket
+#ifndef GPR_HASH_MAX_LOAD_FACTOR
+  #define GPR_HASH_MAX_LOAD_FACTOR 0.7f
+#endif
+
+// when the table grows, the old buckets are migrated a few at a time by
+// the following insertions & removals: lookups go to the old buckets
+// until theirs has been migrated. the new buckets are set as they
+// receive their chains.
+// the insertion that grows the table still reallocates the indices, keys
+// and values arrays: one memcpy of (24 + sizeof(type))*n bytes, with no
+// rehashing. gpr_hash_reserve avoids it when the size is known
+#ifndef GPR_HASH_MIGRATE_BUCKETS
+  #define GPR_HASH_MIGRATE_BUCKETS 8
+#endif
+
+typedef struct
+{
+  gpr_array_t(U32) buckets, 
+                   old_buckets; // being migrated to buckets
+  gpr_array_t(gpr_hash_index_t)  
+                   indices;
+  gpr_array_t(U64) keys;
+  gpr_buffer_t     values;
+  U32              num_values;
+  U32              migrate_pos; // next old bucket to migrate
+  U32              num_rehashes;
+#ifdef GPR_HASH_STATS
+  U64              num_lookups, num_probes;
+#endif
+} gpr_hash_t;
+
+#endif
+
+// ---------------------------------------------------------------
+// Hash
+// ---------------------------------------------------------------
+
+// a removal that drops the load factor below this threshold shrinks the
+// table, 0 disables it. it must stay well below the growth threshold so
+// that a table does not shrink and grow back repeatedly
+#ifndef GPR_HASH_SHRINK_LOAD_FACTOR
+  #define GPR_HASH_SHRINK_LOAD_FACTOR 0.0f
+#endif
+
+void  _gpr_hash_init    (gpr_hash_t *h, const U32 s, gpr_allocator_t *a);
+void  _gpr_hash_destroy (gpr_hash_t *h);
+I32   _gpr_hash_has     (gpr_hash_t *h, U64 key);
+void *_gpr_hash_get     (gpr_hash_t *h, U64 key);
+void  _gpr_hash_set     (gpr_hash_t *h, const U32 s, U64 key, const void *value);
+void  _gpr_hash_remove  (gpr_hash_t *h, const U32 s, U64 key);
+void  _gpr_hash_reserve (gpr_hash_t *h, const U32 s, U32 capacity);
+// resizes the table to the smallest one holding its values and trims the
+// memory left by removals
+void  _gpr_hash_shrink_to_fit (gpr_hash_t *h, const U32 s);
+void *_gpr_hash_begin   (gpr_hash_t *h);
+void *_gpr_hash_end     (gpr_hash_t *h, const U32 s);
+
+// fills an empty hash with n keys & values at once, duplicate keys are
+// kept as with gpr_multi_hash_insert
+void  _gpr_hash_build   (gpr_hash_t *h, const U32 s, const U64 *keys, 
+                         const void *values, U32 n);
+
+// batched lookups: the cache misses of the keys of a batch overlap
+// out[i] is the value of keys[i], NULL when missing
+void  _gpr_hash_get_many (gpr_hash_t *h, const U64 *keys, U32 n, void **out);
+void  _gpr_hash_has_many (gpr_hash_t *h, const U64 *keys, U32 n, I32 *out);
+
+#define gpr_hash_init(type, h, alct)        _gpr_hash_init(h, sizeof(type), alct)
+#define gpr_hash_destroy(type, h)           _gpr_hash_destroy(h)
+#define gpr_hash_has(type, h, key)          _gpr_hash_has(h, key)
+#define gpr_hash_get(type, h, key)          ((type*)_gpr_hash_get(h, key))
+#define gpr_hash_set(type, h, key, value)   _gpr_hash_set(h, sizeof(type), key, value)
+#define gpr_hash_remove(type, h, key)       _gpr_hash_remove(h, sizeof(type), key)
+#define gpr_hash_reserve(type, h, capacity) _gpr_hash_reserve(h, sizeof(type), capacity)
+#define gpr_hash_shrink_to_fit(type, h)     _gpr_hash_shrink_to_fit(h, sizeof(type))
+#define gpr_hash_begin(type, h)             ((type*)_gpr_hash_begin(h))
+#define gpr_hash_end(type, h)               ((type*)_gpr_hash_end(h, sizeof(type)))
+#define gpr_hash_build(type, h, keys, values, n) \
+  _gpr_hash_build(h, sizeof(type), keys, (const type*)(values), n)
+#define gpr_hash_get_many(type, h, keys, n, out) \
+  _gpr_hash_get_many(h, keys, n, (void**)(type**)(out))
+#define gpr_hash_has_many(type, h, keys, n, out) _gpr_hash_has_many(h, keys, n, out)
+
+// ---------------------------------------------------------------
+// Statistics
+// ---------------------------------------------------------------
+// The lookup counters are only maintained when GPR_HASH_STATS is 
+// defined: they cost two atomic adds per lookup, so that concurrent
+// readers of a shared table keep exact counts. The table must then be
+// 8 bytes aligned, the default alignment of gpr_allocate is not enough.
+// ---------------------------------------------------------------
+
+#define GPR_HASH_STATS_HISTOGRAM 16
+
+typedef struct
+{
+  U32 num_values;
+  U32 num_buckets;     // chained: buckets, swiss: slots
+  F32 load_factor;     // values per bucket
+  // chained: buckets by chain length, swiss: values by number of groups
+  // probed to reach them. the last entry counts the longer ones
+  U32 histogram[GPR_HASH_STATS_HISTOGRAM];
+  U32 max_probe;       // longest chain or probe sequence
+  U32 bytes_buckets;   // chained: buckets, swiss: control bytes
+  U32 bytes_indices;   // chained: indices, swiss: slots
+  U32 bytes_keys;
+  U32 bytes_values;
+  U32 num_rehashes;
+  U64 num_lookups;     // 0 without GPR_HASH_STATS
+  F32 avg_probes;      // chain links or groups visited per lookup
+} gpr_hash_stats_t;
+
+void gpr_hash_stats (gpr_hash_t *h, gpr_hash_stats_t *stats);
+
+// ---------------------------------------------------------------
+// Multi Hash
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  U64 key;
+  U32 next;
+} gpr_hash_it;
+
+void *_gpr_multi_hash_find_first (gpr_hash_t *h, gpr_hash_it *it, U64 key);
+void *_gpr_multi_hash_find_next  (gpr_hash_t *h, gpr_hash_it *it);
+U32   _gpr_multi_hash_count      (gpr_hash_t *h, U64 key);
+void *_gpr_multi_hash_get        (gpr_hash_t *h, const U32 s, U64 key, gpr_buffer_t *values);
+void  _gpr_multi_hash_insert     (gpr_hash_t *h, const U32 s, U64 key, const void *value);
+void  _gpr_multi_hash_remove     (gpr_hash_t *h, const U32 s, void *e);
+void  _gpr_multi_hash_remove_all (gpr_hash_t *h, const U32 s, U64 key);
+
+#define gpr_multi_hash_init(type, h, alct)          _gpr_hash_init(h, sizeof(type), alct)
+#define gpr_multi_hash_destroy(type, h)             _gpr_hash_destroy(h)
+#define gpr_multi_hash_find_first(type, h, it, key) ((type*)_gpr_multi_hash_find_first(h, it, key))
+#define gpr_multi_hash_find_next(type, h, it)       ((type*)_gpr_multi_hash_find_next(h, it))
+#define gpr_multi_hash_count(type, h, key)          _gpr_multi_hash_count(h, key)
+#define gpr_multi_hash_insert(type, h, key, value)  _gpr_multi_hash_insert(h, sizeof(type), key, value)
+#define gpr_multi_hash_build(type, h, keys, values, n) \
+  _gpr_hash_build(h, sizeof(type), keys, (const type*)(values), n)
+#define gpr_multi_hash_remove(type, h, e)           _gpr_multi_hash_remove(h, sizeof(type), e)
+#define gpr_multi_hash_remove_all(type, h, key)     _gpr_multi_hash_remove_all(h, sizeof(type), key)
+
+#define gpr_multi_hash_get(type, h, key, arr)             \
+do {                                                      \
+  gpr_hash_it it;                                         \
+  type *e = gpr_multi_hash_find_first(type, h, &it, key); \
+  while (e) {                                             \
+    gpr_array_push_back(type, arr, *e);                   \
+    e = gpr_multi_hash_find_next(type, h, &it);           \
+  }                                                       \
+} while(0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_HASH_H
+
@@ -0,0 +1,49 @@
+#ifndef GPR_HASH_SET_H
+#define GPR_HASH_SET_H
+
+#include "gpr_types.h"
+#include "gpr_memory.h"
+
+// -------------------------------------------------------------------------
+// Hash set of U64 keys
+// -------------------------------------------------------------------------
+// A flat open addressing table of keys with linear probing: a lookup is
+// usually a single cache miss. A slot is 8 bytes and the table doubles
+// past 3/4 of them: between growths the load is 3/8 to 3/4, from about
+// 21 down to about 10.7 bytes per key.
+// Key 0 marks the empty slots, it is tracked by a flag.
+// Removals shift the following keys back: there are no tombstones.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  U64             *keys;
+  U32              capacity;  // a power of two or 0
+  U32              size;      // number of keys, including 0
+  I32              has_zero;
+  gpr_allocator_t *allocator;
+} gpr_hash_set_t;
+
+void gpr_hash_set_init    (gpr_hash_set_t *s, gpr_allocator_t *a);
+void gpr_hash_set_destroy (gpr_hash_set_t *s);
+void gpr_hash_set_clear   (gpr_hash_set_t *s);
+// makes room for capacity keys
+void gpr_hash_set_reserve (gpr_hash_set_t *s, U32 capacity);
+
+I32  gpr_hash_set_has     (gpr_hash_set_t *s, U64 key);
+// returns 1 if the key was not in the set
+I32  gpr_hash_set_insert  (gpr_hash_set_t *s, U64 key);
+// returns 1 if the key was in the set
+I32  gpr_hash_set_remove  (gpr_hash_set_t *s, U64 key);
+
+#define gpr_hash_set_size(s) ((s)->size)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_HASH_SET_H
@@ -0,0 +1,85 @@
+#ifndef GPR_JOB_H
+#define GPR_JOB_H
+
+#include "gpr_types.h"
+#include "gpr_array.h"
+#include "gpr_sync.h"
+#include "gpr_fiber.h"
+
+// -------------------------------------------------------------------------
+// Fiber based job system
+// -------------------------------------------------------------------------
+// Jobs run on fibers scheduled by a fixed set of worker threads.
+// A job waiting on a counter is parked and its worker picks up other work
+// meanwhile: it resumes, possibly on another worker, once the counter
+// reached zero.
+//
+//   gpr_job_counter_t c;
+//   gpr_job_run(js, jobs, n, &c);
+//   gpr_job_wait(js, &c); // yields when called from a job
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct gpr_job_system_s gpr_job_system_t;
+
+typedef void (*gpr_job_func_t)(gpr_job_system_t *js, void *arg);
+
+typedef struct
+{
+  gpr_job_func_t func;
+  void          *arg;
+} gpr_job_t;
+
+// number of jobs still running
+typedef struct
+{
+  volatile U32 value;
+} gpr_job_counter_t;
+
+typedef struct
+{
+  gpr_job_t          job;
+  gpr_job_counter_t *counter;
+} gpr_job_entry_t;
+
+typedef struct gpr_job_worker_s gpr_job_worker_t;
+
+struct gpr_job_system_s
+{
+  gpr_allocator_t  *allocator;
+  gpr_mutex_t       lock;     // protects the queue, the parked fibers & the pool
+  gpr_semaphore_t   wakeup;   // idle workers sleep on it
+  volatile U32      stop;
+  gpr_job_entry_t  *queue;    // ring buffer of pending jobs
+  U32               queue_capacity, queue_head, queue_size;
+  gpr_array_t(void*)
+                    parked;   // fibers waiting on a counter
+  gpr_fiber_pool_t  fibers;
+  gpr_job_worker_t *workers;
+  U32               num_workers;
+};
+
+void gpr_job_system_init    (gpr_job_system_t *js, U32 num_workers,
+                             U32 num_fibers, U32 stack_size, gpr_allocator_t *a);
+// pending jobs must be completed
+void gpr_job_system_destroy (gpr_job_system_t *js);
+
+// schedules n jobs, the counter is incremented by n and decremented by one
+// as each job completes. counter may be NULL
+void gpr_job_run  (gpr_job_system_t *js, const gpr_job_t *jobs, U32 n,
+                   gpr_job_counter_t *counter);
+
+// waits until the counter reaches zero
+// from a job the fiber is parked, from another thread it blocks
+void gpr_job_wait (gpr_job_system_t *js, gpr_job_counter_t *counter);
+
+#define gpr_job_counter_init(c) ((c)->value = 0)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_JOB_H
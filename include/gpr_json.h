@@ -1,45 +1,51 @@
-#ifndef GPR_JSON_H
-#define GPR_JSON_H
-
-// -------------------------------------------------------------------------
-// JSON parser / writer
-// -------------------------------------------------------------------------
-
-#include "gpr_memory.h"
-#include "gpr_buffer.h"
-#include "gpr_idlut.h"
-#include "gpr_hash.h"
-#include "gpr_string_pool.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-typedef struct 
-{
-  gpr_idlut_t  nodes;
-  gpr_hash_t   kv_access;
-  gpr_string_pool_t *sp;
-} gpr_json_t;
-
-typedef enum
-{
-  GPR_JSON_FALSE = 0,
-  GPR_JSON_TRUE,
-  GPR_JSON_NULL,
-  GPR_JSON_INTEGER,
-  GPR_JSON_NUMBER,
-  GPR_JSON_STRING,
-  GPR_JSON_OBJECT,
-  GPR_JSON_ARRAY
-} gpr_json_type;
-
-U64  gpr_json_init    (gpr_json_t *jsn, gpr_string_pool_t *sp, gpr_allocator_t *a);
-void gpr_json_reserve (gpr_json_t *jsn, U32 capacity);
-void gpr_json_destroy (gpr_json_t *jsn);
-
-#ifdef __cplusplus
-}
-#endif
-
+#ifndef GPR_JSON_H
+#define GPR_JSON_H
+
+// -------------------------------------------------------------------------
+// JSON parser / writer
+// -------------------------------------------------------------------------
+
+#include "gpr_memory.h"
+#include "gpr_buffer.h"
+#include "gpr_idlut.h"
+#include "gpr_hash.h"
+#include "gpr_string_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct 
+{
+  gpr_idlut_t  nodes;
+  gpr_hash_t   kv_access;
+  gpr_string_pool_t *sp;
+} gpr_json_t;
+
+typedef enum
+{
+  GPR_JSON_FALSE = 0,
+  GPR_JSON_TRUE,
+  GPR_JSON_NULL,
+  GPR_JSON_INTEGER,
+  GPR_JSON_NUMBER,
+  GPR_JSON_STRING,
+  GPR_JSON_OBJECT,
+  GPR_JSON_ARRAY
+} gpr_json_type;
+
+U64  gpr_json_init    (gpr_json_t *jsn, gpr_string_pool_t *sp, gpr_allocator_t *a);
+void gpr_json_reserve (gpr_json_t *jsn, U32 capacity);
+void gpr_json_destroy (gpr_json_t *jsn);
+
+// key of a member name for the *_key functions, which skip the strlen &
+// the hash of the name: gpr_murmur_hash_64(member, strlen(member), 0).
+// gpr_murmur_hash_constexpr.h or the gen_hash_keys tool give it for
+// literal names at compile time.
+U64  gpr_json_key     (const char *member);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // GPR_JSON_H
\ No newline at end of file
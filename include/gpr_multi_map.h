@@ -0,0 +1,61 @@
+#ifndef GPR_MULTI_MAP_H
+#define GPR_MULTI_MAP_H
+
+#include "gpr_types.h"
+#include "gpr_hash.h"
+#include "gpr_buffer.h"
+
+// -------------------------------------------------------------------------
+// Multi map: several values per key, stored contiguously
+// -------------------------------------------------------------------------
+// Unlike the multi hash functions of gpr_hash_t, the values of a key are a
+// single run in the values buffer: they are read with gpr_multi_map_range
+// and no iteration, and removing all of them is O(1).
+// A run that is full is moved to the end of the buffer with twice its
+// capacity, the buffer is compacted when the holes outweigh the values.
+// Any insertion or removal invalidates the pointers to the values and
+// removing a single value changes the order of its run.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  U32 pos;        // first value of the run
+  U32 count;
+  U32 capacity;
+} gpr_multi_map_run_t;
+
+typedef struct
+{
+  gpr_hash_t   runs;        // key -> run
+  gpr_buffer_t values;
+  U32          num_values;
+  U32          num_holes;   // values lost in moved or removed runs
+} gpr_multi_map_t;
+
+void  _gpr_multi_map_init       (gpr_multi_map_t *m, const U32 s, gpr_allocator_t *a);
+void  _gpr_multi_map_destroy    (gpr_multi_map_t *m);
+void  _gpr_multi_map_insert     (gpr_multi_map_t *m, const U32 s, U64 key, const void *value);
+// first value of key and their number, NULL if there are none
+void *_gpr_multi_map_range      (gpr_multi_map_t *m, const U32 s, U64 key, U32 *count);
+U32   _gpr_multi_map_count      (gpr_multi_map_t *m, U64 key);
+// e points to one of the values of key
+void  _gpr_multi_map_remove     (gpr_multi_map_t *m, const U32 s, U64 key, void *e);
+void  _gpr_multi_map_remove_all (gpr_multi_map_t *m, const U32 s, U64 key);
+
+#define gpr_multi_map_init(type, m, alct)             _gpr_multi_map_init(m, sizeof(type), alct)
+#define gpr_multi_map_destroy(type, m)                _gpr_multi_map_destroy(m)
+#define gpr_multi_map_insert(type, m, key, value)     _gpr_multi_map_insert(m, sizeof(type), key, value)
+#define gpr_multi_map_range(type, m, key, count)      ((type*)_gpr_multi_map_range(m, sizeof(type), key, count))
+#define gpr_multi_map_count(type, m, key)             _gpr_multi_map_count(m, key)
+#define gpr_multi_map_remove(type, m, key, e)         _gpr_multi_map_remove(m, sizeof(type), key, e)
+#define gpr_multi_map_remove_all(type, m, key)        _gpr_multi_map_remove_all(m, sizeof(type), key)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_MULTI_MAP_H
@@ -1,16 +1,51 @@
-#ifndef GPR_MURMUR_HASH_H
-#define GPR_MURMUR_HASH_H
-
-#include "gpr_types.h"
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-
-U64 gpr_murmur_hash_64 (const void *key, U32 len, U64 seed);
-
-#ifdef __cplusplus
-}
-#endif
-
+#ifndef GPR_MURMUR_HASH_H
+#define GPR_MURMUR_HASH_H
+
+#include "gpr_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+U64 gpr_murmur_hash_64 (const void *key, U32 len, U64 seed);
+
+// ---------------------------------------------------------------
+// Streaming form: the key is given in pieces, the digest is the one of
+// gpr_murmur_hash_64 over their concatenation.
+// The total length must be known up front: the algorithm mixes it in its
+// initial state.
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  U64 h;
+  U64 tail;      // bytes of the incomplete block
+  U32 tail_size;
+  U32 len_left;  // bytes still expected
+} gpr_murmur_hash_64_state_t;
+
+void gpr_murmur_hash_64_init   (gpr_murmur_hash_64_state_t *st, U32 len, U64 seed);
+void gpr_murmur_hash_64_update (gpr_murmur_hash_64_state_t *st, const void *data,
+                                U32 size);
+U64  gpr_murmur_hash_64_final  (gpr_murmur_hash_64_state_t *st);
+
+// ---------------------------------------------------------------
+// Batch form: out[i] is the digest of keys[i], of lens[i] bytes, all
+// with the same seed.
+// A plain loop of independent calls: their multiplication chains overlap
+// in the pipeline. Lane layouts were measured against it on 1-64 bytes
+// keys, 4 and 8 scalar lanes in lockstep, AVX2 with the 64x64 product
+// built from three vpmuludq, groups sorted by block count: all were 1.3x
+// to 3x slower. SSE2/AVX2 have no 64x64 bits product and the lanes of a
+// group wait for its longest key. A vector form would need a hash built
+// for lanes, whose digests would not be these.
+// ---------------------------------------------------------------
+
+void gpr_hash_batch_64 (const void *const *keys, const U32 *lens, U32 n, U64 seed,
+                        U64 *out);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,64 @@
+#ifndef GPR_MURMUR_HASH_CONSTEXPR_H
+#define GPR_MURMUR_HASH_CONSTEXPR_H
+
+#include "gpr_types.h"
+
+// -------------------------------------------------------------------------
+// Compile time murmur hash (C++11)
+// -------------------------------------------------------------------------
+// gpr_murmur_hash_64_cx gives the digest of gpr_murmur_hash_64 as a
+// constant expression, so that the keys of literal names cost nothing at
+// runtime:
+//
+//   constexpr U64 position = gpr_json_key_cx("position");
+//   gpr_json_get_key(&jsn, obj, position);
+//
+// The bytes are read little endian like gpr_murmur_hash_64 does on every
+// platform. C code gets the same keys from the gen_hash_keys tool.
+// -------------------------------------------------------------------------
+
+#define _GPR_MURMUR_M 0xc6a4a7935bd1e995ull
+#define _GPR_MURMUR_R 47
+
+// n first bytes of s, little endian
+constexpr U64 _gpr_murmur_cx_load(const char *s, U32 n)
+{
+  return n == 0 ? 0 :
+    ((U64)(U8)s[n - 1] << (8*(n - 1))) | _gpr_murmur_cx_load(s, n - 1);
+}
+
+constexpr U64 _gpr_murmur_cx_shift(U64 k)
+{
+  return k ^ (k >> _GPR_MURMUR_R);
+}
+
+constexpr U64 _gpr_murmur_cx_blocks(const char *s, U32 num_blocks, U64 h)
+{
+  return num_blocks == 0 ? h : _gpr_murmur_cx_blocks(s + 8, num_blocks - 1,
+    (h ^ _gpr_murmur_cx_shift(_gpr_murmur_cx_load(s, 8)*_GPR_MURMUR_M)*_GPR_MURMUR_M)
+    *_GPR_MURMUR_M);
+}
+
+constexpr U64 _gpr_murmur_cx_tail(const char *s, U32 n, U64 h)
+{
+  return n == 0 ? h : (h ^ _gpr_murmur_cx_load(s, n))*_GPR_MURMUR_M;
+}
+
+constexpr U64 gpr_murmur_hash_64_cx(const char *key, U32 len, U64 seed)
+{
+  return _gpr_murmur_cx_shift(_gpr_murmur_cx_shift(
+    _gpr_murmur_cx_tail(key + (len/8)*8, len & 7,
+      _gpr_murmur_cx_blocks(key, len/8, seed ^ (len*_GPR_MURMUR_M))))*_GPR_MURMUR_M);
+}
+
+// gpr_json_key of a string literal
+template <U32 N>
+constexpr U64 gpr_json_key_cx(const char (&member)[N])
+{
+  return gpr_murmur_hash_64_cx(member, N - 1, 0);
+}
+
+#undef _GPR_MURMUR_M
+#undef _GPR_MURMUR_R
+
+#endif // GPR_MURMUR_HASH_CONSTEXPR_H
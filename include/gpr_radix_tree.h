@@ -0,0 +1,80 @@
+#ifndef GPR_RADIX_TREE_H
+#define GPR_RADIX_TREE_H
+
+#include "gpr_types.h"
+#include "gpr_memory.h"
+
+// -------------------------------------------------------------------------
+// Radix tree
+// -------------------------------------------------------------------------
+// An adaptive radix tree (ART) of values keyed by byte strings: unlike a
+// hash, its keys are ordered (memcmp order, a key before its extensions)
+// and it answers prefix queries.
+//
+// Each inner node branches on one byte of the keys. It has one of four
+// layouts, picked by its number of children and changed as they are
+// added or removed:
+// - 4 children: sorted keys, searched linearly
+// - 16 children: sorted keys, searched in one compare with SSE2/NEON
+// - 48 children: a 256 bytes index of the child slots
+// - 256 children: a child per byte
+// The bytes shared by all the keys below a node are skipped in one step:
+// the node keeps their count and the first GPR_RADIX_TREE_PREFIX ones, the
+// full key of the leaves is compared at the end. A key that ends on a node
+// is stored in the node itself.
+//
+// Leaves hold a copy of their key and of their value, the value pointers
+// are stable until their key is removed.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GPR_RADIX_TREE_PREFIX 8
+
+typedef struct
+{
+  void            *root;        // a node or a leaf, NULL if empty
+  U32              num_values;
+  gpr_allocator_t *allocator;
+} gpr_radix_tree_t;
+
+// called in key order, returns 0 to stop the visit
+typedef I32 (*gpr_radix_tree_visit_t)(const U8 *key, U32 len, void *value, void *arg);
+
+void  _gpr_radix_tree_init   (gpr_radix_tree_t *t, gpr_allocator_t *a);
+void  _gpr_radix_tree_destroy(gpr_radix_tree_t *t);
+I32   _gpr_radix_tree_has    (gpr_radix_tree_t *t, const void *key, U32 len);
+void *_gpr_radix_tree_get    (gpr_radix_tree_t *t, const void *key, U32 len);
+void  _gpr_radix_tree_set    (gpr_radix_tree_t *t, const U32 s, const void *key, U32 len,
+                              const void *value);
+I32   _gpr_radix_tree_remove (gpr_radix_tree_t *t, const void *key, U32 len);
+U32   _gpr_radix_tree_size   (gpr_radix_tree_t *t);
+
+// value of the longest key that is a prefix of key, NULL if none. its
+// length is written to prefix_len
+void *_gpr_radix_tree_longest_prefix(gpr_radix_tree_t *t, const void *key, U32 len,
+                                     U32 *prefix_len);
+// visits the values of the keys starting with prefix in key order,
+// returns the number of values visited
+U32   _gpr_radix_tree_visit_prefix  (gpr_radix_tree_t *t, const void *prefix, U32 len,
+                                     gpr_radix_tree_visit_t visit, void *arg);
+
+#define gpr_radix_tree_init(type, t, alct)              _gpr_radix_tree_init(t, alct)
+#define gpr_radix_tree_destroy(type, t)                 _gpr_radix_tree_destroy(t)
+#define gpr_radix_tree_has(type, t, key, len)           _gpr_radix_tree_has(t, key, len)
+#define gpr_radix_tree_get(type, t, key, len)           ((type*)_gpr_radix_tree_get(t, key, len))
+#define gpr_radix_tree_set(type, t, key, len, value)    _gpr_radix_tree_set(t, sizeof(type), key, len, value)
+#define gpr_radix_tree_remove(type, t, key, len)        _gpr_radix_tree_remove(t, key, len)
+#define gpr_radix_tree_size(type, t)                    _gpr_radix_tree_size(t)
+#define gpr_radix_tree_longest_prefix(type, t, key, len, prefix_len) \
+  ((type*)_gpr_radix_tree_longest_prefix(t, key, len, prefix_len))
+#define gpr_radix_tree_visit_prefix(type, t, prefix, len, visit, arg) \
+  _gpr_radix_tree_visit_prefix(t, prefix, len, visit, arg)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_RADIX_TREE_H
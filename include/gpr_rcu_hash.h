@@ -0,0 +1,99 @@
+#ifndef GPR_RCU_HASH_H
+#define GPR_RCU_HASH_H
+
+#include "gpr_types.h"
+#include "gpr_hash.h"
+#include "gpr_sync.h"
+#include "gpr_epoch.h"
+
+// -------------------------------------------------------------------------
+// Read-copy-update hash
+// -------------------------------------------------------------------------
+// Readers look up an immutable version of the table without any lock or
+// atomic read-modify-write: entering the epoch critical section is their
+// only cost. A writer works on a private copy of the current version and
+// publishes it with a single pointer store, the previous version is
+// retired to the epoch and destroyed once no reader can still see it.
+//
+// Every update copies the whole table: it suits tables read all the time
+// and updated rarely. Group the changes of an update between
+// gpr_rcu_hash_write_begin/end to pay for a single copy.
+//
+//   gpr_hash_t *h = gpr_rcu_hash_enter(rh, t);
+//   v = gpr_hash_get(type, h, key);  // valid until gpr_rcu_hash_exit
+//   gpr_rcu_hash_exit(rh, t);
+//
+// The threads pass their own gpr_epoch_thread_t, registered to the epoch
+// given at init. The allocator is called from every writer: it must be
+// thread-safe if several threads write.
+// A snapshot must not be modified. With GPR_HASH_STATS, its lookup
+// counters are added to atomically by the readers.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+  gpr_hash_t *volatile root;      // published version
+  gpr_hash_t      *next;          // version being written
+  gpr_mutex_t      lock;          // serializes the writers
+  gpr_epoch_t     *epoch;
+  gpr_allocator_t *allocator;
+  U32              value_size;
+} gpr_rcu_hash_t;
+
+void        _gpr_rcu_hash_init    (gpr_rcu_hash_t *rh, const U32 s,
+                                   gpr_epoch_t *e, gpr_allocator_t *a);
+// no reader or writer must be left, versions already retired are
+// destroyed by the epoch
+void        gpr_rcu_hash_destroy  (gpr_rcu_hash_t *rh);
+
+// ---------------------------------------------------------------
+// Readers
+// ---------------------------------------------------------------
+
+// returns the current version, valid until gpr_rcu_hash_exit
+// may be nested with other critical sections of the epoch
+gpr_hash_t *gpr_rcu_hash_enter    (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t);
+void        gpr_rcu_hash_exit     (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t);
+
+I32         gpr_rcu_hash_has      (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t,
+                                   U64 key);
+// copies the value of key, returns 0 if missing
+I32         _gpr_rcu_hash_get     (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t,
+                                   const U32 s, U64 key, void *value);
+
+// ---------------------------------------------------------------
+// Writers
+// ---------------------------------------------------------------
+
+// locks out the other writers and returns a private copy of the current
+// version to modify with the gpr_hash functions
+gpr_hash_t *gpr_rcu_hash_write_begin  (gpr_rcu_hash_t *rh);
+// publishes the copy, the previous version is retired by thread t
+void        gpr_rcu_hash_write_end    (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t);
+// drops the copy
+void        gpr_rcu_hash_write_cancel (gpr_rcu_hash_t *rh);
+
+// single updates, each one publishes a new version
+void        _gpr_rcu_hash_set     (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t,
+                                   const U32 s, U64 key, const void *value);
+// returns 0 if key was missing, no version is published then
+I32         _gpr_rcu_hash_remove  (gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t,
+                                   const U32 s, U64 key);
+
+#define gpr_rcu_hash_init(type, rh, e, alct) _gpr_rcu_hash_init(rh, sizeof(type), e, alct)
+#define gpr_rcu_hash_get(type, rh, t, key, value) \
+  _gpr_rcu_hash_get(rh, t, sizeof(type), key, value)
+#define gpr_rcu_hash_set(type, rh, t, key, value) \
+  _gpr_rcu_hash_set(rh, t, sizeof(type), key, value)
+#define gpr_rcu_hash_remove(type, rh, t, key) \
+  _gpr_rcu_hash_remove(rh, t, sizeof(type), key)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_RCU_HASH_H
@@ -1,83 +1,175 @@
-#ifndef GPR_STRING_POOL_H
-#define GPR_STRING_POOL_H
-
-#include <string.h>
-#include "gpr_hash.h"
-#include "gpr_murmur_hash.h"
-
-typedef struct
-{
-  char *string;
-  I32   refs;
-} gpr_string_entry_t;
-
-typedef struct
-{
-  gpr_hash_t       string_map;
-  gpr_allocator_t *string_allocator;
-} gpr_string_pool_t;
-
-static void  gpr_string_pool_init(gpr_string_pool_t *pool, gpr_allocator_t *map_allocator, 
-                                  gpr_allocator_t *string_allocator)
-{
-  gpr_hash_init(gpr_string_entry_t, &pool->string_map, map_allocator);
-  pool->string_allocator = string_allocator;
-}
-
-static void  gpr_string_pool_destroy(gpr_string_pool_t *pool)
-{
-  gpr_string_entry_t *e   = gpr_hash_begin(gpr_string_entry_t, &pool->string_map);
-  gpr_string_entry_t *end = gpr_hash_end  (gpr_string_entry_t, &pool->string_map);
-
-  while(e < end) 
-  {
-    gpr_deallocate(pool->string_allocator, e->string);
-    ++e;
-  }
-  gpr_hash_destroy(gpr_string_entry_t, &pool->string_map);
-}
-
-static char *gpr_string_pool_nget(gpr_string_pool_t *pool, const char *string, U32 size)
-{
-  U64 key = gpr_murmur_hash_64(string, size, 0);
-  gpr_string_entry_t *e = gpr_hash_get(gpr_string_entry_t, &pool->string_map, key);
-
-  if(e) 
-  {
-    ++e->refs;
-    return e->string;
-  }{
-    gpr_string_entry_t ne;
-    ne.refs = 1;
-    ne.string = gpr_strdup(pool->string_allocator, string);
-    gpr_hash_set(gpr_string_entry_t, &pool->string_map, key, &ne);
-    return ne.string;
-  }
-}
-
-static char *gpr_string_pool_get(gpr_string_pool_t *pool, const char *string)
-{
-  return gpr_string_pool_nget(pool, string, strlen(string));
-}
-
-static I32 gpr_string_pool_has(gpr_string_pool_t *pool, const char *string)
-{
-  return gpr_hash_has(gpr_string_entry_t, &pool->string_map, 
-    gpr_murmur_hash_64(string, strlen(string), 0));
-}
-
-static void gpr_string_pool_release(gpr_string_pool_t *pool, char *string)
-{
-  U64 key = gpr_murmur_hash_64(string, strlen(string), 0);
-  gpr_string_entry_t *e = gpr_hash_get(gpr_string_entry_t, &pool->string_map, key);
-
-  if(!e) return;
-  if(e->refs == 1) 
-  {
-    gpr_deallocate(pool->string_allocator, e->string);
-    gpr_hash_remove(gpr_string_entry_t, &pool->string_map, key);
-  }
-  --e->refs;
-}
-
-#endif // GPR_STRING_POOL_H
\ No newline at end of file
+#ifndef GPR_STRING_POOL_H
+#define GPR_STRING_POOL_H
+
+#include <string.h>
+#include "gpr_hash.h"
+#include "gpr_array.h"
+#include "gpr_murmur_hash.h"
+#include "gpr_sync.h"
+#include "gpr_file.h"
+
+// -------------------------------------------------------------------------
+// String pool
+// -------------------------------------------------------------------------
+// Interns strings: a string is stored once, with its length, its hash
+// (gpr_murmur_hash_64, seed 0) and a reference count, and is named by a
+// U32 id. Equal strings have equal ids, the comparison is an id compare.
+// A pooled string is null terminated and its address is stable until its
+// last release.
+//
+// The strings are carved from chunks of the string allocator. A released
+// string slot goes to a free list of its size class and is reused by the
+// next string of the class. Strings longer than the largest class get
+// their own allocation.
+//
+// The pooled char* and the id are interchangeable: the header lies right
+// before the chars, releasing either costs no hashing.
+//
+// A concurrent pool is shared by threads. Its strings are spread by hash
+// over shards, each one with its own map, chunks, ids and reader-writer
+// lock. The lookup of an interned string only takes the read lock, the
+// reference counts are atomic and a release only locks to drop the last
+// reference. The id -> string table is paged and its pages never move:
+// reading a string, its size or its hash takes no lock. Its directory is
+// doubled by copy as the shard grows, the replaced ones are kept until
+// destroy for the readers still using them. Both allocators are called
+// from every thread: they must be thread-safe.
+//
+// A pool can be saved as a snapshot: a single relocatable blob holding the
+// strings, their headers and an open addressing index by hash, referenced
+// by offsets. A snapshot is mapped read-only into an empty pool with no
+// parsing and its pages are shared by the processes mapping it. Its
+// strings have ids of their own, flagged by GPR_STRING_POOL_MAPPED, are
+// looked up with no lock before the shards and live as long as the pool:
+// acquiring or releasing them does nothing. The strings interned
+// afterwards go to the shards, the overlay.
+// Snapshots are only portable between hosts of the same endianness.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef U32 gpr_string_t;
+
+#define GPR_STRING_NULL 0
+
+#define GPR_STRING_POOL_CHUNK      (64*1024)
+#define GPR_STRING_POOL_CLASSES    32   // slots of 8 to 256 bytes
+#define GPR_STRING_POOL_PAGE       4096 // ids per page of the id table
+#define GPR_STRING_POOL_PAGES      4    // pages of the first directory
+#define GPR_STRING_POOL_MAX_SHARDS 1024
+// high bit of the ids of a snapshot, the low bits are its string index.
+// the other ids are a shard index in their low bits, the bits left below
+// this one are the local id: 2^31 strings in a pool of one shard, 2^21
+// per shard with 1024 shards
+#define GPR_STRING_POOL_MAPPED     0x80000000u
+
+typedef struct
+{
+  U64          hash;
+  U32          size;  // chars, terminator excluded
+  volatile U32 refs;
+  gpr_string_t id;
+  U32          units; // 8 bytes units of the slot, 0 if allocated alone
+  // chars follow
+} gpr_string_header_t;
+
+// shards are padded to this size to avoid false sharing
+#define GPR_STRING_POOL_ALIGN 64
+
+typedef struct
+{
+  gpr_rwlock_t           lock;       // concurrent pools only
+  gpr_hash_t             string_map; // hash -> ids, told apart by string
+  U32                    num_ids;    // local ids handed out, 0 included
+  gpr_array_t(U32)       free_ids;   // local ids
+  gpr_array_t(char*)     chunks;
+  char                  *chunk_pos, *chunk_end;
+  gpr_string_header_t   *free_slots[GPR_STRING_POOL_CLASSES];
+  gpr_string_header_t ***pages;      // directory of the id table
+  U32                    num_pages;  // capacity of the directory
+  gpr_array_t(void*)     old_pages;  // replaced directories
+} gpr_string_pool_shard_t;
+
+#define GPR_STRING_POOL_MAGIC 0x50535047u // 'GPSP'
+
+typedef struct
+{
+  U32 magic;
+  U32 num_strings;
+  U32 num_buckets;  // a power of two, at least twice num_strings
+  U32 offsets_pos;  // offsets from the start of the blob
+  U32 buckets_pos;
+  U32 strings_pos;
+  U32 size;         // of the whole blob
+  U32 pad;
+} gpr_string_pool_snapshot_t;
+
+typedef struct
+{
+  char            *shards;
+  U32              shard_stride;
+  U32              shard_bits;  // the low bits of an id are its shard
+  I32              concurrent;
+  gpr_allocator_t *map_allocator;
+  gpr_allocator_t *string_allocator;
+  const gpr_string_pool_snapshot_t *snapshot; // NULL if none is mapped
+  const U32       *offsets;     // of the header of each snapshot string
+  const U32       *buckets;     // snapshot string index + 1, 0 if empty
+  gpr_file_map_t   snapshot_map;
+} gpr_string_pool_t;
+
+void gpr_string_pool_init    (gpr_string_pool_t *pool, gpr_allocator_t *map_allocator,
+                              gpr_allocator_t *string_allocator);
+// num_shards is rounded up to a power of two
+void gpr_string_pool_init_concurrent (gpr_string_pool_t *pool, U32 num_shards,
+                              gpr_allocator_t *map_allocator,
+                              gpr_allocator_t *string_allocator);
+void gpr_string_pool_destroy (gpr_string_pool_t *pool);
+
+// writes the snapshot and the overlay strings to a new snapshot, those of
+// the snapshot keep their ids. the shards are read locked meanwhile
+I32  gpr_string_pool_save    (gpr_string_pool_t *pool, const char *path);
+// maps a snapshot into an initialized pool with no string, returns 0 if it
+// can't be read or is invalid
+I32  gpr_string_pool_map     (gpr_string_pool_t *pool, const char *path);
+
+// ids, a reference is taken by nget_id/get_id and acquire
+// only the size first bytes of string are read: substrings are interned
+// without copy when they are already pooled. GPR_STRING_NULL (NULL for
+// nget/get) if the shard of the string has no id left
+gpr_string_t gpr_string_pool_nget_id  (gpr_string_pool_t *pool, const char *string,
+                                       U32 size);
+gpr_string_t gpr_string_pool_get_id   (gpr_string_pool_t *pool, const char *string);
+// nget_id of n strings, the hashes of a group computed by gpr_hash_batch_64
+void         gpr_string_pool_nget_ids (gpr_string_pool_t *pool, const char *const *strings,
+                                       const U32 *sizes, U32 n, gpr_string_t *ids);
+// GPR_STRING_NULL if the string is not pooled, no reference taken: in a
+// concurrent pool the id may be released meanwhile by another thread
+gpr_string_t gpr_string_pool_find_id  (gpr_string_pool_t *pool, const char *string,
+                                       U32 size);
+// the caller must already hold a reference
+void         gpr_string_pool_acquire  (gpr_string_pool_t *pool, gpr_string_t id);
+void         gpr_string_pool_release_id(gpr_string_pool_t *pool, gpr_string_t id);
+
+const char  *gpr_string_pool_string   (gpr_string_pool_t *pool, gpr_string_t id);
+U32          gpr_string_pool_size     (gpr_string_pool_t *pool, gpr_string_t id);
+U64          gpr_string_pool_hash     (gpr_string_pool_t *pool, gpr_string_t id);
+// id of a pooled string
+gpr_string_t gpr_string_pool_id       (const char *pooled);
+
+// pooled char*, released with gpr_string_pool_release
+char *gpr_string_pool_nget    (gpr_string_pool_t *pool, const char *string, U32 size);
+char *gpr_string_pool_get     (gpr_string_pool_t *pool, const char *string);
+I32   gpr_string_pool_has     (gpr_string_pool_t *pool, const char *string);
+// string may be any string equal to a pooled one, it is hashed to find it
+void  gpr_string_pool_release (gpr_string_pool_t *pool, char *string);
+// O(1), no hashing: pooled must be the pointer returned by the pool
+void  gpr_string_pool_release_pooled (gpr_string_pool_t *pool, const char *pooled);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_STRING_POOL_H
@@ -0,0 +1,127 @@
+#ifndef GPR_SYNC_H
+#define GPR_SYNC_H
+
+#include "gpr_types.h"
+
+// -------------------------------------------------------------------------
+// Lightweight synchronization primitives
+// -------------------------------------------------------------------------
+// Every primitive is a few bytes wide and needs no destruction, so it can
+// be embedded per bucket or per shard.
+// Blocking is done with a futex on linux, WaitOnAddress on windows and a
+// yield loop elsewhere.
+// -------------------------------------------------------------------------
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// number of busy-wait iterations before a thread goes to sleep
+#define GPR_SYNC_SPIN_COUNT 128
+
+// ---------------------------------------------------------------
+// Spinlock: never sleeps, for very short critical sections
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  volatile U32 locked;
+} gpr_spinlock_t;
+
+void gpr_spinlock_init    (gpr_spinlock_t *l);
+void gpr_spinlock_lock    (gpr_spinlock_t *l);
+I32  gpr_spinlock_trylock (gpr_spinlock_t *l);
+void gpr_spinlock_unlock  (gpr_spinlock_t *l);
+
+// ---------------------------------------------------------------
+// Mutex: spins adaptively, then sleeps on the futex
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  volatile U32 state; // 0: unlocked, 1: locked, 2: locked with sleepers
+} gpr_mutex_t;
+
+void gpr_mutex_init    (gpr_mutex_t *m);
+void gpr_mutex_lock    (gpr_mutex_t *m);
+I32  gpr_mutex_trylock (gpr_mutex_t *m);
+void gpr_mutex_unlock  (gpr_mutex_t *m);
+
+// ---------------------------------------------------------------
+// Counting semaphore
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  volatile U32 count;
+  volatile U32 waiters;
+} gpr_semaphore_t;
+
+void gpr_semaphore_init    (gpr_semaphore_t *s, U32 count);
+void gpr_semaphore_wait    (gpr_semaphore_t *s);
+I32  gpr_semaphore_trywait (gpr_semaphore_t *s);
+void gpr_semaphore_post    (gpr_semaphore_t *s, U32 count);
+
+// ---------------------------------------------------------------
+// Auto-reset event: a set wakes up a single waiter and is consumed
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  volatile U32 signaled;
+  volatile U32 waiters;
+} gpr_event_t;
+
+void gpr_event_init (gpr_event_t *e);
+void gpr_event_set  (gpr_event_t *e);
+void gpr_event_wait (gpr_event_t *e);
+
+// ---------------------------------------------------------------
+// Reader-writer lock: shared readers, exclusive writer
+// ---------------------------------------------------------------
+// A waiting writer blocks new readers so writers can't starve.
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  volatile U32 state;   // reader count | writer bits
+  volatile U32 waiters; // number of sleeping threads
+} gpr_rwlock_t;
+
+void gpr_rwlock_init         (gpr_rwlock_t *l);
+void gpr_rwlock_read_lock    (gpr_rwlock_t *l);
+I32  gpr_rwlock_read_trylock (gpr_rwlock_t *l);
+void gpr_rwlock_read_unlock  (gpr_rwlock_t *l);
+void gpr_rwlock_write_lock   (gpr_rwlock_t *l);
+void gpr_rwlock_write_unlock (gpr_rwlock_t *l);
+
+// ---------------------------------------------------------------
+// Sequence lock: readers never write shared memory
+// ---------------------------------------------------------------
+// Readers copy the protected data out and retry if a writer ran
+// meanwhile, so the data must not contain pointers that a writer
+// may free:
+//
+//   do {
+//     seq = gpr_seqlock_read_begin(&l);
+//     copy = shared;
+//   } while (gpr_seqlock_read_retry(&l, seq));
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  volatile U32   seq;  // odd while a write is in progress
+  gpr_spinlock_t lock; // serializes writers
+} gpr_seqlock_t;
+
+void gpr_seqlock_init         (gpr_seqlock_t *l);
+void gpr_seqlock_write_lock   (gpr_seqlock_t *l);
+void gpr_seqlock_write_unlock (gpr_seqlock_t *l);
+U32  gpr_seqlock_read_begin   (gpr_seqlock_t *l);
+I32  gpr_seqlock_read_retry   (gpr_seqlock_t *l, U32 seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GPR_SYNC_H
@@ -0,0 +1,123 @@
+// ---------------------------------------------------------------
+// Hash table benchmark
+// ---------------------------------------------------------------
+// Measures inserts, bulk builds, successful (one by one and batched) and
+// failed lookups on random U64 keys, one row per measure.
+// src/bench_hash.sh builds it with both backends and prints their results
+// side by side, a single backend is built with:
+//
+//   cc -O2 -Iinclude src/bench_hash.c src/gpr_hash.c src/gpr_hash_swiss.c
+//      src/gpr_buffer.c src/gpr_memory.c [-DGPR_HASH_SWISS]
+// ---------------------------------------------------------------
+
+#include <stdio.h>
+#include <time.h>
+
+#include "gpr_memory.h"
+#include "gpr_hash.h"
+
+#ifdef GPR_HASH_SWISS
+  #define BACKEND "swiss"
+#else
+  #define BACKEND "chained"
+#endif
+
+#define MAX_KEYS (1024*1024)
+
+#define BATCH 256
+
+static U64   keys[MAX_KEYS], misses[MAX_KEYS];
+static U64  *found[BATCH];
+
+// keeps the lookups from being optimized away
+static volatile U64 sink;
+
+static U64 xorshift(U64 *s)
+{
+  *s ^= *s << 13;
+  *s ^= *s >> 7;
+  *s ^= *s << 17;
+  return *s;
+}
+
+static F64 ns_per_op(clock_t start, U32 num_ops)
+{
+  return (F64)(clock() - start)*1e9/CLOCKS_PER_SEC/num_ops;
+}
+
+static void print_row(U32 num_keys, const char *op, F64 ns)
+{
+  printf("%-8s %8u %-12s %8.1f\n", BACKEND, num_keys, op, ns);
+}
+
+static void bench(U32 num_keys, U32 rounds)
+{
+  gpr_hash_t h;
+  clock_t    start;
+  F64        insert_ns = 0, build_ns = 0, hit_ns = 0, batch_ns = 0, miss_ns = 0;
+  U64        sum = 0;
+  U32        i, j, r;
+
+  for (r = 0; r < rounds; ++r)
+  {
+    gpr_hash_init(U64, &h, gpr_default_allocator);
+
+    start = clock();
+    for (i = 0; i < num_keys; ++i) gpr_hash_set(U64, &h, keys[i], &keys[i]);
+    insert_ns += ns_per_op(start, num_keys);
+
+    start = clock();
+    for (i = 0; i < num_keys; ++i) sum += *gpr_hash_get(U64, &h, keys[i]);
+    hit_ns += ns_per_op(start, num_keys);
+
+    start = clock();
+    for (i = 0; i < num_keys; i += BATCH)
+    {
+      gpr_hash_get_many(U64, &h, keys + i, BATCH, found);
+      for (j = 0; j < BATCH; ++j) sum += *found[j];
+    }
+    batch_ns += ns_per_op(start, num_keys);
+
+    start = clock();
+    for (i = 0; i < num_keys; ++i) sum += gpr_hash_has(U64, &h, misses[i]);
+    miss_ns += ns_per_op(start, num_keys);
+
+    gpr_hash_destroy(U64, &h);
+
+    gpr_hash_init(U64, &h, gpr_default_allocator);
+    start = clock();
+    gpr_hash_build(U64, &h, keys, keys, num_keys);
+    build_ns += ns_per_op(start, num_keys);
+    gpr_hash_destroy(U64, &h);
+  }
+
+  print_row(num_keys, "insert",      insert_ns/rounds);
+  print_row(num_keys, "build",       build_ns/rounds);
+  print_row(num_keys, "hit",         hit_ns/rounds);
+  print_row(num_keys, "batched_hit", batch_ns/rounds);
+  print_row(num_keys, "miss",        miss_ns/rounds);
+  sink = sum;
+}
+
+int main(int argc, char **argv)
+{
+  U64 s = 0x9e3779b97f4a7c15ull;
+  U32 i;
+
+  gpr_memory_init(0);
+  printf("%-8s %8s %-12s %8s\n", "backend", "keys", "operation", "ns/op");
+
+  // odd keys are inserted, even keys are looked up and missed
+  for (i = 0; i < MAX_KEYS; ++i)
+  {
+    keys[i]   = xorshift(&s) | 1;
+    misses[i] = xorshift(&s) & ~1ull;
+  }
+
+  bench(1024,     256);
+  bench(64*1024,  16);
+  bench(MAX_KEYS, 2);
+
+  gpr_memory_shutdown();
+  return 0;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# ---------------------------------------------------------------
+# Hash table benchmark driver
+# ---------------------------------------------------------------
+# Builds src/bench_hash.c with the chained and the swiss backends, runs
+# both and prints their time per operation side by side. The arguments
+# are passed to the compiler, CC selects it:
+#
+#   sh src/bench_hash.sh [-march=native ...]
+# ---------------------------------------------------------------
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+CC=${CC:-cc}
+OUT=$(mktemp -d)
+trap 'rm -rf "$OUT"' EXIT
+
+SRCS="$ROOT/src/bench_hash.c $ROOT/src/gpr_hash.c $ROOT/src/gpr_hash_swiss.c
+      $ROOT/src/gpr_buffer.c $ROOT/src/gpr_memory.c"
+
+$CC -O2 "$@" -I"$ROOT/include" $SRCS -o "$OUT/chained"
+$CC -O2 "$@" -DGPR_HASH_SWISS -I"$ROOT/include" $SRCS -o "$OUT/swiss"
+
+"$OUT/chained" > "$OUT/chained.txt"
+"$OUT/swiss"   > "$OUT/swiss.txt"
+
+# rows: backend keys operation ns/op, the header row is skipped
+printf "%8s %-12s %12s %12s %8s\n" keys operation "chained ns" "swiss ns" speedup
+paste "$OUT/chained.txt" "$OUT/swiss.txt" | awk 'NR > 1 {
+  printf "%8s %-12s %12.1f %12.1f %7.2fx\n", $2, $3, $4, $8, ($8 > 0 ? $4/$8 : 0) }'
@@ -0,0 +1,80 @@
+// ---------------------------------------------------------------
+// Hash function benchmark
+// ---------------------------------------------------------------
+// Measures the time per hash and the throughput of the hash functions
+// over keys of growing lengths, every long keys implementation of
+// gpr_fast_hash supported by the CPU included.
+//
+//   cc -O2 -Iinclude src/bench_hash_func.c src/gpr_fast_hash.c
+//      src/gpr_murmur_hash.c
+// ---------------------------------------------------------------
+
+#include <stdio.h>
+#include <time.h>
+
+#include "gpr_murmur_hash.h"
+#include "gpr_fast_hash.h"
+
+#define DATA_SIZE  (1024*1024)
+#define TOTAL_SIZE (256u*1024*1024) // bytes hashed per measure
+
+static U8 data[DATA_SIZE + 64];
+
+static const char *impl_names[] = { "scalar", "sse2", "avx2", "neon" };
+
+typedef U64 (*hash_func_t)(const void *key, U32 len, U64 seed);
+
+static U64 fast_hash_128(const void *key, U32 len, U64 seed)
+{
+  const gpr_hash128_t h = gpr_fast_hash_128(key, len, seed);
+  return h.lo ^ h.hi;
+}
+
+// the keys slide over the data, the previous digest is the next seed so
+// that the calls can't overlap
+static void bench(const char *name, hash_func_t func, U32 len)
+{
+  const U32 n = TOTAL_SIZE/(len + 16) + 1;
+  U64       h = 0;
+  U32       i, pos = 1;
+  clock_t   start = clock();
+  F64       s;
+
+  for (i = 0; i < n; ++i)
+  {
+    h = func(data + pos, len, h);
+    pos += 61;
+    if (pos + len > DATA_SIZE) pos = (pos & 63) + 1;
+  }
+  s = (F64)(clock() - start)/CLOCKS_PER_SEC;
+  printf("%-16s %8u %10.2f %10.2f   (%llx)\n", name, len, s*1e9/n,
+    (F64)n*len/s/1e9, (unsigned long long)(h & 0xff));
+}
+
+int main()
+{
+  static const U32 lengths[] = { 4, 8, 16, 32, 64, 128, 256, 1024, 2048, 4096, 65536 };
+  char  name[32];
+  U32   i, impl;
+  const U32 def = gpr_fast_hash_impl();
+
+  for (i = 0; i < sizeof(data); ++i) data[i] = (U8)(i*2654435761u >> 13);
+
+  printf("%-16s %8s %10s %10s\n", "function", "len", "ns/hash", "GB/s");
+  for (i = 0; i < sizeof(lengths)/sizeof(lengths[0]); ++i)
+  {
+    bench("murmur_64", gpr_murmur_hash_64, lengths[i]);
+    for (impl = 0; impl <= GPR_FAST_HASH_NEON; ++impl)
+    {
+      if (!gpr_fast_hash_use(impl)) continue;
+      // both paths are the same for short keys
+      if (lengths[i] <= GPR_FAST_HASH_LONG && impl != def) continue;
+      sprintf(name, "fast_64 %s", lengths[i] <= GPR_FAST_HASH_LONG ? "" : impl_names[impl]);
+      bench(name, gpr_fast_hash_64, lengths[i]);
+    }
+    gpr_fast_hash_use(def);
+    bench("fast_128", fast_hash_128, lengths[i]);
+    printf("\n");
+  }
+  return 0;
+}
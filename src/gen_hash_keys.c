@@ -0,0 +1,93 @@
+// ---------------------------------------------------------------
+// Hash keys generator
+// ---------------------------------------------------------------
+// Prints a define per name with its gpr_murmur_hash_64 digest, the C
+// counterpart of gpr_murmur_hash_constexpr.h. The names are the
+// arguments, or the lines of the standard input if there are none:
+//
+//   gen_hash_keys -p JSON_KEY_ position velocity > json_keys.h
+//
+// gives JSON_KEY_POSITION & JSON_KEY_VELOCITY for gpr_json_get_key.
+// Two names giving the same define, like a-b & a_b, are an error.
+// The default seed 0 is the one of gpr_json_key.
+//
+//   cc -O2 -Iinclude src/gen_hash_keys.c src/gpr_murmur_hash.c
+// ---------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "gpr_murmur_hash.h"
+
+// the defines already printed: the names are upper cased and their other
+// bytes become '_', so distinct names may give the same define
+static char **macros;
+static char **names;
+static U32    num_macros;
+
+// returns 0 if the define of name was printed for another name
+static I32 print_key(const char *prefix, const char *name, U64 seed)
+{
+  const U32   prefix_len = (U32)strlen(prefix);
+  char       *macro      = (char*)malloc(prefix_len + strlen(name) + 1);
+  char       *m;
+  const char *c;
+  U32         i;
+
+  strcpy(macro, prefix);
+  for (c = name, m = macro + prefix_len; *c; ++c, ++m)
+    *m = isalnum((unsigned char)*c) ? (char)toupper((unsigned char)*c) : '_';
+  *m = '\0';
+
+  for (i = 0; i < num_macros; ++i)
+  {
+    if (strcmp(macros[i], macro) != 0) continue;
+    free(macro);
+    if (strcmp(names[i], name) == 0) return 1; // repeated name
+    fprintf(stderr, "\"%s\" and \"%s\" both give %s\n", names[i], name, macros[i]);
+    return 0;
+  }
+
+  macros = (char**)realloc(macros, (num_macros + 1)*sizeof(char*));
+  names  = (char**)realloc(names,  (num_macros + 1)*sizeof(char*));
+  macros[num_macros] = macro;
+  names[num_macros]  = strcpy((char*)malloc(strlen(name) + 1), name);
+  ++num_macros;
+
+  printf("#define %s 0x%016llxull // \"%s\"\n", macro,
+    (unsigned long long)gpr_murmur_hash_64(name, (U32)strlen(name), seed), name);
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  const char *prefix = "KEY_";
+  U64         seed   = 0;
+  char        line[1024];
+  I32         i = 1, num_args = 0;
+
+  for (; i + 1 < argc && argv[i][0] == '-'; i += 2)
+  {
+    if      (strcmp(argv[i], "-p") == 0) prefix = argv[i + 1];
+    else if (strcmp(argv[i], "-s") == 0) seed   = strtoull(argv[i + 1], NULL, 0);
+    else break;
+  }
+  if (i < argc && argv[i][0] == '-')
+  {
+    fprintf(stderr, "usage: %s [-p prefix] [-s seed] [name...]\n", argv[0]);
+    return 1;
+  }
+
+  for (; i < argc; ++i, ++num_args)
+    if (!print_key(prefix, argv[i], seed)) return 1;
+  if (num_args) return 0;
+
+  while (fgets(line, sizeof(line), stdin))
+  {
+    line[strcspn(line, "\r\n")] = '\0';
+    if (line[0] && !print_key(prefix, line, seed)) return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <string.h>
+#include "gpr_concurrent_hash.h"
+#include "gpr_memory.h"
+
+typedef gpr_concurrent_hash_shard_t shard_t;
+
+// fibonacci hashing: the high bits depend on every bit of the key, the
+// buckets of the shard use the low bits
+static shard_t *find_shard(gpr_concurrent_hash_t *ch, U64 key)
+{
+  const U32 i = (U32)((key*0x9e3779b97f4a7c15ull) >> 40) & ch->shard_mask;
+  return (shard_t*)(ch->shards + i*ch->shard_stride);
+}
+
+void _gpr_concurrent_hash_init(gpr_concurrent_hash_t *ch, const U32 s, 
+                               U32 num_shards, gpr_allocator_t *a)
+{
+  U32 i;
+
+  num_shards = gpr_next_pow2_U32(num_shards ? num_shards : 1);
+  ch->allocator    = a;
+  ch->shard_mask   = num_shards - 1;
+  ch->shard_stride = gpr_next_multiple(sizeof(shard_t), GPR_CONCURRENT_HASH_ALIGN);
+  ch->shards       = (char*)gpr_allocate_align(a, num_shards*ch->shard_stride, 
+                                               GPR_CONCURRENT_HASH_ALIGN);
+  for (i = 0; i < num_shards; ++i)
+  {
+    shard_t *shard = (shard_t*)(ch->shards + i*ch->shard_stride);
+    gpr_rwlock_init(&shard->lock);
+    _gpr_hash_init(&shard->hash, s, a);
+  }
+}
+
+void _gpr_concurrent_hash_destroy(gpr_concurrent_hash_t *ch)
+{
+  U32 i;
+  for (i = 0; i <= ch->shard_mask; ++i)
+    _gpr_hash_destroy(&((shard_t*)(ch->shards + i*ch->shard_stride))->hash);
+  gpr_deallocate(ch->allocator, ch->shards);
+}
+
+I32 _gpr_concurrent_hash_has(gpr_concurrent_hash_t *ch, U64 key)
+{
+  shard_t *shard = find_shard(ch, key);
+  I32      res;
+
+  gpr_rwlock_read_lock(&shard->lock);
+  res = _gpr_hash_has(&shard->hash, key);
+  gpr_rwlock_read_unlock(&shard->lock);
+  return res;
+}
+
+I32 _gpr_concurrent_hash_get(gpr_concurrent_hash_t *ch, const U32 s, U64 key,
+                             void *value)
+{
+  shard_t *shard = find_shard(ch, key);
+  void    *e;
+
+  gpr_rwlock_read_lock(&shard->lock);
+  e = _gpr_hash_get(&shard->hash, key);
+  if (e) memcpy(value, e, s);
+  gpr_rwlock_read_unlock(&shard->lock);
+  return e != NULL;
+}
+
+void _gpr_concurrent_hash_set(gpr_concurrent_hash_t *ch, const U32 s, U64 key,
+                              const void *value)
+{
+  shard_t *shard = find_shard(ch, key);
+
+  gpr_rwlock_write_lock(&shard->lock);
+  _gpr_hash_set(&shard->hash, s, key, value);
+  gpr_rwlock_write_unlock(&shard->lock);
+}
+
+I32 _gpr_concurrent_hash_remove(gpr_concurrent_hash_t *ch, const U32 s, U64 key)
+{
+  shard_t *shard = find_shard(ch, key);
+  I32      res;
+
+  gpr_rwlock_write_lock(&shard->lock);
+  res = _gpr_hash_has(&shard->hash, key);
+  if (res) _gpr_hash_remove(&shard->hash, s, key);
+  gpr_rwlock_write_unlock(&shard->lock);
+  return res;
+}
+
+I32 _gpr_concurrent_hash_compute_if_absent(gpr_concurrent_hash_t *ch, 
+                                           const U32 s, U64 key,
+                                           gpr_concurrent_hash_func_t func, 
+                                           void *arg, void *value)
+{
+  shard_t *shard = find_shard(ch, key);
+  void    *e;
+
+  // most calls find the key: try with the shared lock first
+  if (_gpr_concurrent_hash_get(ch, s, key, value)) return 0;
+
+  gpr_rwlock_write_lock(&shard->lock);
+  e = _gpr_hash_get(&shard->hash, key);
+  if (e)
+  {
+    // inserted by another thread in between
+    memcpy(value, e, s);
+    gpr_rwlock_write_unlock(&shard->lock);
+    return 0;
+  }
+  func(key, value, arg);
+  _gpr_hash_set(&shard->hash, s, key, value);
+  gpr_rwlock_write_unlock(&shard->lock);
+  return 1;
+}
+
+U32 _gpr_concurrent_hash_size(gpr_concurrent_hash_t *ch)
+{
+  U32 i, n = 0;
+  for (i = 0; i <= ch->shard_mask; ++i)
+  {
+    shard_t *shard = (shard_t*)(ch->shards + i*ch->shard_stride);
+    gpr_rwlock_read_lock(&shard->lock);
+    n += shard->hash.num_values;
+    gpr_rwlock_read_unlock(&shard->lock);
+  }
+  return n;
+}
@@ -0,0 +1,238 @@
+#include <string.h>
+#include "gpr_disk_hash.h"
+#include "gpr_assert.h"
+
+typedef gpr_disk_hash_header_t header_t;
+
+typedef struct
+{
+  U64 key;
+  U32 next;
+  U32 used;
+  // value follows
+} entry_t;
+
+#define END_OF_LIST     0xffffffffu
+#define MAX_LOAD_FACTOR 0.75f
+#define MIN_CAPACITY    64
+
+#define ENTRIES_POS gpr_next_multiple(sizeof(header_t), GPR_DISK_HASH_ALIGN)
+
+static header_t *header(gpr_disk_hash_t *dh)
+{
+  return (header_t*)dh->map.data;
+}
+
+static entry_t *entry(gpr_disk_hash_t *dh, U32 i)
+{
+  return (entry_t*)(dh->map.data + ENTRIES_POS + (U64)i*header(dh)->entry_size);
+}
+
+static U32 *buckets(gpr_disk_hash_t *dh)
+{
+  return (U32*)(dh->map.data + header(dh)->buckets_pos);
+}
+
+// fibonacci hashing: the keys do not have to be well distributed
+static U32 *find_bucket(gpr_disk_hash_t *dh, U64 key)
+{
+  const U32 mask = header(dh)->num_buckets - 1;
+  return buckets(dh) + ((U32)((key*0x9e3779b97f4a7c15ull) >> 32) & mask);
+}
+
+static U32 *find_link(gpr_disk_hash_t *dh, U64 key)
+{
+  U32 *link = find_bucket(dh, key);
+  while (*link != END_OF_LIST && entry(dh, *link)->key != key)
+    link = &entry(dh, *link)->next;
+  return link;
+}
+
+static U64 file_size(U32 entry_size, U32 entries_capacity, U32 num_buckets)
+{
+  return ENTRIES_POS + (U64)entries_capacity*entry_size + (U64)num_buckets*sizeof(U32);
+}
+
+static void rebuild_buckets(gpr_disk_hash_t *dh)
+{
+  const header_t *h = header(dh);
+  U32 i, *bucket;
+
+  memset(buckets(dh), 0xff, (size_t)h->num_buckets*sizeof(U32));
+  for (i = 0; i < h->num_entries; ++i)
+  {
+    entry_t *e = entry(dh, i);
+    if (!e->used) continue;
+    bucket  = find_bucket(dh, e->key);
+    e->next = *bucket;
+    *bucket = i;
+  }
+}
+
+// grows the file to the new capacities: the buckets are moved after the
+// entries, or rebuilt when their number changes
+static I32 resize(gpr_disk_hash_t *dh, U32 entries_capacity, U32 num_buckets)
+{
+  header_t *h              = header(dh);
+  const U64 old_pos        = h->buckets_pos;
+  const U32 old_buckets    = h->num_buckets;
+  const U64 new_pos        = ENTRIES_POS + (U64)entries_capacity*h->entry_size;
+
+  if (!gpr_file_map_resize(&dh->map,
+    file_size(h->entry_size, entries_capacity, num_buckets))) return 0;
+
+  h = header(dh);
+  h->entries_capacity = entries_capacity;
+  h->num_buckets      = num_buckets;
+  h->buckets_pos      = new_pos;
+  if (num_buckets != old_buckets) rebuild_buckets(dh);
+  else if (new_pos != old_pos)
+    memmove(dh->map.data + new_pos, dh->map.data + old_pos,
+      (size_t)num_buckets*sizeof(U32));
+  return 1;
+}
+
+static I32 updated(gpr_disk_hash_t *dh)
+{
+  if (dh->sync_interval == 0 || ++dh->num_unsynced < dh->sync_interval)
+    return 1;
+  return gpr_disk_hash_sync(dh);
+}
+
+I32 _gpr_disk_hash_open(gpr_disk_hash_t *dh, const U32 s, const char *path,
+                        U32 sync_interval)
+{
+  const U32 entry_size = gpr_next_multiple(sizeof(entry_t) + s, 8);
+  header_t *h;
+
+  dh->sync_interval = sync_interval;
+  dh->num_unsynced  = 0;
+  if (!gpr_file_map_write(&dh->map, path,
+    file_size(entry_size, MIN_CAPACITY, MIN_CAPACITY))) return 0;
+
+  // a new file is filled with zeros
+  h = header(dh);
+  if (h->magic == 0)
+  {
+    h->magic            = GPR_DISK_HASH_MAGIC;
+    h->value_size       = s;
+    h->entry_size       = entry_size;
+    h->num_values       = 0;
+    h->num_entries      = 0;
+    h->entries_capacity = MIN_CAPACITY;
+    h->num_buckets      = MIN_CAPACITY;
+    h->free_head        = END_OF_LIST;
+    h->buckets_pos      = ENTRIES_POS + (U64)MIN_CAPACITY*entry_size;
+    memset(buckets(dh), 0xff, MIN_CAPACITY*sizeof(U32));
+  }
+  else if (h->magic != GPR_DISK_HASH_MAGIC || h->value_size != s ||
+    dh->map.size < file_size(entry_size, h->entries_capacity, h->num_buckets))
+  {
+    gpr_file_unmap(&dh->map);
+    return 0;
+  }
+  return 1;
+}
+
+I32 gpr_disk_hash_close(gpr_disk_hash_t *dh)
+{
+  const I32 res = gpr_disk_hash_sync(dh);
+  gpr_file_unmap(&dh->map);
+  return res;
+}
+
+I32 gpr_disk_hash_sync(gpr_disk_hash_t *dh)
+{
+  dh->num_unsynced = 0;
+  return gpr_file_sync(&dh->map);
+}
+
+I32 _gpr_disk_hash_has(gpr_disk_hash_t *dh, U64 key)
+{
+  return *find_link(dh, key) != END_OF_LIST;
+}
+
+void *_gpr_disk_hash_get(gpr_disk_hash_t *dh, U64 key)
+{
+  const U32 i = *find_link(dh, key);
+  return i == END_OF_LIST ? NULL : entry(dh, i) + 1;
+}
+
+I32 _gpr_disk_hash_set(gpr_disk_hash_t *dh, const U32 s, U64 key, const void *value)
+{
+  header_t *h = header(dh);
+  U32      *link, i;
+  entry_t  *e;
+
+  gpr_assert(s == h->value_size);
+
+  i = *find_link(dh, key);
+  if (i != END_OF_LIST)
+  {
+    memcpy(entry(dh, i) + 1, value, s);
+    return updated(dh);
+  }
+
+  // room for one more value
+  if (h->num_values + 1 > (U32)(h->num_buckets*MAX_LOAD_FACTOR) ||
+     (h->free_head == END_OF_LIST && h->num_entries == h->entries_capacity))
+  {
+    if (!_gpr_disk_hash_reserve(dh, h->num_values < MIN_CAPACITY ?
+      MIN_CAPACITY*2 : h->num_values*2)) return 0;
+    h = header(dh);
+  }
+
+  if (h->free_head != END_OF_LIST)
+  {
+    i = h->free_head;
+    h->free_head = entry(dh, i)->next;
+  }
+  else i = h->num_entries++;
+
+  link    = find_bucket(dh, key);
+  e       = entry(dh, i);
+  e->key  = key;
+  e->used = 1;
+  e->next = *link;
+  memcpy(e + 1, value, s);
+  *link = i;
+  ++h->num_values;
+  return updated(dh);
+}
+
+I32 _gpr_disk_hash_remove(gpr_disk_hash_t *dh, U64 key)
+{
+  header_t *h    = header(dh);
+  U32      *link = find_link(dh, key);
+  entry_t  *e;
+  U32       i    = *link;
+
+  if (i == END_OF_LIST) return 0;
+  e = entry(dh, i);
+  *link   = e->next;
+  e->used = 0;
+  e->next = h->free_head;
+  h->free_head = i;
+  --h->num_values;
+  return updated(dh);
+}
+
+I32 _gpr_disk_hash_reserve(gpr_disk_hash_t *dh, U32 capacity)
+{
+  const header_t *h = header(dh);
+  U32 entries_capacity = h->entries_capacity;
+  U32 num_buckets      = h->num_buckets;
+
+  // the entries grow by doubling too: appends stay amortized
+  while (entries_capacity < capacity) entries_capacity <<= 1;
+  while ((U32)(num_buckets*MAX_LOAD_FACTOR) < capacity) num_buckets <<= 1;
+
+  if (entries_capacity == h->entries_capacity && num_buckets == h->num_buckets)
+    return 1;
+  return resize(dh, entries_capacity, num_buckets);
+}
+
+U32 _gpr_disk_hash_size(gpr_disk_hash_t *dh)
+{
+  return header(dh)->num_values;
+}
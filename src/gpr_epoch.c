@@ -0,0 +1,177 @@
+#include "gpr_epoch.h"
+#include "gpr_atomic.h"
+#include "gpr_assert.h"
+
+typedef gpr_epoch_retired_t retired_t;
+typedef gpr_epoch_thread_t  thread_t;
+
+#define ACTIVE     1u
+#define EPOCH_MASK 0x7fffffffu
+
+// blocks retired during epoch x are unreachable once the global epoch
+// reached x+2: every reader active during x has left its critical section
+#define SAFE(global, x) ((U32)((global) - (x)) >= 2)
+
+static U32 free_limbo(gpr_epoch_limbo_t *l)
+{
+  U32 i, n = gpr_array_size(l);
+  for (i = 0; i < n; ++i)
+  {
+    retired_t *r = &gpr_array_item(l, i);
+    if (r->func) r->func(r->p, r->allocator);
+    else gpr_deallocate(r->allocator, r->p);
+  }
+  gpr_array_resize(retired_t, l, 0);
+  return n;
+}
+
+static void try_advance(gpr_epoch_t *e)
+{
+  U32 i, g;
+
+  // someone else is already scanning
+  if (!gpr_mutex_trylock(&e->lock)) return;
+
+  g = gpr_atomic_load_U32(&e->epoch);
+  for (i = 0; i < gpr_array_size(&e->threads); ++i)
+  {
+    U32 s = gpr_atomic_load_U32(&gpr_array_item(&e->threads, i)->state);
+    if ((s & ACTIVE) && (s >> 1) != (g & EPOCH_MASK))
+    {
+      gpr_mutex_unlock(&e->lock);
+      return;
+    }
+  }
+  gpr_atomic_cas_U32(&e->epoch, g, g+1);
+  gpr_mutex_unlock(&e->lock);
+}
+
+void gpr_epoch_init(gpr_epoch_t *e, gpr_allocator_t *a)
+{
+  e->epoch     = 0;
+  e->allocator = a;
+  gpr_mutex_init(&e->lock);
+  gpr_array_init(thread_t*, &e->threads, a);
+  gpr_array_init(retired_t, &e->orphans, a);
+  e->orphans_epoch = 0;
+}
+
+void gpr_epoch_destroy(gpr_epoch_t *e)
+{
+  gpr_assert_msg(gpr_array_empty(&e->threads), "threads still registered");
+  free_limbo(&e->orphans);
+  gpr_array_destroy(&e->orphans);
+  gpr_array_destroy(&e->threads);
+}
+
+void gpr_epoch_register(gpr_epoch_t *e, gpr_epoch_thread_t *t, gpr_allocator_t *a)
+{
+  U32 i;
+
+  t->state       = 0;
+  t->nesting     = 0;
+  t->num_retired = 0;
+  for (i = 0; i < 3; ++i)
+  {
+    gpr_array_init(retired_t, &t->limbo[i], a);
+    t->limbo_epoch[i] = 0;
+  }
+
+  gpr_mutex_lock(&e->lock);
+  gpr_array_push_back(thread_t*, &e->threads, t);
+  gpr_mutex_unlock(&e->lock);
+}
+
+void gpr_epoch_unregister(gpr_epoch_t *e, gpr_epoch_thread_t *t)
+{
+  U32 i, j;
+  gpr_assert_msg(t->nesting == 0, "unregistered inside a critical section");
+
+  gpr_mutex_lock(&e->lock);
+  for (i = 0; i < gpr_array_size(&e->threads); ++i)
+  {
+    if (gpr_array_item(&e->threads, i) != t) continue;
+    gpr_array_remove(&e->threads, i);
+    break;
+  }
+
+  // readers may still reference the pending blocks: hand them over
+  for (i = 0; i < 3; ++i)
+  {
+    for (j = 0; j < gpr_array_size(&t->limbo[i]); ++j)
+      gpr_array_push_back(retired_t, &e->orphans, gpr_array_item(&t->limbo[i], j));
+    gpr_array_destroy(&t->limbo[i]);
+  }
+  e->orphans_epoch = gpr_atomic_load_U32(&e->epoch);
+  gpr_mutex_unlock(&e->lock);
+}
+
+void gpr_epoch_enter(gpr_epoch_t *e, gpr_epoch_thread_t *t)
+{
+  U32 g;
+  if (t->nesting++ > 0) return;
+
+  // the exchange is a full barrier: the state is published before any
+  // shared pointer is loaded
+  g = gpr_atomic_load_U32(&e->epoch);
+  gpr_atomic_xchg_U32(&t->state, ((g & EPOCH_MASK) << 1) | ACTIVE);
+}
+
+void gpr_epoch_exit(gpr_epoch_t *e, gpr_epoch_thread_t *t)
+{
+  gpr_assert(t->nesting > 0);
+  if (--t->nesting > 0) return;
+  gpr_atomic_store_U32(&t->state, 0);
+}
+
+void gpr_epoch_retire(gpr_epoch_t *e, gpr_epoch_thread_t *t, void *p,
+                      gpr_allocator_t *a)
+{
+  gpr_epoch_retire_func(e, t, p, a, NULL);
+}
+
+void gpr_epoch_retire_func(gpr_epoch_t *e, gpr_epoch_thread_t *t, void *p,
+                           gpr_allocator_t *a, gpr_epoch_free_func_t func)
+{
+  const U32 g = gpr_atomic_load_U32(&e->epoch);
+  const U32 i = g % 3;
+  retired_t r;
+
+  // the list still holds blocks of an older epoch
+  if (gpr_array_any(&t->limbo[i]) && t->limbo_epoch[i] != g)
+  {
+    if (SAFE(g, t->limbo_epoch[i]))
+      t->num_retired -= free_limbo(&t->limbo[i]);
+  }
+  t->limbo_epoch[i] = g;
+
+  r.p         = p;
+  r.allocator = a;
+  r.func      = func;
+  gpr_array_push_back(retired_t, &t->limbo[i], r);
+
+  if (++t->num_retired >= GPR_EPOCH_BATCH) gpr_epoch_reclaim(e, t);
+}
+
+U32 gpr_epoch_reclaim(gpr_epoch_t *e, gpr_epoch_thread_t *t)
+{
+  U32 i, g, freed = 0;
+
+  try_advance(e);
+  g = gpr_atomic_load_U32(&e->epoch);
+
+  for (i = 0; i < 3; ++i)
+  {
+    if (gpr_array_any(&t->limbo[i]) && SAFE(g, t->limbo_epoch[i]))
+      freed += free_limbo(&t->limbo[i]);
+  }
+  t->num_retired -= freed;
+
+  if (gpr_mutex_trylock(&e->lock))
+  {
+    if (gpr_array_any(&e->orphans) && SAFE(g, e->orphans_epoch))
+      freed += free_limbo(&e->orphans);
+    gpr_mutex_unlock(&e->lock);
+  }
+  return freed;
+}
@@ -0,0 +1,477 @@
+#include <string.h>
+#include "gpr_fast_hash.h"
+
+// ---------------------------------------------------------------
+// Platform
+// ---------------------------------------------------------------
+
+#if !defined(PLATFORM_BIG_ENDIAN)
+  #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define HAS_SSE2
+    #include <emmintrin.h>
+    #if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+      #define HAS_AVX2
+      #define TARGET_AVX2 __attribute__((target("avx2")))
+      #include <immintrin.h>
+    #elif defined(_M_X64)
+      #define HAS_AVX2
+      #define TARGET_AVX2
+      #include <immintrin.h>
+      #include <intrin.h>
+    #endif
+  #elif defined(__ARM_NEON) || defined(__aarch64__)
+    #define HAS_NEON
+    #include <arm_neon.h>
+  #endif
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+// unaligned little endian loads
+static U64 read64(const U8 *p)
+{
+  U64 v;
+  memcpy(&v, p, 8);
+#ifdef PLATFORM_BIG_ENDIAN
+  v = gpr_swap_U64(v);
+#endif
+  return v;
+}
+
+static U64 read32(const U8 *p)
+{
+  U32 v;
+  memcpy(&v, p, 4);
+#ifdef PLATFORM_BIG_ENDIAN
+  v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+#endif
+  return v;
+}
+
+// 64x64 -> 128 bits product, low half in a, high half in b
+static void mum(U64 *a, U64 *b)
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = (unsigned __int128)*a * *b;
+  *a = (U64)r;
+  *b = (U64)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  *a = _umul128(*a, *b, b);
+#else
+  const U64 ha = *a >> 32, hb = *b >> 32, la = (U32)*a, lb = (U32)*b;
+  const U64 rh = ha*hb, rm0 = ha*lb, rm1 = hb*la, rl = la*lb;
+  const U64 t  = rl + (rm0 << 32);
+  U64       c  = t < rl;
+  const U64 lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static U64 mix(U64 a, U64 b)
+{
+  mum(&a, &b);
+  return a ^ b;
+}
+
+// ---------------------------------------------------------------
+// Short keys: wyhash
+// ---------------------------------------------------------------
+
+static const U64 wyp[4] =
+{
+  0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+  0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+static U64 hash_short(const U8 *p, U32 len, U64 seed)
+{
+  U64 a, b;
+
+  seed ^= mix(seed ^ wyp[0], wyp[1]);
+  if (len <= 16)
+  {
+    if (len >= 4)
+    {
+      // two overlapping reads of 4 bytes at each end
+      const U32 o = (len >> 3) << 2;
+      a = (read32(p) << 32) | read32(p + o);
+      b = (read32(p + len - 4) << 32) | read32(p + len - 4 - o);
+    }
+    else if (len > 0)
+    {
+      a = ((U64)p[0] << 16) | ((U64)p[len >> 1] << 8) | p[len - 1];
+      b = 0;
+    }
+    else a = b = 0;
+  }
+  else
+  {
+    U32 i = len;
+    if (i > 48)
+    {
+      U64 see1 = seed, see2 = seed;
+      do
+      {
+        seed = mix(read64(p)      ^ wyp[1], read64(p + 8)  ^ seed);
+        see1 = mix(read64(p + 16) ^ wyp[2], read64(p + 24) ^ see1);
+        see2 = mix(read64(p + 32) ^ wyp[3], read64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16)
+    {
+      seed = mix(read64(p) ^ wyp[1], read64(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    // the last 16 bytes, overlapping the previous ones
+    a = read64(p + i - 16);
+    b = read64(p + i - 8);
+  }
+
+  a ^= wyp[1];
+  b ^= seed;
+  mum(&a, &b);
+  return mix(a ^ wyp[0] ^ len, b ^ wyp[1]);
+}
+
+// ---------------------------------------------------------------
+// Long keys: 8 lanes accumulated over 64 bytes stripes
+// ---------------------------------------------------------------
+// Stripe j of a block is combined with the key words j..j+7, a block
+// ends with a scramble of the lanes by the words 16..23.
+// Each lane adds the product of the 32 bits halves of the input xored
+// with the key, and its neighbour adds the raw input so that no input
+// bit is lost when a product is zero.
+// ---------------------------------------------------------------
+
+#define STRIPE            64
+#define STRIPES_PER_BLOCK 8
+#define BLOCK             (STRIPE*STRIPES_PER_BLOCK)
+#define PRIME32           0x9e3779b1u
+
+static const U64 keys[24] =
+{
+  0x1ac046dda8e86e2aull, 0xbe2c3b00b1d348c8ull, 0x9b1a66a95412ff75ull,
+  0xc448c2b1f05f7e4cull, 0xc111ca6b8f6e73c4ull, 0xb54861920d05b01dull,
+  0x8d61500f4a7bbe16ull, 0x5e0c25471f89e02eull, 0x48105a3d28f0e221ull,
+  0x2169f8846b637746ull, 0x3d628782e0c0d863ull, 0xa5ddb2216078aa40ull,
+  0xc8119d17f0571101ull, 0x98e2e2eb8f33280full, 0x8cd1e28860679cc4ull,
+  0x9dca6189c923aef3ull, 0x9d8d3071ba4f04c4ull, 0x5d395ada34220c26ull,
+  0xe6de42a441a1e28eull, 0x308fbf68cc864f59ull, 0x216a3c81332862f9ull,
+  0xbaceca0a77f3132eull, 0xdf2a2215339ca69cull, 0x3e4c11a103a5d859ull,
+};
+
+// processes n stripes, stripe j with the key words j..j+7
+typedef void (*accumulate_func_t)(U64 *acc, const U8 *p, U32 n, const U64 *k);
+typedef void (*scramble_func_t)  (U64 *acc, const U64 *k);
+
+static void accumulate_scalar(U64 *acc, const U8 *p, U32 n, const U64 *k)
+{
+  U32 i, j;
+  for (j = 0; j < n; ++j, p += STRIPE)
+  {
+    for (i = 0; i < 8; ++i)
+    {
+      const U64 d  = read64(p + i*8);
+      const U64 dk = d ^ k[j + i];
+      acc[i ^ 1] += d;
+      acc[i]     += (dk & 0xffffffffu)*(dk >> 32);
+    }
+  }
+}
+
+static void scramble_scalar(U64 *acc, const U64 *k)
+{
+  U32 i;
+  for (i = 0; i < 8; ++i)
+  {
+    U64 a = acc[i];
+    a ^= a >> 47;
+    a ^= k[i];
+    acc[i] = a*PRIME32;
+  }
+}
+
+#ifdef HAS_SSE2
+
+static void accumulate_sse2(U64 *acc, const U8 *p, U32 n, const U64 *k)
+{
+  __m128i a[4];
+  U32     i, j;
+
+  for (i = 0; i < 4; ++i) a[i] = _mm_loadu_si128((const __m128i*)acc + i);
+  for (j = 0; j < n; ++j, p += STRIPE)
+  {
+    for (i = 0; i < 4; ++i)
+    {
+      const __m128i d  = _mm_loadu_si128((const __m128i*)p + i);
+      const __m128i dk = _mm_xor_si128(d, _mm_loadu_si128((const __m128i*)(k + j) + i));
+      const __m128i hi = _mm_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1));
+      a[i] = _mm_add_epi64(a[i], _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)));
+      a[i] = _mm_add_epi64(a[i], _mm_mul_epu32(dk, hi));
+    }
+  }
+  for (i = 0; i < 4; ++i) _mm_storeu_si128((__m128i*)acc + i, a[i]);
+}
+
+static void scramble_sse2(U64 *acc, const U64 *k)
+{
+  const __m128i prime = _mm_set1_epi32((int)PRIME32);
+  U32 i;
+
+  for (i = 0; i < 4; ++i)
+  {
+    __m128i a = _mm_loadu_si128((const __m128i*)acc + i);
+    __m128i lo, hi;
+    a  = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+    a  = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)k + i));
+    // 64x32 bits product from two 32x32 ones
+    lo = _mm_mul_epu32(a, prime);
+    hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 1, 1)), prime);
+    _mm_storeu_si128((__m128i*)acc + i, _mm_add_epi64(lo, _mm_slli_epi64(hi, 32)));
+  }
+}
+
+#endif
+
+#ifdef HAS_AVX2
+
+TARGET_AVX2
+static void accumulate_avx2(U64 *acc, const U8 *p, U32 n, const U64 *k)
+{
+  __m256i a[2];
+  U32     i, j;
+
+  for (i = 0; i < 2; ++i) a[i] = _mm256_loadu_si256((const __m256i*)acc + i);
+  for (j = 0; j < n; ++j, p += STRIPE)
+  {
+    for (i = 0; i < 2; ++i)
+    {
+      const __m256i d  = _mm256_loadu_si256((const __m256i*)p + i);
+      const __m256i dk = _mm256_xor_si256(d,
+        _mm256_loadu_si256((const __m256i*)(k + j) + i));
+      const __m256i hi = _mm256_shuffle_epi32(dk, _MM_SHUFFLE(0, 3, 0, 1));
+      a[i] = _mm256_add_epi64(a[i], _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2)));
+      a[i] = _mm256_add_epi64(a[i], _mm256_mul_epu32(dk, hi));
+    }
+  }
+  for (i = 0; i < 2; ++i) _mm256_storeu_si256((__m256i*)acc + i, a[i]);
+}
+
+TARGET_AVX2
+static void scramble_avx2(U64 *acc, const U64 *k)
+{
+  const __m256i prime = _mm256_set1_epi32((int)PRIME32);
+  U32 i;
+
+  for (i = 0; i < 2; ++i)
+  {
+    __m256i a = _mm256_loadu_si256((const __m256i*)acc + i);
+    __m256i lo, hi;
+    a  = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+    a  = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)k + i));
+    lo = _mm256_mul_epu32(a, prime);
+    hi = _mm256_mul_epu32(_mm256_shuffle_epi32(a, _MM_SHUFFLE(3, 3, 1, 1)), prime);
+    _mm256_storeu_si256((__m256i*)acc + i, _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32)));
+  }
+}
+
+static I32 cpu_has_avx2(void)
+{
+#if defined(_MSC_VER)
+  int r[4];
+  __cpuid(r, 0);
+  if (r[0] < 7) return 0;
+  __cpuid(r, 1);
+  // the OS must save the ymm registers
+  if ((r[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) return 0;
+  __cpuidex(r, 7, 0);
+  return (r[1] & (1 << 5)) != 0;
+#else
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+#ifdef HAS_NEON
+
+static void accumulate_neon(U64 *acc, const U8 *p, U32 n, const U64 *k)
+{
+  uint64x2_t a[4];
+  U32        i, j;
+
+  for (i = 0; i < 4; ++i) a[i] = vld1q_u64((const uint64_t*)acc + 2*i);
+  for (j = 0; j < n; ++j, p += STRIPE)
+  {
+    for (i = 0; i < 4; ++i)
+    {
+      const uint64x2_t d  = vreinterpretq_u64_u8(vld1q_u8(p + 16*i));
+      const uint64x2_t dk = veorq_u64(d, vld1q_u64((const uint64_t*)k + j + 2*i));
+      a[i] = vaddq_u64(a[i], vextq_u64(d, d, 1));
+      a[i] = vmlal_u32(a[i], vmovn_u64(dk), vshrn_n_u64(dk, 32));
+    }
+  }
+  for (i = 0; i < 4; ++i) vst1q_u64((uint64_t*)acc + 2*i, a[i]);
+}
+
+static void scramble_neon(U64 *acc, const U64 *k)
+{
+  const uint32x2_t prime = vdup_n_u32(PRIME32);
+  U32 i;
+
+  for (i = 0; i < 4; ++i)
+  {
+    uint64x2_t a = vld1q_u64((const uint64_t*)acc + 2*i);
+    uint64x2_t hi;
+    a  = veorq_u64(a, vshrq_n_u64(a, 47));
+    a  = veorq_u64(a, vld1q_u64((const uint64_t*)k + 2*i));
+    hi = vshlq_n_u64(vmull_u32(vshrn_n_u64(a, 32), prime), 32);
+    vst1q_u64((uint64_t*)acc + 2*i, vmlal_u32(hi, vmovn_u64(a), prime));
+  }
+}
+
+#endif
+
+// ---------------------------------------------------------------
+// Dispatch
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  accumulate_func_t accumulate;
+  scramble_func_t   scramble;
+} impl_t;
+
+static const impl_t impls[4] =
+{
+  { accumulate_scalar, scramble_scalar },
+#ifdef HAS_SSE2
+  { accumulate_sse2,   scramble_sse2   },
+#else
+  { NULL, NULL },
+#endif
+#ifdef HAS_AVX2
+  { accumulate_avx2,   scramble_avx2   },
+#else
+  { NULL, NULL },
+#endif
+#ifdef HAS_NEON
+  { accumulate_neon,   scramble_neon   },
+#else
+  { NULL, NULL },
+#endif
+};
+
+// chosen at the first long key: concurrent first calls store the same value
+static const impl_t *volatile current = NULL;
+static U32 volatile           current_id;
+
+static I32 supported(U32 impl)
+{
+  if (impl > GPR_FAST_HASH_NEON || impls[impl].accumulate == NULL) return 0;
+#ifdef HAS_AVX2
+  if (impl == GPR_FAST_HASH_AVX2) return cpu_has_avx2();
+#endif
+  return 1;
+}
+
+static const impl_t *select_impl(void)
+{
+  U32 impl = GPR_FAST_HASH_NEON;
+  while (!supported(impl)) --impl;
+  current_id = impl;
+  current    = &impls[impl];
+  return current;
+}
+
+U32 gpr_fast_hash_impl(void)
+{
+  if (current == NULL) select_impl();
+  return current_id;
+}
+
+I32 gpr_fast_hash_use(U32 impl)
+{
+  if (!supported(impl)) return 0;
+  current_id = impl;
+  current    = &impls[impl];
+  return 1;
+}
+
+static void accumulate_long(U64 *acc, const U8 *p, U32 len, U64 seed)
+{
+  const impl_t *impl = current ? current : select_impl();
+  const U32     num_blocks = (len - 1)/BLOCK;
+  U32           i;
+
+  for (i = 0; i < 8; ++i) acc[i] = keys[i] ^ seed;
+
+  for (i = 0; i < num_blocks; ++i, p += BLOCK)
+  {
+    impl->accumulate(acc, p, STRIPES_PER_BLOCK, keys);
+    impl->scramble(acc, keys + 16);
+  }
+
+  // full stripes of the last block, then the last 64 bytes that overlap
+  // them with other key words
+  len -= num_blocks*BLOCK;
+  impl->accumulate(acc, p, (len - 1)/STRIPE, keys);
+  impl->accumulate(acc, p + len - STRIPE, 1, keys + 9);
+}
+
+static U64 avalanche(U64 h)
+{
+  h ^= h >> 37;
+  h *= 0x165667919e3779f9ull;
+  return h ^ (h >> 32);
+}
+
+static U64 merge(const U64 *acc, const U64 *k, U64 h)
+{
+  U32 i;
+  for (i = 0; i < 4; ++i)
+    h += mix(acc[2*i] ^ k[2*i], acc[2*i + 1] ^ k[2*i + 1]);
+  return avalanche(h);
+}
+
+// ---------------------------------------------------------------
+// Hash functions
+// ---------------------------------------------------------------
+
+U64 gpr_fast_hash_64(const void *key, U32 len, U64 seed)
+{
+  U64 acc[8];
+
+  if (len <= GPR_FAST_HASH_LONG) return hash_short((const U8*)key, len, seed);
+
+  accumulate_long(acc, (const U8*)key, len, seed);
+  return merge(acc, keys + 4, len*0x9e3779b185ebca87ull);
+}
+
+gpr_hash128_t gpr_fast_hash_128(const void *key, U32 len, U64 seed)
+{
+  gpr_hash128_t r;
+  U64           acc[8];
+
+  if (len <= GPR_FAST_HASH_LONG)
+  {
+    r.lo = hash_short((const U8*)key, len, seed);
+    r.hi = hash_short((const U8*)key, len, seed ^ 0x9e3779b97f4a7c15ull);
+    return r;
+  }
+
+  accumulate_long(acc, (const U8*)key, len, seed);
+  r.lo = merge(acc, keys + 4,  len*0x9e3779b185ebca87ull);
+  r.hi = merge(acc, keys + 12, ~(len*0xc2b2ae3d27d4eb4full));
+  return r;
+}
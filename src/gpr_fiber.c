@@ -0,0 +1,278 @@
+#include "gpr_fiber.h"
+#include "gpr_assert.h"
+
+// ---------------------------------------------------------------
+// Windows: native fibers
+// ---------------------------------------------------------------
+// The stack is allocated by the system, the provided one is unused.
+// ---------------------------------------------------------------
+
+#if defined(GPR_FIBER_WIN32)
+
+#ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+static void WINAPI fiber_start(void *p)
+{
+  gpr_fiber_t *f = (gpr_fiber_t*)p;
+  f->func(f->arg);
+  gpr_assert_failure_msg("a fiber function must not return");
+}
+
+void gpr_fiber_init(gpr_fiber_t *f, gpr_fiber_func_t func, void *arg,
+                    char *stack, U32 stack_size)
+{
+  f->func   = func;
+  f->arg    = arg;
+  f->handle = CreateFiber(stack_size, fiber_start, f);
+  gpr_assert_alloc(f->handle);
+}
+
+void gpr_fiber_init_thread(gpr_fiber_t *f)
+{
+  f->func   = NULL;
+  f->arg    = NULL;
+  f->handle = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(NULL);
+}
+
+void gpr_fiber_destroy(gpr_fiber_t *f)
+{
+  if (f->func) DeleteFiber(f->handle);
+  else ConvertFiberToThread();
+}
+
+void gpr_fiber_switch(gpr_fiber_t *from, gpr_fiber_t *to)
+{
+  SwitchToFiber(to->handle);
+}
+
+// ---------------------------------------------------------------
+// x86-64: hand written context switch
+// ---------------------------------------------------------------
+// Only the callee-saved registers, the sse control/status register and
+// the x87 control word have to be preserved across a call.
+// ---------------------------------------------------------------
+
+#elif defined(GPR_FIBER_X64)
+
+#if defined(__APPLE__)
+  #define ASM_SYMBOL(name) "_" #name
+  #define ASM_HEADER(name) ".globl _" #name "\n .private_extern _" #name "\n"
+#else
+  #define ASM_SYMBOL(name) #name
+  #define ASM_HEADER(name) ".globl " #name "\n .hidden " #name "\n" \
+                           ".type " #name ", @function\n"
+#endif
+
+// void gpr_fiber_switch_x64(void **from_sp, void *to_sp)
+void gpr_fiber_switch_x64 (void **from_sp, void *to_sp);
+void gpr_fiber_start_x64  (void);
+
+__asm__(
+  ".text\n"
+  ASM_HEADER(gpr_fiber_switch_x64)
+  ASM_SYMBOL(gpr_fiber_switch_x64) ":\n"
+  "  pushq %rbp\n"
+  "  pushq %rbx\n"
+  "  pushq %r12\n"
+  "  pushq %r13\n"
+  "  pushq %r14\n"
+  "  pushq %r15\n"
+  "  subq  $8, %rsp\n"
+  "  stmxcsr (%rsp)\n"
+  "  fnstcw  4(%rsp)\n"
+  "  movq  %rsp, (%rdi)\n"
+  "  movq  %rsi, %rsp\n"
+  "  ldmxcsr (%rsp)\n"
+  "  fldcw   4(%rsp)\n"
+  "  addq  $8, %rsp\n"
+  "  popq  %r15\n"
+  "  popq  %r14\n"
+  "  popq  %r13\n"
+  "  popq  %r12\n"
+  "  popq  %rbx\n"
+  "  popq  %rbp\n"
+  "  ret\n"
+  // first switch to a fiber: r12 holds the function and r13 its argument
+  ASM_HEADER(gpr_fiber_start_x64)
+  ASM_SYMBOL(gpr_fiber_start_x64) ":\n"
+  "  andq  $-16, %rsp\n"
+  "  movq  %r13, %rdi\n"
+  "  callq *%r12\n"
+  "  ud2\n"
+);
+
+static void fiber_start(gpr_fiber_t *f)
+{
+  f->func(f->arg);
+  gpr_assert_failure_msg("a fiber function must not return");
+}
+
+void gpr_fiber_init(gpr_fiber_t *f, gpr_fiber_func_t func, void *arg,
+                    char *stack, U32 stack_size)
+{
+  U64 *sp = (U64*)(((U64)(stack + stack_size)) & ~(U64)15);
+
+  f->func = func;
+  f->arg  = arg;
+
+  // frame popped by the first gpr_fiber_switch_x64
+  *--sp = 0;                        // alignment
+  *--sp = (U64)gpr_fiber_start_x64; // return address
+  *--sp = 0;                        // rbp
+  *--sp = 0;                        // rbx
+  *--sp = (U64)fiber_start;         // r12
+  *--sp = (U64)f;                   // r13
+  *--sp = 0;                        // r14
+  *--sp = 0;                        // r15
+  *--sp = 0x037f00001f80ull;        // default x87 control word | mxcsr
+  f->sp = sp;
+}
+
+void gpr_fiber_init_thread(gpr_fiber_t *f)
+{
+  f->func = NULL;
+  f->arg  = NULL;
+  f->sp   = NULL;
+}
+
+void gpr_fiber_destroy(gpr_fiber_t *f) {}
+
+void gpr_fiber_switch(gpr_fiber_t *from, gpr_fiber_t *to)
+{
+  gpr_fiber_switch_x64(&from->sp, to->sp);
+}
+
+// ---------------------------------------------------------------
+// Other platforms: ucontext
+// ---------------------------------------------------------------
+
+#else
+
+// makecontext only passes int arguments: the fiber pointer is split
+static void fiber_start(U32 lo, U32 hi)
+{
+  gpr_fiber_t *f = (gpr_fiber_t*)(((U64)hi << 32) | (U64)lo);
+  f->func(f->arg);
+  gpr_assert_failure_msg("a fiber function must not return");
+}
+
+void gpr_fiber_init(gpr_fiber_t *f, gpr_fiber_func_t func, void *arg,
+                    char *stack, U32 stack_size)
+{
+  const U64 p = (U64)f;
+
+  f->func = func;
+  f->arg  = arg;
+
+  getcontext(&f->context);
+  f->context.uc_stack.ss_sp   = stack;
+  f->context.uc_stack.ss_size = stack_size;
+  f->context.uc_link          = NULL;
+  makecontext(&f->context, (void(*)(void))fiber_start, 2,
+    (U32)(p & 0xffffffffu), (U32)(p >> 32));
+}
+
+void gpr_fiber_init_thread(gpr_fiber_t *f)
+{
+  f->func = NULL;
+  f->arg  = NULL;
+}
+
+void gpr_fiber_destroy(gpr_fiber_t *f) {}
+
+void gpr_fiber_switch(gpr_fiber_t *from, gpr_fiber_t *to)
+{
+  swapcontext(&from->context, &to->context);
+}
+
+#endif
+
+// ---------------------------------------------------------------
+// Fiber pool
+// ---------------------------------------------------------------
+
+#define STACK_ALIGN 16
+
+// the fiber runs pooled_main, which calls the function it was acquired for
+typedef struct
+{
+  gpr_fiber_t      fiber;
+  gpr_fiber_func_t func;
+  void            *arg;
+} pooled_t;
+
+// a function switches away when its work is done, the fiber is then
+// released. it returns once the fiber is acquired again and resumed, and
+// the next function runs on the same stack
+static void pooled_main(void *arg)
+{
+  pooled_t *pf = (pooled_t*)arg;
+  for (;;) pf->func(pf->arg);
+}
+
+static gpr_fiber_t *create_fiber(gpr_fiber_pool_t *p)
+{
+#if defined(GPR_FIBER_WIN32)
+  // the system allocates the stack of a native fiber
+  pooled_t *pf = (pooled_t*)gpr_allocate(p->allocator, sizeof(pooled_t));
+  gpr_assert_alloc(pf);
+  gpr_fiber_init(&pf->fiber, pooled_main, pf, NULL, p->stack_size);
+#else
+  // the stack follows the fiber in the same block
+  const U32 stack_pos = gpr_next_multiple(sizeof(pooled_t), STACK_ALIGN);
+  pooled_t *pf = (pooled_t*)gpr_allocate_align(p->allocator,
+    stack_pos + p->stack_size, STACK_ALIGN);
+  gpr_assert_alloc(pf);
+  gpr_fiber_init(&pf->fiber, pooled_main, pf, (char*)pf + stack_pos, p->stack_size);
+#endif
+  gpr_array_push_back(gpr_fiber_t*, &p->all, &pf->fiber);
+  return &pf->fiber;
+}
+
+void gpr_fiber_pool_init(gpr_fiber_pool_t *p, U32 stack_size, U32 count,
+                         gpr_allocator_t *a)
+{
+  U32 i;
+  p->allocator  = a;
+  p->stack_size = gpr_next_multiple(stack_size, STACK_ALIGN);
+  gpr_array_init(gpr_fiber_t*, &p->all,      a);
+  gpr_array_init(gpr_fiber_t*, &p->freelist, a);
+
+  gpr_array_reserve(gpr_fiber_t*, &p->all,      count);
+  gpr_array_reserve(gpr_fiber_t*, &p->freelist, count);
+  for (i = 0; i < count; ++i)
+    gpr_array_push_back(gpr_fiber_t*, &p->freelist, create_fiber(p));
+}
+
+void gpr_fiber_pool_destroy(gpr_fiber_pool_t *p)
+{
+  U32 i;
+  for (i = 0; i < gpr_array_size(&p->all); ++i)
+  {
+    gpr_fiber_t *f = gpr_array_item(&p->all, i);
+    gpr_fiber_destroy(f);
+    gpr_deallocate(p->allocator, f);
+  }
+  gpr_array_destroy(&p->all);
+  gpr_array_destroy(&p->freelist);
+}
+
+gpr_fiber_t *gpr_fiber_pool_acquire(gpr_fiber_pool_t *p, gpr_fiber_func_t func,
+                                    void *arg)
+{
+  pooled_t *pf = (pooled_t*)(gpr_array_any(&p->freelist)
+    ? gpr_array_pop_back(&p->freelist)
+    : create_fiber(p));
+
+  pf->func = func;
+  pf->arg  = arg;
+  return &pf->fiber;
+}
+
+void gpr_fiber_pool_release(gpr_fiber_pool_t *p, gpr_fiber_t *f)
+{
+  gpr_array_push_back(gpr_fiber_t*, &p->freelist, f);
+}
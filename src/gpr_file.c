@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include "gpr_file.h"
+
+// ---------------------------------------------------------------
+// Windows
+// ---------------------------------------------------------------
+
+#if defined(_WIN32)
+
+#ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+I32 gpr_file_map_read(gpr_file_map_t *m, const char *path)
+{
+  LARGE_INTEGER size;
+
+  m->data    = NULL;
+  m->size    = 0;
+  m->mapping = NULL;
+  m->file    = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, 
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m->file == INVALID_HANDLE_VALUE) return 0;
+
+  if (GetFileSizeEx(m->file, &size) && size.QuadPart > 0)
+  {
+    m->mapping = CreateFileMappingA(m->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m->mapping)
+      m->data = (char*)MapViewOfFile(m->mapping, FILE_MAP_READ, 0, 0, 0);
+  }
+  if (m->data == NULL)
+  {
+    if (m->mapping) CloseHandle(m->mapping);
+    CloseHandle(m->file);
+    return 0;
+  }
+  m->size = (U64)size.QuadPart;
+  return 1;
+}
+
+static I32 map_view(gpr_file_map_t *m, U64 size)
+{
+  LARGE_INTEGER li;
+
+  li.QuadPart = (LONGLONG)size;
+  m->data     = NULL;
+  m->mapping  = NULL;
+  if (!SetFilePointerEx(m->file, li, NULL, FILE_BEGIN) || !SetEndOfFile(m->file))
+    return 0;
+
+  m->mapping = CreateFileMappingA(m->file, NULL, PAGE_READWRITE, 0, 0, NULL);
+  if (m->mapping == NULL) return 0;
+  m->data = (char*)MapViewOfFile(m->mapping, FILE_MAP_WRITE, 0, 0, 0);
+  if (m->data == NULL)
+  {
+    CloseHandle(m->mapping);
+    m->mapping = NULL;
+    return 0;
+  }
+  m->size = size;
+  return 1;
+}
+
+I32 gpr_file_map_write(gpr_file_map_t *m, const char *path, U64 min_size)
+{
+  LARGE_INTEGER size;
+
+  m->data    = NULL;
+  m->size    = 0;
+  m->mapping = NULL;
+  m->file    = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, 0, NULL, 
+                           OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (m->file == INVALID_HANDLE_VALUE) return 0;
+
+  if (!GetFileSizeEx(m->file, &size) || 
+      !map_view(m, (U64)size.QuadPart > min_size ? (U64)size.QuadPart : min_size))
+  {
+    CloseHandle(m->file);
+    return 0;
+  }
+  return 1;
+}
+
+I32 gpr_file_map_resize(gpr_file_map_t *m, U64 size)
+{
+  UnmapViewOfFile(m->data);
+  CloseHandle(m->mapping);
+  return map_view(m, size);
+}
+
+I32 gpr_file_sync(gpr_file_map_t *m)
+{
+  return FlushViewOfFile(m->data, 0) && FlushFileBuffers(m->file);
+}
+
+void gpr_file_unmap(gpr_file_map_t *m)
+{
+  if (m->data) UnmapViewOfFile(m->data);
+  if (m->mapping) CloseHandle(m->mapping);
+  CloseHandle(m->file);
+  m->data = NULL;
+  m->size = 0;
+}
+
+// ---------------------------------------------------------------
+// POSIX
+// ---------------------------------------------------------------
+
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+I32 gpr_file_map_read(gpr_file_map_t *m, const char *path)
+{
+  struct stat st;
+  void       *p;
+
+  m->data = NULL;
+  m->size = 0;
+  m->fd   = open(path, O_RDONLY);
+  if (m->fd < 0) return 0;
+
+  if (fstat(m->fd, &st) != 0 || st.st_size == 0)
+  {
+    close(m->fd);
+    return 0;
+  }
+  p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, m->fd, 0);
+  if (p == MAP_FAILED)
+  {
+    close(m->fd);
+    return 0;
+  }
+  m->data = (char*)p;
+  m->size = (U64)st.st_size;
+  return 1;
+}
+
+static I32 map_view(gpr_file_map_t *m, U64 size)
+{
+  void *p;
+
+  m->data = NULL;
+  if (ftruncate(m->fd, (off_t)size) != 0) return 0;
+  p = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, m->fd, 0);
+  if (p == MAP_FAILED) return 0;
+  m->data = (char*)p;
+  m->size = size;
+  return 1;
+}
+
+I32 gpr_file_map_write(gpr_file_map_t *m, const char *path, U64 min_size)
+{
+  struct stat st;
+
+  m->data = NULL;
+  m->size = 0;
+  m->fd   = open(path, O_RDWR | O_CREAT, 0644);
+  if (m->fd < 0) return 0;
+
+  if (fstat(m->fd, &st) != 0 || 
+      !map_view(m, (U64)st.st_size > min_size ? (U64)st.st_size : min_size))
+  {
+    close(m->fd);
+    return 0;
+  }
+  return 1;
+}
+
+I32 gpr_file_map_resize(gpr_file_map_t *m, U64 size)
+{
+  munmap(m->data, (size_t)m->size);
+  return map_view(m, size);
+}
+
+I32 gpr_file_sync(gpr_file_map_t *m)
+{
+  return msync(m->data, (size_t)m->size, MS_SYNC) == 0 && fsync(m->fd) == 0;
+}
+
+void gpr_file_unmap(gpr_file_map_t *m)
+{
+  if (m->data) munmap(m->data, (size_t)m->size);
+  close(m->fd);
+  m->data = NULL;
+  m->size = 0;
+}
+
+#endif
+
+I32 gpr_file_write(const char *path, const void *data, U64 size)
+{
+  FILE *f = fopen(path, "wb");
+  I32   res;
+
+  if (f == NULL) return 0;
+  res = fwrite(data, 1, (size_t)size, f) == (size_t)size;
+  return fclose(f) == 0 && res;
+}
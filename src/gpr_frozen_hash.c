@@ -0,0 +1,292 @@
+#include <string.h>
+#include "gpr_frozen_hash.h"
+#include "gpr_memory.h"
+#include "gpr_assert.h"
+
+typedef gpr_frozen_hash_header_t header_t;
+
+// ---------------------------------------------------------------
+// Perfect hash internals
+// ---------------------------------------------------------------
+// Keys are split in buckets of KEYS_PER_BUCKET keys on average. The
+// buckets are placed from the largest to the smallest: each one gets the
+// first displacement (pilot) that sends all its keys to free positions.
+// ---------------------------------------------------------------
+
+#define KEYS_PER_BUCKET 4
+#define MAX_PILOT       (1u << 16) // tries before another seed is used
+#define MAX_SEEDS       16
+
+// positions are drawn from n + n/EXTRA_POSITIONS
+#define EXTRA_POSITIONS 32
+
+static U64 mix(U64 k)
+{
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdull;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ull;
+  k ^= k >> 33;
+  return k;
+}
+
+// maps a 32 bits hash to [0, n) without a division
+static U32 reduce(U32 hash, U32 n)
+{
+  return (U32)(((U64)hash*n) >> 32);
+}
+
+static U32 bucket_of(U64 hash, U32 num_buckets)
+{
+  return reduce((U32)(hash >> 32), num_buckets);
+}
+
+static U32 position_of(U64 hash, U32 pilot, U32 table_size)
+{
+  return reduce((U32)mix(hash ^ (pilot*0x9e3779b97f4a7c15ull)), table_size);
+}
+
+typedef struct
+{
+  const U64 *hashes;
+  U32        num_keys, num_buckets, table_size;
+  U32       *pilots;
+  U32       *order;   // keys sorted by bucket
+  U32       *starts;  // first key of each bucket in order
+  U32       *sorted;  // buckets by decreasing size
+  U32       *pos;
+  U8        *taken;
+} builder_t;
+
+// finds the pilots for the current hashes, returns 0 if a bucket can't be
+// placed
+static I32 place(builder_t *b)
+{
+  const U32 n = b->num_keys, nb = b->num_buckets;
+  U32 i, j, k, max_size = 0;
+
+  memset(b->starts, 0, (nb + 1)*sizeof(U32));
+  for (i = 0; i < n; ++i) ++b->starts[bucket_of(b->hashes[i], nb) + 1];
+  for (i = 0; i < nb; ++i)
+  {
+    if (b->starts[i + 1] > max_size) max_size = b->starts[i + 1];
+    b->starts[i + 1] += b->starts[i];
+  }
+  for (i = 0; i < n; ++i)
+    b->order[b->starts[bucket_of(b->hashes[i], nb)]++] = i;
+  for (i = nb; i > 0; --i) b->starts[i] = b->starts[i - 1];
+  b->starts[0] = 0;
+
+  // counting sort of the buckets by size, pos holds the counts
+  memset(b->pos, 0, (max_size + 2)*sizeof(U32));
+  for (i = 0; i < nb; ++i) ++b->pos[max_size - (b->starts[i + 1] - b->starts[i]) + 1];
+  for (k = 0; k <= max_size; ++k) b->pos[k + 1] += b->pos[k];
+  for (i = 0; i < nb; ++i) 
+    b->sorted[b->pos[max_size - (b->starts[i + 1] - b->starts[i])]++] = i;
+
+  memset(b->taken, 0, b->table_size);
+  for (i = 0; i < nb; ++i)
+  {
+    const U32 *keys = b->order + b->starts[b->sorted[i]];
+    const U32  size = b->starts[b->sorted[i] + 1] - b->starts[b->sorted[i]];
+    U32 pilot;
+
+    for (pilot = 0; pilot < MAX_PILOT; ++pilot)
+    {
+      for (j = 0; j < size; ++j)
+      {
+        b->pos[j] = position_of(b->hashes[keys[j]], pilot, b->table_size);
+        if (b->taken[b->pos[j]]) break;
+        b->taken[b->pos[j]] = 1;
+      }
+      if (j == size) break;
+      while (j-- > 0) b->taken[b->pos[j]] = 0;
+    }
+    if (pilot == MAX_PILOT) return 0;
+    b->pilots[b->sorted[i]] = pilot;
+  }
+  return 1;
+}
+
+static void set_pointers(gpr_frozen_hash_t *fh, const header_t *header)
+{
+  const char *blob = (const char*)header;
+  fh->header      = header;
+  fh->pilots      = (const U32*)(blob + header->pilots_pos);
+  fh->remap       = (const U32*)(blob + header->remap_pos);
+  fh->keys        = (const U64*)(blob + header->keys_pos);
+  fh->values      = blob + header->values_pos;
+  fh->num_keys    = header->num_keys;
+  fh->num_buckets = header->num_buckets;
+  fh->table_size  = header->table_size;
+  fh->value_size  = header->value_size;
+  fh->seed        = header->seed;
+}
+
+static U32 find_position(gpr_frozen_hash_t *fh, U64 hash)
+{
+  const U32 p = position_of(hash, fh->pilots[bucket_of(hash, fh->num_buckets)],
+                            fh->table_size);
+  return p < fh->num_keys ? p : fh->remap[p - fh->num_keys];
+}
+
+// ---------------------------------------------------------------
+// Frozen hash implementation
+// ---------------------------------------------------------------
+
+I32 _gpr_frozen_hash_build(gpr_frozen_hash_t *fh, const U32 s, gpr_hash_t *h,
+                           gpr_allocator_t *a)
+{
+  const U32 n = h->num_values;
+  builder_t b;
+  U64      *hashes;
+  U32       i, j, seed_i;
+  U64       seed = 0;
+  I32       placed = 0;
+
+  fh->header    = NULL;
+  fh->allocator = NULL;
+  fh->map.data  = NULL;
+
+  b.num_keys    = n;
+  b.num_buckets = n/KEYS_PER_BUCKET + 1;
+  b.table_size  = n + n/EXTRA_POSITIONS + 1;
+  b.hashes = hashes = (U64*)gpr_allocate_align(a, n*sizeof(U64) + 8, 8);
+  b.pilots = (U32*)gpr_allocate(a, b.num_buckets*sizeof(U32));
+  b.order  = (U32*)gpr_allocate(a, n*sizeof(U32) + 4);
+  b.starts = (U32*)gpr_allocate(a, (b.num_buckets + 1)*sizeof(U32));
+  b.sorted = (U32*)gpr_allocate(a, b.num_buckets*sizeof(U32));
+  b.pos    = (U32*)gpr_allocate(a, (n + 2)*sizeof(U32));
+  b.taken  = (U8*) gpr_allocate(a, b.table_size);
+
+  for (seed_i = 0; seed_i < MAX_SEEDS && !placed; ++seed_i)
+  {
+    seed = mix(0x9e3779b97f4a7c15ull + seed_i);
+    for (i = 0; i < n; ++i) hashes[i] = mix(gpr_array_item(&h->keys, i) ^ seed);
+    placed = place(&b);
+  }
+
+  if (placed)
+  {
+    // header | pilots | remap | keys | values
+    const U32 num_remap  = b.table_size - n;
+    const U32 pilots_pos = gpr_next_multiple(sizeof(header_t), 8);
+    const U32 remap_pos  = pilots_pos + b.num_buckets*4;
+    const U32 keys_pos   = gpr_next_multiple((remap_pos + num_remap*4), 8);
+    const U32 values_pos = keys_pos + n*sizeof(U64);
+    const U32 size       = gpr_next_multiple((values_pos + n*s), 8);
+    char     *blob       = (char*)gpr_allocate_align(a, size, 8);
+    header_t *header     = (header_t*)blob;
+    U32      *remap      = (U32*)(blob + remap_pos);
+
+    memset(blob, 0, size);
+    header->magic       = GPR_FROZEN_HASH_MAGIC;
+    header->num_keys    = n;
+    header->num_buckets = b.num_buckets;
+    header->table_size  = b.table_size;
+    header->value_size  = s;
+    header->seed        = seed;
+    header->pilots_pos  = pilots_pos;
+    header->remap_pos   = remap_pos;
+    header->keys_pos    = keys_pos;
+    header->values_pos  = values_pos;
+    header->size        = size;
+    memcpy(blob + pilots_pos, b.pilots, b.num_buckets*sizeof(U32));
+
+    // positions past n are sent to the free positions below n
+    for (i = n, j = 0; i < b.table_size; ++i)
+    {
+      if (!b.taken[i]) continue;
+      while (b.taken[j]) ++j;
+      remap[i - n] = j++;
+    }
+
+    set_pointers(fh, header);
+    fh->allocator = a;
+
+    for (i = 0; i < n; ++i)
+    {
+      const U32 p = find_position(fh, hashes[i]);
+      ((U64*)(blob + keys_pos))[p] = gpr_array_item(&h->keys, i);
+      memcpy(blob + values_pos + p*s, h->values.data + i*s, s);
+    }
+  }
+
+  gpr_deallocate(a, hashes);
+  gpr_deallocate(a, b.pilots);
+  gpr_deallocate(a, b.order);
+  gpr_deallocate(a, b.starts);
+  gpr_deallocate(a, b.sorted);
+  gpr_deallocate(a, b.pos);
+  gpr_deallocate(a, b.taken);
+  return placed;
+}
+
+I32 gpr_frozen_hash_load(gpr_frozen_hash_t *fh, const void *blob, U32 size)
+{
+  const header_t *header = (const header_t*)blob;
+  const U32      *remap;
+  U32             i;
+
+  fh->header    = NULL;
+  fh->allocator = NULL;
+  fh->map.data  = NULL;
+
+  if (size < sizeof(header_t) || header->magic != GPR_FROZEN_HASH_MAGIC ||
+      header->size > size || header->num_buckets == 0 ||
+      header->table_size <= header->num_keys ||
+      header->pilots_pos + (U64)header->num_buckets*4 > header->remap_pos ||
+      header->remap_pos + (U64)(header->table_size - header->num_keys)*4 > header->keys_pos ||
+      header->keys_pos + (U64)header->num_keys*8 > header->values_pos ||
+      header->values_pos + (U64)header->num_keys*header->value_size > header->size)
+    return 0;
+
+  // positions past num_keys are remapped below it: a lookup reads the key
+  // at the remapped position. an empty table does no lookup
+  remap = (const U32*)((const char*)blob + header->remap_pos);
+  for (i = 0; header->num_keys > 0 && i < header->table_size - header->num_keys; ++i)
+    if (remap[i] >= header->num_keys) return 0;
+
+  set_pointers(fh, header);
+  return 1;
+}
+
+I32 gpr_frozen_hash_map(gpr_frozen_hash_t *fh, const char *path)
+{
+  gpr_file_map_t map;
+
+  if (!gpr_file_map_read(&map, path)) return 0;
+  if (map.size > 0xffffffffu || !gpr_frozen_hash_load(fh, map.data, (U32)map.size))
+  {
+    gpr_file_unmap(&map);
+    return 0;
+  }
+  fh->map = map;
+  return 1;
+}
+
+I32 gpr_frozen_hash_save(gpr_frozen_hash_t *fh, const char *path)
+{
+  return gpr_file_write(path, fh->header, fh->header->size);
+}
+
+void gpr_frozen_hash_destroy(gpr_frozen_hash_t *fh)
+{
+  if (fh->allocator) gpr_deallocate(fh->allocator, (void*)fh->header);
+  if (fh->map.data)  gpr_file_unmap(&fh->map);
+}
+
+const void *_gpr_frozen_hash_get(gpr_frozen_hash_t *fh, U64 key)
+{
+  U32 p;
+
+  if (fh->num_keys == 0) return NULL;
+
+  p = find_position(fh, mix(key ^ fh->seed));
+  return fh->keys[p] == key ? fh->values + p*fh->value_size : NULL;
+}
+
+I32 _gpr_frozen_hash_has(gpr_frozen_hash_t *fh, U64 key)
+{
+  return _gpr_frozen_hash_get(fh, key) != NULL;
+}
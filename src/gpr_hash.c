@@ -1,320 +1,717 @@
-#include "gpr_types.h"
-#include "gpr_array.h"
-#include "gpr_memory.h"
-#include "gpr_hash.h"
-#include "gpr_buffer.h"
-
-// ---------------------------------------------------------------
-// Hash internals
-// ---------------------------------------------------------------
-
-#define END_OF_LIST     0xffffffffu
-#define MAX_LOAD_FACTOR 0.7f
-
-typedef gpr_hash_index_t index_t;
-
-typedef struct
-{
-  U32 hash_i;
-  U32 index_prev;
-  U32 index_i;
-} find_result_t;
-
-static I32 full(gpr_hash_t *h)
-{
-  return h->num_values >= (U32)(gpr_array_size(&h->buckets)*MAX_LOAD_FACTOR);
-}
-
-static void find_index(gpr_hash_t *h, U64 key, find_result_t *fr)
-{
-  fr->hash_i     = END_OF_LIST;
-  fr->index_prev = END_OF_LIST;
-  fr->index_i    = END_OF_LIST;
-
-  if (gpr_array_size(&h->buckets) == 0) return;
-
-  fr->hash_i  = key % gpr_array_size(&h->buckets);
-  fr->index_i = gpr_array_item(&h->buckets, fr->hash_i);
-
-  while (fr->index_i != END_OF_LIST)
-  {
-    if (gpr_array_item(&h->indices, fr->index_i).key == key) return;
-    fr->index_prev = fr->index_i;
-    fr->index_i = gpr_array_item(&h->indices, fr->index_i).next;
-  }
-}
-
-static U32 make_index(gpr_hash_t *h, U64 key, U32 value_pos)
-{
-  find_result_t fr;
-  index_t       index;
-  const U32 i = gpr_array_size(&h->indices);
-
-  index.key       = key;
-  index.next      = END_OF_LIST;
-  index.value_pos = value_pos;
-
-  find_index(h, key, &fr);
-
-  gpr_array_push_back(index_t, &h->indices, index);
-
-  if (fr.index_prev == END_OF_LIST)
-    gpr_array_item(&h->buckets, fr.hash_i) = i;
-  else
-    gpr_array_item(&h->indices, fr.index_prev).next = i;
-
-  gpr_array_item(&h->indices, i).next = fr.index_i;
-  return i;
-}
-
-static U32 find_or_make_index(gpr_hash_t *h, U64 key)
-{
-  find_result_t fr;
-  find_index(h, key, &fr);
-  if (fr.index_i != END_OF_LIST) 
-    return fr.index_i;
-  {
-    index_t       index;
-    const U32 i = gpr_array_size(&h->indices);
-    index.key     = key;
-    index.next    = END_OF_LIST;
-    index.value_pos = END_OF_LIST;
-
-    gpr_array_push_back(index_t, &h->indices, index);
-
-    if (fr.index_prev == END_OF_LIST)
-      gpr_array_item(&h->buckets, fr.hash_i) = i;
-    else
-      gpr_array_item(&h->indices, fr.index_prev).next = i;
-    return i;
-  }
-}
-
-static void erase(gpr_hash_t *h, const U32 s, find_result_t *fr)
-{
-  index_t      *index     = &gpr_array_item(&h->indices, fr->index_i);
-  const U32     value_pos = index->value_pos;
-  const U32     value_i   = value_pos/s;
-  find_result_t last;
-
-  if (fr->index_prev == END_OF_LIST)
-    gpr_array_item(&h->buckets, fr->hash_i) = index->next;
-  else
-    gpr_array_item(&h->indices, fr->index_prev).next = index->next;
-
-  // remove from indices
-  if (fr->index_i == --h->num_values)
-  {
-    gpr_array_pop_back(&h->indices);
-  }
-  else
-  {
-    *index = gpr_array_pop_back(&h->indices);
-    find_index(h, index->key, &last);
-
-    if (fr->index_prev == END_OF_LIST)
-      gpr_array_item(&h->buckets, fr->hash_i) = fr->index_i;
-    else
-      gpr_array_item(&h->indices, fr->index_prev).next = fr->index_i;
-  }
-
-  // remove values & keys
-  if(value_pos/s == h->num_values)
-  {
-    gpr_array_pop_back(&h->keys);
-  }
-  else
-  {
-    gpr_array_item(&h->keys, value_i) = gpr_array_pop_back(&h->keys);
-    memcpy(h->values.data + value_pos, 
-      h->values.data + h->num_values*s, s);
-
-    find_index(h, gpr_array_item(&h->keys, value_i), &last);
-    gpr_array_item(&h->indices, last.index_i).value_pos = value_pos;
-  }
-  gpr_buffer_resize(&h->values, h->num_values*s);
-}
-
-static void rehash(gpr_hash_t *h, const U32 s, U32 size)
-{
-  U32 i;
-  gpr_array_t(index_t) tmp_indices;
-  gpr_array_init(index_t, &tmp_indices, h->indices.allocator);
-  gpr_array_copy(index_t, &tmp_indices, &h->indices);
-
-  gpr_array_resize(U32, &h->buckets, size);
-  for (i = 0; i < gpr_array_size(&h->buckets); ++i)
-    gpr_array_item(&h->buckets, i) = END_OF_LIST;
-
-  gpr_array_resize (index_t, &h->indices, 0);
-  gpr_array_reserve(index_t, &h->indices, (U32)(size*MAX_LOAD_FACTOR)+1);
-  for (i=0; i < gpr_array_size(&tmp_indices); ++i)
-  {
-    index_t *index = &gpr_array_item(&tmp_indices, i);
-    make_index(h, index->key, index->value_pos);
-  }
-  gpr_array_destroy(&tmp_indices);
-  gpr_array_reserve(U64, &h->keys, gpr_array_capacity(&h->indices));
-  gpr_buffer_reserve(&h->values, gpr_array_capacity(&h->indices)*s);
-}
-
-static void grow(gpr_hash_t *h, const U32 s)
-{
-  rehash(h, s, gpr_array_size(&h->buckets) << 1);
-}
-
-// ---------------------------------------------------------------
-// Hash implementation
-// ---------------------------------------------------------------
-
-void _gpr_hash_init(gpr_hash_t *h, const U32 s, gpr_allocator_t *a)
-{
-  gpr_array_init(U32,     &h->buckets, a);
-  gpr_array_init(index_t, &h->indices, a);
-  gpr_array_init(U64,     &h->keys,    a);
-  gpr_buffer_init(&h->values, a);
-  h->num_values = 0;
-}
-
-void _gpr_hash_destroy(gpr_hash_t *h)
-{
-  gpr_array_destroy(&h->buckets);
-  gpr_array_destroy(&h->indices);
-  gpr_array_destroy(&h->keys);
-  gpr_buffer_destroy(&h->values);
-}
-
-I32 _gpr_hash_has(gpr_hash_t *h, U64 key)
-{
-  find_result_t fr;
-  find_index(h, key, &fr);
-  return fr.index_i != END_OF_LIST;
-}
-
-void *_gpr_hash_get(gpr_hash_t *h, U64 key)
-{
-  find_result_t fr;
-  find_index(h, key, &fr);
-  return (fr.index_i == END_OF_LIST) ? NULL : 
-    h->values.data + (gpr_array_item(&h->indices, fr.index_i).value_pos);
-}
-
-void _gpr_hash_set(gpr_hash_t *h, const U32 s, U64 key, const void *value)
-{
-  index_t *index;
-
-  if(gpr_array_size(&h->buckets) == 0)
-    rehash(h, s, 4);
-
-  index = &gpr_array_item(&h->indices, find_or_make_index(h, key));
-
-  if(index->value_pos == END_OF_LIST)
-  {
-    // create a new value
-    index->value_pos = gpr_buffer_ncat(&h->values, (char*)value, s);
-    gpr_array_push_back(U64, &h->keys, key);
-    ++h->num_values;
-  } else {
-    // change an existing value 
-    memcpy(h->values.data + index->value_pos, value, s);
-  }
-
-  if (full(h)) grow(h, s);
-}
-
-void _gpr_hash_remove(gpr_hash_t *h, const U32 s, U64 key)
-{
-  find_result_t fr;
-  find_index(h, key, &fr);
-  if (fr.index_i != END_OF_LIST)
-    erase(h, s, &fr);
-}
-
-void _gpr_hash_reserve(gpr_hash_t *h, const U32 s, U32 capacity)
-{
-  rehash(h, s, gpr_next_pow2_U32(capacity));
-}
-
-void *_gpr_hash_begin(gpr_hash_t *h)
-{
-  return h->values.data;
-}
-
-void *_gpr_hash_end(gpr_hash_t *h, const U32 s)
-{
-  return h->values.data + (h->num_values*s);
-}
-
-// ---------------------------------------------------------------
-// Multi Hash implementation
-// ---------------------------------------------------------------
-
-void *_gpr_multi_hash_find_first(gpr_hash_t *h, gpr_hash_it *it, U64 key)
-{
-  find_result_t fr;
-  find_index(h, key, &fr);
-
-  if (it != NULL) 
-  {
-      it->key  = key;
-      it->next = (fr.index_i == END_OF_LIST) ? END_OF_LIST : 
-        gpr_array_item(&h->indices, fr.index_i).next;
-  }
-  if (fr.index_i == END_OF_LIST) return NULL;
-
-  return h->values.data + gpr_array_item(&h->indices, fr.index_i).value_pos;
-}
-
-void *_gpr_multi_hash_find_next(gpr_hash_t *h, gpr_hash_it *it)
-{
-  U32 i = it->next;
-  while (i != END_OF_LIST) 
-  {
-    if (gpr_array_item(&h->indices, i).key == it->key)
-    {
-      it->next = gpr_array_item(&h->indices, i).next;
-      return h->values.data + gpr_array_item(&h->indices, i).value_pos;
-    }
-    i = gpr_array_item(&h->indices, i).next;
-  }
-  it->next = END_OF_LIST;
-  return NULL;
-}
-
-U32 _gpr_multi_hash_count(gpr_hash_t *h, U64 key)
-{
-  U32 i = 0;
-  gpr_hash_it it;
-  void *e = _gpr_multi_hash_find_first(h, &it, key);
-  while (e) {
-    ++i;
-    e = _gpr_multi_hash_find_next(h, &it);
-  }
-  return i;
-}
-
-void _gpr_multi_hash_insert(gpr_hash_t *h, const U32 s, U64 key, const void *value)
-{
-  if (gpr_array_size(&h->buckets) == 0)
-    rehash(h, s, 4);
-
-  gpr_array_push_back(U64, &h->keys, key);
-  make_index(h, key,  gpr_buffer_ncat(&h->values, (char*)value, s));
-
-  ++h->num_values;
-
-  if (full(h)) grow(h, s);
-}
-
-void _gpr_multi_hash_remove(gpr_hash_t *h, const U32 s, void *e)
-{
-  find_result_t fr;
-  find_index(h, gpr_array_item(&h->keys, ((char*)e - h->values.data)/s), &fr);
-  if (fr.index_i != END_OF_LIST) erase(h, s, &fr);
-}
-
-void  _gpr_multi_hash_remove_all (gpr_hash_t *h, const U32 s, U64 key)
-{
-  while (_gpr_hash_has(h, key))
-    _gpr_hash_remove(h, s, key);
-}
\ No newline at end of file
+#include "gpr_types.h"
+#include "gpr_array.h"
+#include "gpr_memory.h"
+#include "gpr_hash.h"
+#include "gpr_buffer.h"
+#include "gpr_assert.h"
+#include "gpr_sort.h"
+#include "gpr_atomic.h"
+
+// chained backend, see gpr_hash_swiss.c for the open addressing one
+#ifndef GPR_HASH_SWISS
+
+// ---------------------------------------------------------------
+// Hash internals
+// ---------------------------------------------------------------
+
+#define END_OF_LIST     0xffffffffu
+#define MAX_LOAD_FACTOR GPR_HASH_MAX_LOAD_FACTOR
+
+// lookups run concurrently on shared tables (concurrent hash, string pool,
+// RCU snapshots): the probes are counted locally and added atomically
+// once per lookup
+#ifdef GPR_HASH_STATS
+  #define count_lookup(h, probes)               \
+    (gpr_atomic_add_U64(&(h)->num_lookups, 1),  \
+     gpr_atomic_add_U64(&(h)->num_probes, probes))
+#else
+  #define count_lookup(h, probes) ((void)(probes))
+#endif
+
+typedef gpr_hash_index_t index_t;
+
+typedef struct
+{
+  U32 *bucket;
+  U32  index_prev;
+  U32  index_i;
+} find_result_t;
+
+static I32 full(gpr_hash_t *h)
+{
+  return h->num_values >= (U32)(gpr_array_size(&h->buckets)*MAX_LOAD_FACTOR);
+}
+
+static I32 migrating(gpr_hash_t *h)
+{
+  return gpr_array_any(&h->old_buckets);
+}
+
+// a key stays in the old buckets until its bucket is migrated
+static U32 *find_bucket(gpr_hash_t *h, U64 key)
+{
+  if (migrating(h))
+  {
+    const U32 i = key % gpr_array_size(&h->old_buckets);
+    if (i >= h->migrate_pos) return &gpr_array_item(&h->old_buckets, i);
+  }
+  return &gpr_array_item(&h->buckets, key % gpr_array_size(&h->buckets));
+}
+
+static void find_index(gpr_hash_t *h, U64 key, find_result_t *fr)
+{
+  U32 probes = 0;
+
+  fr->bucket     = NULL;
+  fr->index_prev = END_OF_LIST;
+  fr->index_i    = END_OF_LIST;
+
+  if (gpr_array_size(&h->buckets) == 0) return;
+
+  fr->bucket  = find_bucket(h, key);
+  fr->index_i = *fr->bucket;
+
+  while (fr->index_i != END_OF_LIST)
+  {
+    ++probes;
+    if (gpr_array_item(&h->indices, fr->index_i).key == key) break;
+    fr->index_prev = fr->index_i;
+    fr->index_i = gpr_array_item(&h->indices, fr->index_i).next;
+  }
+  count_lookup(h, probes);
+}
+
+// makes the link found by find_index point to i
+static void link_index(gpr_hash_t *h, find_result_t *fr, U32 i)
+{
+  if (fr->index_prev == END_OF_LIST)
+    *fr->bucket = i;
+  else
+    gpr_array_item(&h->indices, fr->index_prev).next = i;
+}
+
+static U32 make_index(gpr_hash_t *h, U64 key, U32 value_pos)
+{
+  find_result_t fr;
+  index_t       index;
+  const U32 i = gpr_array_size(&h->indices);
+
+  find_index(h, key, &fr);
+
+  index.key       = key;
+  index.next      = fr.index_i;
+  index.value_pos = value_pos;
+  gpr_array_push_back(index_t, &h->indices, index);
+  link_index(h, &fr, i);
+  return i;
+}
+
+static void erase(gpr_hash_t *h, const U32 s, find_result_t *fr)
+{
+  const U32 value_pos = gpr_array_item(&h->indices, fr->index_i).value_pos;
+  U32       last_pos, i;
+
+  link_index(h, fr, gpr_array_item(&h->indices, fr->index_i).next);
+  --h->num_values;
+
+  // move the last index in the hole and relink it
+  if (fr->index_i != h->num_values)
+  {
+    U32 *link = find_bucket(h, gpr_array_back(&h->indices).key);
+    while (*link != h->num_values) 
+      link = &gpr_array_item(&h->indices, *link).next;
+    *link = fr->index_i;
+    gpr_array_item(&h->indices, fr->index_i) = gpr_array_back(&h->indices);
+  }
+  gpr_array_pop_back(&h->indices);
+
+  // move the last value & key in the hole
+  last_pos = h->num_values*s;
+  if (value_pos != last_pos)
+  {
+    const U64 key = gpr_array_back(&h->keys);
+    gpr_array_item(&h->keys, value_pos/s) = key;
+    memcpy(h->values.data + value_pos, h->values.data + last_pos, s);
+
+    i = *find_bucket(h, key);
+    while (gpr_array_item(&h->indices, i).value_pos != last_pos)
+      i = gpr_array_item(&h->indices, i).next;
+    gpr_array_item(&h->indices, i).value_pos = value_pos;
+  }
+  gpr_array_pop_back(&h->keys);
+  gpr_buffer_resize(&h->values, last_pos);
+}
+
+static void end_migration(gpr_hash_t *h)
+{
+  gpr_allocator_t *a = h->old_buckets.allocator;
+  gpr_array_destroy(&h->old_buckets);
+  gpr_array_init(U32, &h->old_buckets, a);
+  h->migrate_pos = 0;
+}
+
+// moves the chains of count old buckets to the new ones. the keys of old
+// bucket j go to the new buckets j and j + num_old, which are cleared
+// only then: lookups never reach a new bucket before its old one is
+// migrated
+static void migrate(gpr_hash_t *h, U32 count)
+{
+  const U32 num_old     = gpr_array_size(&h->old_buckets);
+  const U32 num_buckets = gpr_array_size(&h->buckets);
+
+  if (!migrating(h)) return;
+
+  for (; count > 0 && h->migrate_pos < num_old; --count)
+  {
+    U32 i = gpr_array_item(&h->old_buckets, h->migrate_pos);
+    gpr_array_item(&h->buckets, h->migrate_pos)           = END_OF_LIST;
+    gpr_array_item(&h->buckets, h->migrate_pos + num_old) = END_OF_LIST;
+    ++h->migrate_pos;
+    while (i != END_OF_LIST)
+    {
+      index_t  *index  = &gpr_array_item(&h->indices, i);
+      U32      *bucket = &gpr_array_item(&h->buckets, index->key % num_buckets);
+      const U32 next   = index->next;
+      index->next = *bucket;
+      *bucket = i;
+      i = next;
+    }
+  }
+  if (h->migrate_pos == num_old) end_migration(h);
+}
+
+// smallest number of buckets holding n values
+static U32 num_buckets_for(U32 n)
+{
+  const U32 size = gpr_next_pow2_U32((U32)(n/MAX_LOAD_FACTOR) + 1);
+  return size < 4 ? 4 : size;
+}
+
+static U32 num_entries_for(U32 num_buckets)
+{
+  return (U32)(num_buckets*MAX_LOAD_FACTOR)+1;
+}
+
+static void reserve_entries(gpr_hash_t *h, const U32 s)
+{
+  const U32 size = num_entries_for(gpr_array_size(&h->buckets));
+  gpr_array_reserve(index_t, &h->indices, size);
+  gpr_array_reserve(U64, &h->keys, gpr_array_capacity(&h->indices));
+  gpr_buffer_reserve(&h->values, gpr_array_capacity(&h->indices)*s);
+}
+
+// rebuilds every chain at once
+static void rehash(gpr_hash_t *h, const U32 s, U32 size)
+{
+  U32 i;
+
+  if (migrating(h)) end_migration(h);
+  ++h->num_rehashes;
+
+  gpr_array_resize(U32, &h->buckets, size);
+  for (i = 0; i < size; ++i)
+    gpr_array_item(&h->buckets, i) = END_OF_LIST;
+
+  for (i = 0; i < gpr_array_size(&h->indices); ++i)
+  {
+    index_t *index  = &gpr_array_item(&h->indices, i);
+    U32     *bucket = &gpr_array_item(&h->buckets, index->key % size);
+    index->next = *bucket;
+    *bucket = i;
+  }
+  reserve_entries(h, s);
+}
+
+// doubles the buckets, the chains are migrated by the next operations
+static void grow(gpr_hash_t *h, const U32 s)
+{
+  const U32 size = gpr_array_size(&h->buckets) << 1;
+  U32      *data;
+  U32       capacity;
+
+  // a previous migration must be over
+  migrate(h, END_OF_LIST);
+  ++h->num_rehashes;
+
+  // the current buckets become the old ones
+  data     = h->old_buckets.data;
+  capacity = h->old_buckets.capacity;
+  h->old_buckets.data     = h->buckets.data;
+  h->old_buckets.size     = h->buckets.size;
+  h->old_buckets.capacity = h->buckets.capacity;
+  h->buckets.data         = data;
+  h->buckets.size         = 0;
+  h->buckets.capacity     = capacity;
+  h->migrate_pos          = 0;
+
+  // left uninitialized, see migrate
+  gpr_array_resize(U32, &h->buckets, size);
+  reserve_entries(h, s);
+}
+
+// called after each insertion
+static void step(gpr_hash_t *h, const U32 s)
+{
+  if (full(h)) grow(h, s);
+  else migrate(h, GPR_HASH_MIGRATE_BUCKETS);
+}
+
+// called after each removal
+static void step_remove(gpr_hash_t *h, const U32 s)
+{
+  const U32 size = gpr_array_size(&h->buckets);
+  if (GPR_HASH_SHRINK_LOAD_FACTOR > 0.0f && size > 4 &&
+      h->num_values < (U32)(size*GPR_HASH_SHRINK_LOAD_FACTOR))
+    _gpr_hash_shrink_to_fit(h, s);
+  else 
+    migrate(h, GPR_HASH_MIGRATE_BUCKETS);
+}
+
+// ---------------------------------------------------------------
+// Hash implementation
+// ---------------------------------------------------------------
+
+void _gpr_hash_init(gpr_hash_t *h, const U32 s, gpr_allocator_t *a)
+{
+  gpr_array_init(U32,     &h->buckets,     a);
+  gpr_array_init(U32,     &h->old_buckets, a);
+  gpr_array_init(index_t, &h->indices,     a);
+  gpr_array_init(U64,     &h->keys,        a);
+  gpr_buffer_init(&h->values, a);
+  h->num_values   = 0;
+  h->migrate_pos  = 0;
+  h->num_rehashes = 0;
+#ifdef GPR_HASH_STATS
+  h->num_lookups  = 0;
+  h->num_probes   = 0;
+#endif
+}
+
+void _gpr_hash_destroy(gpr_hash_t *h)
+{
+  gpr_array_destroy(&h->buckets);
+  gpr_array_destroy(&h->old_buckets);
+  gpr_array_destroy(&h->indices);
+  gpr_array_destroy(&h->keys);
+  gpr_buffer_destroy(&h->values);
+}
+
+I32 _gpr_hash_has(gpr_hash_t *h, U64 key)
+{
+  find_result_t fr;
+  find_index(h, key, &fr);
+  return fr.index_i != END_OF_LIST;
+}
+
+void *_gpr_hash_get(gpr_hash_t *h, U64 key)
+{
+  find_result_t fr;
+  find_index(h, key, &fr);
+  return (fr.index_i == END_OF_LIST) ? NULL : 
+    h->values.data + (gpr_array_item(&h->indices, fr.index_i).value_pos);
+}
+
+void _gpr_hash_set(gpr_hash_t *h, const U32 s, U64 key, const void *value)
+{
+  find_result_t fr;
+  index_t       index;
+
+  if(gpr_array_size(&h->buckets) == 0)
+    rehash(h, s, 4);
+
+  find_index(h, key, &fr);
+  if (fr.index_i != END_OF_LIST)
+  {
+    // change an existing value 
+    memcpy(h->values.data + gpr_array_item(&h->indices, fr.index_i).value_pos, 
+      value, s);
+    return;
+  }
+
+  // create a new value
+  index.key       = key;
+  index.next      = END_OF_LIST;
+  index.value_pos = gpr_buffer_ncat(&h->values, (char*)value, s);
+  link_index(h, &fr, gpr_array_size(&h->indices));
+  gpr_array_push_back(index_t, &h->indices, index);
+  gpr_array_push_back(U64, &h->keys, key);
+  ++h->num_values;
+
+  step(h, s);
+}
+
+void _gpr_hash_remove(gpr_hash_t *h, const U32 s, U64 key)
+{
+  find_result_t fr;
+  find_index(h, key, &fr);
+  if (fr.index_i == END_OF_LIST) return;
+  erase(h, s, &fr);
+  step_remove(h, s);
+}
+
+void _gpr_hash_reserve(gpr_hash_t *h, const U32 s, U32 capacity)
+{
+  rehash(h, s, gpr_next_pow2_U32(capacity));
+}
+
+void _gpr_hash_shrink_to_fit(gpr_hash_t *h, const U32 s)
+{
+  U32 size, entries;
+
+  if (gpr_array_size(&h->buckets) == 0) return;
+
+  // the rehash also releases the old buckets of a migration
+  size = num_buckets_for(h->num_values);
+  if (size < gpr_array_size(&h->buckets)) rehash(h, s, size);
+  else
+  {
+    size = gpr_array_size(&h->buckets);
+    migrate(h, END_OF_LIST);
+  }
+
+  entries = num_entries_for(size);
+  gpr_array_shrink(U32,     &h->buckets, size);
+  gpr_array_shrink(index_t, &h->indices, entries);
+  gpr_array_shrink(U64,     &h->keys,    entries);
+  gpr_buffer_shrink(&h->values, entries*s);
+}
+
+void *_gpr_hash_begin(gpr_hash_t *h)
+{
+  return h->values.data;
+}
+
+void *_gpr_hash_end(gpr_hash_t *h, const U32 s)
+{
+  return h->values.data + (h->num_values*s);
+}
+
+// the indices are partitioned by bucket with a counting sort: each chain
+// is a run of consecutive indices
+void _gpr_hash_build(gpr_hash_t *h, const U32 s, const U64 *keys, 
+                     const void *values, U32 n)
+{
+  U32 size, mask, i, begin, end;
+
+  gpr_assert_msg(h->num_values == 0, "the hash must be empty");
+  if (migrating(h)) end_migration(h);
+
+  size = num_buckets_for(n);
+  mask = size - 1;
+
+  // count the keys of each bucket, then turn the counts into run offsets
+  gpr_array_resize(U32, &h->buckets, size);
+  memset(h->buckets.data, 0, size*sizeof(U32));
+  for (i = 0; i < n; ++i)
+    ++gpr_array_item(&h->buckets, keys[i] & mask);
+  for (i = 0, begin = 0; i < size; ++i)
+  {
+    end = begin + gpr_array_item(&h->buckets, i);
+    gpr_array_item(&h->buckets, i) = begin;
+    begin = end;
+  }
+
+  // after the scatter, each offset is the end of its run
+  gpr_array_resize(index_t, &h->indices, n);
+  for (i = 0; i < n; ++i)
+  {
+    index_t *index = &gpr_array_item(&h->indices, 
+      gpr_array_item(&h->buckets, keys[i] & mask)++);
+    index->key       = keys[i];
+    index->value_pos = i*s;
+  }
+
+  // link the runs
+  for (i = 0, begin = 0; i < size; ++i)
+  {
+    end = gpr_array_item(&h->buckets, i);
+    if (begin == end)
+    {
+      gpr_array_item(&h->buckets, i) = END_OF_LIST;
+      continue;
+    }
+    gpr_array_item(&h->buckets, i) = begin;
+    for (; begin < end - 1; ++begin)
+      gpr_array_item(&h->indices, begin).next = begin + 1;
+    gpr_array_item(&h->indices, begin++).next = END_OF_LIST;
+  }
+
+  gpr_array_resize(U64, &h->keys, n);
+  memcpy(h->keys.data, keys, n*sizeof(U64));
+  gpr_buffer_resize(&h->values, n*s);
+  memcpy(h->values.data, values, n*s);
+  h->num_values = n;
+  reserve_entries(h, s);
+}
+
+// lookups are done in stages over a batch of keys: the buckets, then the
+// first index of each chain, then the values are prefetched for the whole
+// batch before they are read
+#define BATCH 16
+
+static void find_many(gpr_hash_t *h, const U64 *keys, U32 n, void **out,
+                      I32 prefetch_values)
+{
+  U32 *bucket[BATCH];
+  U32  i, k, probes;
+
+  if (gpr_array_size(&h->buckets) == 0)
+  {
+    for (i = 0; i < n; ++i) out[i] = NULL;
+    return;
+  }
+
+  for (i = 0; i < n; ++i)
+  {
+    bucket[i] = find_bucket(h, keys[i]);
+    gpr_prefetch(bucket[i]);
+  }
+  for (i = 0; i < n; ++i)
+  {
+    k = *bucket[i];
+    if (k != END_OF_LIST) gpr_prefetch(&gpr_array_item(&h->indices, k));
+  }
+  for (i = 0; i < n; ++i)
+  {
+    probes = 0;
+    for (k = *bucket[i]; k != END_OF_LIST; k = gpr_array_item(&h->indices, k).next)
+    {
+      ++probes;
+      if (gpr_array_item(&h->indices, k).key == keys[i]) break;
+    }
+    count_lookup(h, probes);
+
+    if (k == END_OF_LIST) 
+    {
+      out[i] = NULL;
+      continue;
+    }
+    out[i] = h->values.data + gpr_array_item(&h->indices, k).value_pos;
+    if (prefetch_values) gpr_prefetch(out[i]);
+  }
+}
+
+void _gpr_hash_get_many(gpr_hash_t *h, const U64 *keys, U32 n, void **out)
+{
+  U32 i;
+  for (i = 0; i < n; i += BATCH)
+    find_many(h, keys + i, n - i < BATCH ? n - i : BATCH, out + i, 1);
+}
+
+void _gpr_hash_has_many(gpr_hash_t *h, const U64 *keys, U32 n, I32 *out)
+{
+  void *values[BATCH];
+  U32   i, j, m;
+  for (i = 0; i < n; i += m)
+  {
+    m = n - i < BATCH ? n - i : BATCH;
+    find_many(h, keys + i, m, values, 0);
+    for (j = 0; j < m; ++j) out[i + j] = values[j] != NULL;
+  }
+}
+
+static void chain_stats(gpr_hash_t *h, U32 head, gpr_hash_stats_t *stats)
+{
+  U32 n = 0;
+  for (; head != END_OF_LIST; head = gpr_array_item(&h->indices, head).next) ++n;
+  ++stats->histogram[n < GPR_HASH_STATS_HISTOGRAM ? n : GPR_HASH_STATS_HISTOGRAM - 1];
+  if (n > stats->max_probe) stats->max_probe = n;
+}
+
+void gpr_hash_stats(gpr_hash_t *h, gpr_hash_stats_t *stats)
+{
+  U32 i;
+
+  memset(stats, 0, sizeof(gpr_hash_stats_t));
+  stats->num_values   = h->num_values;
+  stats->num_buckets  = gpr_array_size(&h->buckets);
+  stats->load_factor  = stats->num_buckets ? 
+    (F32)h->num_values/stats->num_buckets : 0.0f;
+  stats->num_rehashes = h->num_rehashes;
+
+  // chains not migrated yet are still in the old buckets, the new buckets
+  // they go to are not set yet
+  if (migrating(h))
+  {
+    const U32 num_old = gpr_array_size(&h->old_buckets);
+    for (i = 0; i < h->migrate_pos; ++i)
+    {
+      chain_stats(h, gpr_array_item(&h->buckets, i), stats);
+      chain_stats(h, gpr_array_item(&h->buckets, i + num_old), stats);
+    }
+    for (i = h->migrate_pos; i < num_old; ++i)
+      chain_stats(h, gpr_array_item(&h->old_buckets, i), stats);
+  }
+  else
+  {
+    for (i = 0; i < gpr_array_size(&h->buckets); ++i)
+      chain_stats(h, gpr_array_item(&h->buckets, i), stats);
+  }
+
+  stats->bytes_buckets = (gpr_array_capacity(&h->buckets) + 
+    gpr_array_capacity(&h->old_buckets))*sizeof(U32);
+  stats->bytes_indices = gpr_array_capacity(&h->indices)*sizeof(index_t);
+  stats->bytes_keys    = gpr_array_capacity(&h->keys)*sizeof(U64);
+  stats->bytes_values  = h->values.capacity;
+
+#ifdef GPR_HASH_STATS
+  stats->num_lookups = gpr_atomic_load_U64(&h->num_lookups);
+  stats->avg_probes  = stats->num_lookups ? 
+    (F32)gpr_atomic_load_U64(&h->num_probes)/stats->num_lookups : 0.0f;
+#endif
+}
+
+// ---------------------------------------------------------------
+// Multi Hash implementation
+// ---------------------------------------------------------------
+
+void *_gpr_multi_hash_find_first(gpr_hash_t *h, gpr_hash_it *it, U64 key)
+{
+  find_result_t fr;
+  find_index(h, key, &fr);
+
+  if (it != NULL) 
+  {
+      it->key  = key;
+      it->next = (fr.index_i == END_OF_LIST) ? END_OF_LIST : 
+        gpr_array_item(&h->indices, fr.index_i).next;
+  }
+  if (fr.index_i == END_OF_LIST) return NULL;
+
+  return h->values.data + gpr_array_item(&h->indices, fr.index_i).value_pos;
+}
+
+void *_gpr_multi_hash_find_next(gpr_hash_t *h, gpr_hash_it *it)
+{
+  U32 i = it->next;
+  while (i != END_OF_LIST) 
+  {
+    if (gpr_array_item(&h->indices, i).key == it->key)
+    {
+      it->next = gpr_array_item(&h->indices, i).next;
+      return h->values.data + gpr_array_item(&h->indices, i).value_pos;
+    }
+    i = gpr_array_item(&h->indices, i).next;
+  }
+  it->next = END_OF_LIST;
+  return NULL;
+}
+
+U32 _gpr_multi_hash_count(gpr_hash_t *h, U64 key)
+{
+  U32 i = 0;
+  gpr_hash_it it;
+  void *e = _gpr_multi_hash_find_first(h, &it, key);
+  while (e) {
+    ++i;
+    e = _gpr_multi_hash_find_next(h, &it);
+  }
+  return i;
+}
+
+void _gpr_multi_hash_insert(gpr_hash_t *h, const U32 s, U64 key, const void *value)
+{
+  if (gpr_array_size(&h->buckets) == 0)
+    rehash(h, s, 4);
+
+  gpr_array_push_back(U64, &h->keys, key);
+  make_index(h, key,  gpr_buffer_ncat(&h->values, (char*)value, s));
+
+  ++h->num_values;
+
+  step(h, s);
+}
+
+void _gpr_multi_hash_remove(gpr_hash_t *h, const U32 s, void *e)
+{
+  const U32     value_pos = (U32)((char*)e - h->values.data);
+  find_result_t fr;
+
+  // several indices share the key: look for the one of this value
+  fr.bucket     = find_bucket(h, gpr_array_item(&h->keys, value_pos/s));
+  fr.index_prev = END_OF_LIST;
+  fr.index_i    = *fr.bucket;
+  while (fr.index_i != END_OF_LIST &&
+         gpr_array_item(&h->indices, fr.index_i).value_pos != value_pos)
+  {
+    fr.index_prev = fr.index_i;
+    fr.index_i = gpr_array_item(&h->indices, fr.index_i).next;
+  }
+  if (fr.index_i == END_OF_LIST) return;
+  erase(h, s, &fr);
+  step_remove(h, s);
+}
+
+#define greater(a, b) ((a) > (b))
+
+void  _gpr_multi_hash_remove_all (gpr_hash_t *h, const U32 s, U64 key)
+{
+  find_result_t fr;
+  gpr_array_t(U32) holes; // removed indices, then their values
+  U32 i, j, n, last;
+
+  find_index(h, key, &fr);
+  if (fr.index_i == END_OF_LIST) return;
+
+  // unlink all the indices of the key in one walk of the chain
+  gpr_array_init(U32, &holes, h->keys.allocator);
+  while (fr.index_i != END_OF_LIST)
+  {
+    const U32 next = gpr_array_item(&h->indices, fr.index_i).next;
+    if (gpr_array_item(&h->indices, fr.index_i).key == key)
+    {
+      gpr_array_push_back(U32, &holes, fr.index_i);
+      link_index(h, &fr, next);
+    }
+    else fr.index_prev = fr.index_i;
+    fr.index_i = next;
+  }
+  n = gpr_array_size(&holes);
+  for (i = 0; i < n; ++i)
+    gpr_array_push_back(U32, &holes, 
+      gpr_array_item(&h->indices, gpr_array_item(&holes, i)).value_pos/s);
+  h->num_values -= n;
+
+  // the holes are filled from the end, the highest first: the last entry
+  // is then either the hole itself or a live one
+  gpr_mergesort(holes.data,     n, U32, greater, h->keys.allocator);
+  gpr_mergesort(holes.data + n, n, U32, greater, h->keys.allocator);
+
+  for (i = 0; i < n; ++i)
+  {
+    const U32 hole = gpr_array_item(&holes, i);
+    last = gpr_array_size(&h->indices) - 1;
+    if (hole != last)
+    {
+      U32 *link = find_bucket(h, gpr_array_item(&h->indices, last).key);
+      while (*link != last) link = &gpr_array_item(&h->indices, *link).next;
+      *link = hole;
+      gpr_array_item(&h->indices, hole) = gpr_array_item(&h->indices, last);
+    }
+    gpr_array_pop_back(&h->indices);
+  }
+
+  for (i = n; i < 2*n; ++i)
+  {
+    const U32 hole = gpr_array_item(&holes, i);
+    last = gpr_array_size(&h->keys) - 1;
+    if (hole != last)
+    {
+      const U64 moved = gpr_array_item(&h->keys, last);
+      gpr_array_item(&h->keys, hole) = moved;
+      memcpy(h->values.data + hole*s, h->values.data + last*s, s);
+
+      j = *find_bucket(h, moved);
+      while (gpr_array_item(&h->indices, j).value_pos != last*s)
+        j = gpr_array_item(&h->indices, j).next;
+      gpr_array_item(&h->indices, j).value_pos = hole*s;
+    }
+    gpr_array_pop_back(&h->keys);
+  }
+  gpr_buffer_resize(&h->values, h->num_values*s);
+  gpr_array_destroy(&holes);
+
+  step_remove(h, s);
+}
+
+#endif // GPR_HASH_SWISS
\ No newline at end of file
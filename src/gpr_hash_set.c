@@ -0,0 +1,137 @@
+#include <string.h>
+#include "gpr_hash_set.h"
+
+// ---------------------------------------------------------------
+// Hash set internals
+// ---------------------------------------------------------------
+
+#define MIN_CAPACITY 16
+
+// the table grows past 3/4 of its slots
+#define max_load(capacity) ((capacity) - (capacity)/4)
+
+static U32 ideal_slot(U64 key, U32 mask)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdull;
+  key ^= key >> 33;
+  return (U32)key & mask;
+}
+
+// slot holding key or the empty slot where it would go
+static U32 find_slot(gpr_hash_set_t *s, U64 key)
+{
+  const U32 mask = s->capacity - 1;
+  U32 i = ideal_slot(key, mask);
+  while (s->keys[i] != key && s->keys[i] != 0) i = (i + 1) & mask;
+  return i;
+}
+
+static void resize(gpr_hash_set_t *s, U32 capacity)
+{
+  U64      *old_keys     = s->keys;
+  const U32 old_capacity = s->capacity;
+  U32 i;
+
+  s->keys     = (U64*)gpr_allocate_align(s->allocator, capacity*sizeof(U64), 8);
+  s->capacity = capacity;
+  memset(s->keys, 0, capacity*sizeof(U64));
+
+  for (i = 0; i < old_capacity; ++i)
+  {
+    if (old_keys[i]) s->keys[find_slot(s, old_keys[i])] = old_keys[i];
+  }
+  if (old_capacity) gpr_deallocate(s->allocator, old_keys);
+}
+
+// ---------------------------------------------------------------
+// Hash set implementation
+// ---------------------------------------------------------------
+
+void gpr_hash_set_init(gpr_hash_set_t *s, gpr_allocator_t *a)
+{
+  s->keys      = NULL;
+  s->capacity  = 0;
+  s->size      = 0;
+  s->has_zero  = 0;
+  s->allocator = a;
+}
+
+void gpr_hash_set_destroy(gpr_hash_set_t *s)
+{
+  if (s->capacity) gpr_deallocate(s->allocator, s->keys);
+}
+
+void gpr_hash_set_clear(gpr_hash_set_t *s)
+{
+  if (s->capacity) memset(s->keys, 0, s->capacity*sizeof(U64));
+  s->size     = 0;
+  s->has_zero = 0;
+}
+
+void gpr_hash_set_reserve(gpr_hash_set_t *s, U32 capacity)
+{
+  U32 c = gpr_next_pow2_U32(capacity + capacity/3 + 1);
+  if (c < MIN_CAPACITY) c = MIN_CAPACITY;
+  if (c > s->capacity) resize(s, c);
+}
+
+I32 gpr_hash_set_has(gpr_hash_set_t *s, U64 key)
+{
+  if (key == 0) return s->has_zero;
+  if (s->capacity == 0) return 0;
+  return s->keys[find_slot(s, key)] == key;
+}
+
+I32 gpr_hash_set_insert(gpr_hash_set_t *s, U64 key)
+{
+  U32 i;
+
+  if (key == 0)
+  {
+    if (s->has_zero) return 0;
+    s->has_zero = 1;
+    ++s->size;
+    return 1;
+  }
+
+  if (s->size - s->has_zero >= max_load(s->capacity))
+    resize(s, s->capacity ? s->capacity << 1 : MIN_CAPACITY);
+
+  i = find_slot(s, key);
+  if (s->keys[i] == key) return 0;
+  s->keys[i] = key;
+  ++s->size;
+  return 1;
+}
+
+I32 gpr_hash_set_remove(gpr_hash_set_t *s, U64 key)
+{
+  U32 mask, i, j, k;
+
+  if (key == 0)
+  {
+    if (!s->has_zero) return 0;
+    s->has_zero = 0;
+    --s->size;
+    return 1;
+  }
+  if (s->capacity == 0) return 0;
+
+  mask = s->capacity - 1;
+  i    = find_slot(s, key);
+  if (s->keys[i] != key) return 0;
+
+  // move back the keys of the cluster that can't be reached anymore
+  for (j = (i + 1) & mask; s->keys[j] != 0; j = (j + 1) & mask)
+  {
+    k = ideal_slot(s->keys[j], mask);
+    // k cyclically in (i, j]: the key is still reachable
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) continue;
+    s->keys[i] = s->keys[j];
+    i = j;
+  }
+  s->keys[i] = 0;
+  --s->size;
+  return 1;
+}
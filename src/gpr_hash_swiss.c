@@ -0,0 +1,726 @@
+#include <string.h>
+#include "gpr_types.h"
+#include "gpr_array.h"
+#include "gpr_memory.h"
+#include "gpr_hash.h"
+#include "gpr_buffer.h"
+#include "gpr_assert.h"
+#include "gpr_sort.h"
+#include "gpr_atomic.h"
+
+// open addressing backend, see gpr_hash.c for the chained one
+#ifdef GPR_HASH_SWISS
+
+// ---------------------------------------------------------------
+// Control byte groups
+// ---------------------------------------------------------------
+// Each slot has a control byte: empty, deleted or the 7 low bits of
+// the key hash when it's full. A lookup compares a whole group of
+// control bytes at once and only checks the keys of the slots that
+// matched.
+// A mask has one bit per slot of the group, at bit i with SSE2 and at
+// bit 8*i+7 otherwise.
+// ---------------------------------------------------------------
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+#define GROUP_WIDTH 16
+#define MASK_SHIFT  0
+
+typedef __m128i group_t;
+
+static group_t group_load(const U8 *ctrl)
+{
+  return _mm_loadu_si128((const __m128i*)ctrl);
+}
+
+static U64 group_match(group_t g, U8 h2)
+{
+  return (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)h2), g));
+}
+
+static U64 group_match_empty(group_t g)
+{
+  return (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8((char)0x80), g));
+}
+
+// empty or deleted: the only negative control bytes below -1
+static U64 group_match_free(group_t g)
+{
+  return (U32)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), g));
+}
+
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#define GROUP_WIDTH 8
+#define MASK_SHIFT  3
+#define MSBS        0x8080808080808080ull
+
+typedef uint8x8_t group_t;
+
+static group_t group_load(const U8 *ctrl)
+{
+  return vld1_u8(ctrl);
+}
+
+static U64 group_match(group_t g, U8 h2)
+{
+  return vget_lane_u64(vreinterpret_u64_u8(vceq_u8(g, vdup_n_u8(h2))), 0) & MSBS;
+}
+
+static U64 group_match_empty(group_t g)
+{
+  return vget_lane_u64(vreinterpret_u64_u8(vceq_u8(g, vdup_n_u8(0x80))), 0) & MSBS;
+}
+
+static U64 group_match_free(group_t g)
+{
+  return vget_lane_u64(vreinterpret_u64_u8(
+    vclt_s8(vreinterpret_s8_u8(g), vdup_n_s8(-1))), 0) & MSBS;
+}
+
+#else
+
+// portable fallback: 8 control bytes in a 64 bits word
+#define GROUP_WIDTH 8
+#define MASK_SHIFT  3
+#define LSBS        0x0101010101010101ull
+#define MSBS        0x8080808080808080ull
+
+typedef U64 group_t;
+
+static group_t group_load(const U8 *ctrl)
+{
+  U64 g;
+  memcpy(&g, ctrl, sizeof(U64));
+#ifdef PLATFORM_BIG_ENDIAN
+  g = gpr_swap_U64(g);
+#endif
+  return g;
+}
+
+// may report false positives, the keys are compared anyway
+static U64 group_match(group_t g, U8 h2)
+{
+  const U64 x = g ^ (LSBS * h2);
+  return (x - LSBS) & ~x & MSBS;
+}
+
+static U64 group_match_empty(group_t g)
+{
+  return (g & ~(g << 6)) & MSBS;
+}
+
+static U64 group_match_free(group_t g)
+{
+  return g & MSBS;
+}
+
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static U32 mask_first(U64 m)
+{
+  unsigned long i;
+#if defined(_M_X64)
+  _BitScanForward64(&i, m);
+#else
+  if ((U32)m) _BitScanForward(&i, (U32)m);
+  else { _BitScanForward(&i, (U32)(m >> 32)); i += 32; }
+#endif
+  return (U32)i >> MASK_SHIFT;
+}
+#else
+static U32 mask_first(U64 m)
+{
+  return (U32)__builtin_ctzll(m) >> MASK_SHIFT;
+}
+#endif
+
+#define mask_pop(m) ((m) &= (m) - 1)
+
+// ---------------------------------------------------------------
+// Hash internals
+// ---------------------------------------------------------------
+
+// lookups run concurrently on shared tables (concurrent hash, string pool,
+// RCU snapshots): the probes are counted locally and added atomically
+// once per lookup
+#ifdef GPR_HASH_STATS
+  #define count_lookup(h, probes)               \
+    (gpr_atomic_add_U64(&(h)->num_lookups, 1),  \
+     gpr_atomic_add_U64(&(h)->num_probes, probes))
+#else
+  #define count_lookup(h, probes) ((void)(probes))
+#endif
+
+#define CTRL_EMPTY   ((U8)0x80)
+#define CTRL_DELETED ((U8)0xfe)
+#define END_OF_LIST  0xffffffffu
+
+// keys are often small integers: spread them before probing
+static U64 mix(U64 key)
+{
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdull;
+  key ^= key >> 33;
+  return key;
+}
+
+#define H1(hash) ((U32)((hash) >> 7))
+#define H2(hash) ((U8)((hash) & 0x7f))
+
+// triangular probing over groups visits every group of a power of two
+// sized table
+typedef struct
+{
+  U32 pos, stride, mask;
+} probe_t;
+
+static void probe_init(probe_t *p, U64 hash, U32 capacity)
+{
+  p->mask   = capacity - 1;
+  p->pos    = H1(hash) & p->mask;
+  p->stride = 0;
+}
+
+static void probe_next(probe_t *p)
+{
+  p->stride += GROUP_WIDTH;
+  p->pos = (p->pos + p->stride) & p->mask;
+}
+
+// the first group bytes are mirrored after the last slot so that a group
+// can be loaded at any slot
+static void set_ctrl(gpr_hash_t *h, U32 slot, U8 c)
+{
+  h->ctrl[slot] = c;
+  if (slot < GROUP_WIDTH) h->ctrl[h->capacity + slot] = c;
+}
+
+static U32 find_slot_hash(gpr_hash_t *h, U64 key, U64 hash)
+{
+  probe_t  p;
+  const U8 h2 = H2(hash);
+  U32      probes = 0;
+
+  probe_init(&p, hash, h->capacity);
+  for (;;)
+  {
+    const group_t g = group_load(h->ctrl + p.pos);
+    U64 m = group_match(g, h2);
+    ++probes;
+    while (m)
+    {
+      const U32 slot = (p.pos + mask_first(m)) & p.mask;
+      if (h->slots[slot].key == key) 
+      {
+        count_lookup(h, probes);
+        return slot;
+      }
+      mask_pop(m);
+    }
+    if (group_match_empty(g)) 
+    {
+      count_lookup(h, probes);
+      return END_OF_LIST;
+    }
+    probe_next(&p);
+  }
+}
+
+static U32 find_slot(gpr_hash_t *h, U64 key)
+{
+  if (h->capacity == 0) return END_OF_LIST;
+  return find_slot_hash(h, key, mix(key));
+}
+
+// finds the slot of a given entry when a key has several values
+static U32 find_slot_at(gpr_hash_t *h, U64 key, U32 value_pos)
+{
+  probe_t p;
+  const U64 hash = mix(key);
+  const U8  h2   = H2(hash);
+
+  probe_init(&p, hash, h->capacity);
+  for (;;)
+  {
+    const group_t g = group_load(h->ctrl + p.pos);
+    U64 m = group_match(g, h2);
+    while (m)
+    {
+      const U32 slot = (p.pos + mask_first(m)) & p.mask;
+      if (h->slots[slot].key == key && h->slots[slot].value_pos == value_pos) 
+        return slot;
+      mask_pop(m);
+    }
+    if (group_match_empty(g)) return END_OF_LIST;
+    probe_next(&p);
+  }
+}
+
+static U32 find_free(gpr_hash_t *h, U64 hash)
+{
+  probe_t p;
+  probe_init(&p, hash, h->capacity);
+  for (;;)
+  {
+    const U64 m = group_match_free(group_load(h->ctrl + p.pos));
+    if (m) return (p.pos + mask_first(m)) & p.mask;
+    probe_next(&p);
+  }
+}
+
+// the table is rehashed when 7/8 of the slots are used
+#define max_load(capacity) ((capacity) - (capacity)/8)
+
+static void resize(gpr_hash_t *h, const U32 s, U32 capacity)
+{
+  U8              *old_ctrl     = h->ctrl;
+  gpr_hash_slot_t *old_slots    = h->slots;
+  const U32        old_capacity = h->capacity;
+  U32 i;
+
+  // slots & control bytes share a single block
+  h->slots = (gpr_hash_slot_t*)gpr_allocate_align(h->allocator,
+    capacity*sizeof(gpr_hash_slot_t) + capacity + GROUP_WIDTH, GROUP_WIDTH);
+  h->ctrl     = (U8*)(h->slots + capacity);
+  h->capacity = capacity;
+  memset(h->ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+  ++h->num_rehashes;
+
+  for (i = 0; i < old_capacity; ++i)
+  {
+    U64 hash;
+    U32 slot;
+    if (old_ctrl[i] & 0x80) continue; // empty or deleted
+
+    hash = mix(old_slots[i].key);
+    slot = find_free(h, hash);
+    set_ctrl(h, slot, H2(hash));
+    h->slots[slot] = old_slots[i];
+  }
+  h->growth_left = max_load(capacity) - h->num_values;
+
+  if (old_capacity) gpr_deallocate(h->allocator, old_slots);
+
+  gpr_array_reserve(U64, &h->keys, max_load(capacity));
+  gpr_buffer_reserve(&h->values, max_load(capacity)*s);
+}
+
+static void grow(gpr_hash_t *h, const U32 s)
+{
+  if (h->capacity == 0)
+    resize(h, s, GROUP_WIDTH);
+  else if (h->num_values <= max_load(h->capacity)/2)
+    resize(h, s, h->capacity); // mostly deleted slots: clean them up
+  else
+    resize(h, s, h->capacity << 1);
+}
+
+// smallest capacity holding n values
+static U32 capacity_for(U32 n)
+{
+  const U32 c = gpr_next_pow2_U32(n + n/7 + 1);
+  return c < GROUP_WIDTH ? GROUP_WIDTH : c;
+}
+
+static void shrink(gpr_hash_t *h, const U32 s)
+{
+  const U32 c = capacity_for(h->num_values);
+
+  // the new table has no deleted slots either
+  resize(h, s, c < h->capacity ? c : h->capacity);
+  gpr_array_shrink(U64, &h->keys, max_load(h->capacity));
+  gpr_buffer_shrink(&h->values, max_load(h->capacity)*s);
+}
+
+// called after each removal
+static void step_remove(gpr_hash_t *h, const U32 s)
+{
+  if (GPR_HASH_SHRINK_LOAD_FACTOR > 0.0f && h->capacity > GROUP_WIDTH &&
+      h->num_values < (U32)(h->capacity*GPR_HASH_SHRINK_LOAD_FACTOR))
+    shrink(h, s);
+}
+
+static void insert(gpr_hash_t *h, const U32 s, U64 key, const void *value)
+{
+  U64 hash;
+  U32 slot;
+
+  if (h->growth_left == 0) grow(h, s);
+
+  hash = mix(key);
+  slot = find_free(h, hash);
+  // reusing a deleted slot does not consume growth
+  if (h->ctrl[slot] == CTRL_EMPTY) --h->growth_left;
+  set_ctrl(h, slot, H2(hash));
+
+  h->slots[slot].key       = key;
+  h->slots[slot].value_pos = gpr_buffer_ncat(&h->values, (char*)value, s);
+  gpr_array_push_back(U64, &h->keys, key);
+  ++h->num_values;
+}
+
+static void erase(gpr_hash_t *h, const U32 s, U32 slot)
+{
+  const U32 value_pos = h->slots[slot].value_pos;
+  U32 last_pos;
+
+  set_ctrl(h, slot, CTRL_DELETED);
+  last_pos = --h->num_values*s;
+
+  // move the last value in the hole to keep values packed
+  if (value_pos != last_pos)
+  {
+    const U64 last_key = gpr_array_item(&h->keys, h->num_values);
+    gpr_array_item(&h->keys, value_pos/s) = last_key;
+    memcpy(h->values.data + value_pos, h->values.data + last_pos, s);
+    h->slots[find_slot_at(h, last_key, last_pos)].value_pos = value_pos;
+  }
+  gpr_array_pop_back(&h->keys);
+  gpr_buffer_resize(&h->values, h->num_values*s);
+}
+
+// finds the next slot holding key along its probe sequence
+// the cursor encodes the probe step and the next slot in the group
+static U32 scan(gpr_hash_t *h, U64 key, U32 *cursor)
+{
+  probe_t p;
+  U64     hash;
+  U8      h2;
+  U32     step, k, skip;
+
+  if (h->capacity == 0 || *cursor == END_OF_LIST)
+  {
+    *cursor = END_OF_LIST;
+    return END_OF_LIST;
+  }
+
+  hash = mix(key);
+  h2   = H2(hash);
+  k    = *cursor >> 5;
+  skip = *cursor & 31;
+  probe_init(&p, hash, h->capacity);
+  for (step = 0; step < k; ++step) probe_next(&p);
+
+  for (;;)
+  {
+    const group_t g = group_load(h->ctrl + p.pos);
+    U64 m = group_match(g, h2);
+    while (m)
+    {
+      const U32 b = mask_first(m);
+      const U32 slot = (p.pos + b) & p.mask;
+      if (b >= skip && h->slots[slot].key == key)
+      {
+        *cursor = (k << 5) | (b + 1);
+        return slot;
+      }
+      mask_pop(m);
+    }
+    if (group_match_empty(g))
+    {
+      *cursor = END_OF_LIST;
+      return END_OF_LIST;
+    }
+    probe_next(&p);
+    ++k;
+    skip = 0;
+  }
+}
+
+// ---------------------------------------------------------------
+// Hash implementation
+// ---------------------------------------------------------------
+
+void _gpr_hash_init(gpr_hash_t *h, const U32 s, gpr_allocator_t *a)
+{
+  h->ctrl        = NULL;
+  h->slots       = NULL;
+  h->capacity    = 0;
+  h->growth_left = 0;
+  h->allocator   = a;
+  gpr_array_init(U64, &h->keys, a);
+  gpr_buffer_init(&h->values, a);
+  h->num_values   = 0;
+  h->num_rehashes = 0;
+#ifdef GPR_HASH_STATS
+  h->num_lookups  = 0;
+  h->num_probes   = 0;
+#endif
+}
+
+void _gpr_hash_destroy(gpr_hash_t *h)
+{
+  if (h->capacity) gpr_deallocate(h->allocator, h->slots);
+  gpr_array_destroy(&h->keys);
+  gpr_buffer_destroy(&h->values);
+}
+
+I32 _gpr_hash_has(gpr_hash_t *h, U64 key)
+{
+  return find_slot(h, key) != END_OF_LIST;
+}
+
+void *_gpr_hash_get(gpr_hash_t *h, U64 key)
+{
+  const U32 slot = find_slot(h, key);
+  return slot == END_OF_LIST ? NULL : h->values.data + h->slots[slot].value_pos;
+}
+
+void _gpr_hash_set(gpr_hash_t *h, const U32 s, U64 key, const void *value)
+{
+  const U32 slot = find_slot(h, key);
+  if (slot != END_OF_LIST)
+    memcpy(h->values.data + h->slots[slot].value_pos, value, s);
+  else
+    insert(h, s, key, value);
+}
+
+void _gpr_hash_remove(gpr_hash_t *h, const U32 s, U64 key)
+{
+  const U32 slot = find_slot(h, key);
+  if (slot == END_OF_LIST) return;
+  erase(h, s, slot);
+  step_remove(h, s);
+}
+
+void _gpr_hash_reserve(gpr_hash_t *h, const U32 s, U32 capacity)
+{
+  const U32 c = capacity_for(capacity);
+  if (c > h->capacity) resize(h, s, c);
+}
+
+void _gpr_hash_shrink_to_fit(gpr_hash_t *h, const U32 s)
+{
+  if (h->capacity) shrink(h, s);
+}
+
+void *_gpr_hash_begin(gpr_hash_t *h)
+{
+  return h->values.data;
+}
+
+void *_gpr_hash_end(gpr_hash_t *h, const U32 s)
+{
+  return h->values.data + (h->num_values*s);
+}
+
+// sizes the table once and fills the slots without looking up the keys
+void _gpr_hash_build(gpr_hash_t *h, const U32 s, const U64 *keys, 
+                     const void *values, U32 n)
+{
+  U32 i;
+
+  gpr_assert_msg(h->num_values == 0, "the hash must be empty");
+  _gpr_hash_reserve(h, s, n);
+  // drop the deleted slots left by previous removals
+  memset(h->ctrl, CTRL_EMPTY, h->capacity + GROUP_WIDTH);
+
+  for (i = 0; i < n; ++i)
+  {
+    const U64 hash = mix(keys[i]);
+    const U32 slot = find_free(h, hash);
+    set_ctrl(h, slot, H2(hash));
+    h->slots[slot].key       = keys[i];
+    h->slots[slot].value_pos = i*s;
+  }
+  h->growth_left = max_load(h->capacity) - n;
+
+  gpr_array_resize(U64, &h->keys, n);
+  memcpy(h->keys.data, keys, n*sizeof(U64));
+  gpr_buffer_resize(&h->values, n*s);
+  memcpy(h->values.data, values, n*s);
+  h->num_values = n;
+}
+
+// lookups are done in two stages over a batch of keys: the control bytes
+// and slots of every key are prefetched before the first probe
+#define BATCH 16
+
+static void find_many(gpr_hash_t *h, const U64 *keys, U32 n, void **out,
+                      I32 prefetch_values)
+{
+  U64 hash[BATCH];
+  U32 i, slot;
+
+  if (h->capacity == 0)
+  {
+    for (i = 0; i < n; ++i) out[i] = NULL;
+    return;
+  }
+
+  for (i = 0; i < n; ++i)
+  {
+    const U32 pos = H1(hash[i] = mix(keys[i])) & (h->capacity - 1);
+    gpr_prefetch(h->ctrl + pos);
+    gpr_prefetch(h->slots + pos);
+  }
+  for (i = 0; i < n; ++i)
+  {
+    slot = find_slot_hash(h, keys[i], hash[i]);
+    if (slot == END_OF_LIST)
+    {
+      out[i] = NULL;
+      continue;
+    }
+    out[i] = h->values.data + h->slots[slot].value_pos;
+    if (prefetch_values) gpr_prefetch(out[i]);
+  }
+}
+
+void _gpr_hash_get_many(gpr_hash_t *h, const U64 *keys, U32 n, void **out)
+{
+  U32 i;
+  for (i = 0; i < n; i += BATCH)
+    find_many(h, keys + i, n - i < BATCH ? n - i : BATCH, out + i, 1);
+}
+
+void _gpr_hash_has_many(gpr_hash_t *h, const U64 *keys, U32 n, I32 *out)
+{
+  void *values[BATCH];
+  U32   i, j, m;
+  for (i = 0; i < n; i += m)
+  {
+    m = n - i < BATCH ? n - i : BATCH;
+    find_many(h, keys + i, m, values, 0);
+    for (j = 0; j < m; ++j) out[i + j] = values[j] != NULL;
+  }
+}
+
+// number of groups probed to reach the key of a slot
+static U32 probe_length(gpr_hash_t *h, U32 slot)
+{
+  probe_t p;
+  U32     n = 1;
+
+  probe_init(&p, mix(h->slots[slot].key), h->capacity);
+  while (((slot - p.pos) & p.mask) >= GROUP_WIDTH)
+  {
+    probe_next(&p);
+    ++n;
+  }
+  return n;
+}
+
+void gpr_hash_stats(gpr_hash_t *h, gpr_hash_stats_t *stats)
+{
+  U32 i;
+
+  memset(stats, 0, sizeof(gpr_hash_stats_t));
+  stats->num_values   = h->num_values;
+  stats->num_buckets  = h->capacity;
+  stats->load_factor  = h->capacity ? (F32)h->num_values/h->capacity : 0.0f;
+  stats->num_rehashes = h->num_rehashes;
+
+  for (i = 0; i < h->capacity; ++i)
+  {
+    U32 n;
+    if (h->ctrl[i] & 0x80) continue; // empty or deleted
+    n = probe_length(h, i);
+    ++stats->histogram[n < GPR_HASH_STATS_HISTOGRAM ? n : GPR_HASH_STATS_HISTOGRAM - 1];
+    if (n > stats->max_probe) stats->max_probe = n;
+  }
+
+  stats->bytes_buckets = h->capacity ? h->capacity + GROUP_WIDTH : 0;
+  stats->bytes_indices = h->capacity*sizeof(gpr_hash_slot_t);
+  stats->bytes_keys    = gpr_array_capacity(&h->keys)*sizeof(U64);
+  stats->bytes_values  = h->values.capacity;
+
+#ifdef GPR_HASH_STATS
+  stats->num_lookups = gpr_atomic_load_U64(&h->num_lookups);
+  stats->avg_probes  = stats->num_lookups ? 
+    (F32)gpr_atomic_load_U64(&h->num_probes)/stats->num_lookups : 0.0f;
+#endif
+}
+
+// ---------------------------------------------------------------
+// Multi Hash implementation
+// ---------------------------------------------------------------
+
+void *_gpr_multi_hash_find_first(gpr_hash_t *h, gpr_hash_it *it, U64 key)
+{
+  U32 cursor = 0;
+  const U32 slot = scan(h, key, &cursor);
+
+  if (it != NULL)
+  {
+    it->key  = key;
+    it->next = cursor;
+  }
+  return slot == END_OF_LIST ? NULL : h->values.data + h->slots[slot].value_pos;
+}
+
+void *_gpr_multi_hash_find_next(gpr_hash_t *h, gpr_hash_it *it)
+{
+  const U32 slot = scan(h, it->key, &it->next);
+  return slot == END_OF_LIST ? NULL : h->values.data + h->slots[slot].value_pos;
+}
+
+U32 _gpr_multi_hash_count(gpr_hash_t *h, U64 key)
+{
+  U32 i = 0, cursor = 0;
+  while (scan(h, key, &cursor) != END_OF_LIST) ++i;
+  return i;
+}
+
+void _gpr_multi_hash_insert(gpr_hash_t *h, const U32 s, U64 key, const void *value)
+{
+  insert(h, s, key, value);
+}
+
+void _gpr_multi_hash_remove(gpr_hash_t *h, const U32 s, void *e)
+{
+  const U32 value_pos = (U32)((char*)e - h->values.data);
+  const U32 slot = find_slot_at(h, gpr_array_item(&h->keys, value_pos/s), value_pos);
+  if (slot == END_OF_LIST) return;
+  erase(h, s, slot);
+  step_remove(h, s);
+}
+
+#define greater(a, b) ((a) > (b))
+
+void _gpr_multi_hash_remove_all(gpr_hash_t *h, const U32 s, U64 key)
+{
+  gpr_array_t(U32) holes; // removed values
+  U32 i, n, last, slot, cursor = 0;
+
+  // a single scan of the probe sequence
+  gpr_array_init(U32, &holes, h->allocator);
+  while ((slot = scan(h, key, &cursor)) != END_OF_LIST)
+  {
+    gpr_array_push_back(U32, &holes, h->slots[slot].value_pos/s);
+    set_ctrl(h, slot, CTRL_DELETED);
+  }
+  n = gpr_array_size(&holes);
+  h->num_values -= n;
+
+  // the holes are filled from the end, the highest first: the last value
+  // is then either the hole itself or a live one
+  gpr_mergesort(holes.data, n, U32, greater, h->allocator);
+  for (i = 0; i < n; ++i)
+  {
+    const U32 hole = gpr_array_item(&holes, i);
+    last = gpr_array_size(&h->keys) - 1;
+    if (hole != last)
+    {
+      const U64 moved = gpr_array_item(&h->keys, last);
+      gpr_array_item(&h->keys, hole) = moved;
+      memcpy(h->values.data + hole*s, h->values.data + last*s, s);
+      h->slots[find_slot_at(h, moved, last*s)].value_pos = hole*s;
+    }
+    gpr_array_pop_back(&h->keys);
+  }
+  gpr_buffer_resize(&h->values, h->num_values*s);
+  gpr_array_destroy(&holes);
+
+  step_remove(h, s);
+}
+
+#endif // GPR_HASH_SWISS
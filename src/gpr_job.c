@@ -0,0 +1,258 @@
+#include "gpr_job.h"
+#include "gpr_atomic.h"
+#include "gpr_assert.h"
+#include "tinycthread.h"
+
+typedef gpr_job_entry_t entry_t;
+
+#define QUEUE_MIN_CAPACITY 64
+
+// what a worker does with the fiber that just switched back to it
+#define ACTION_DONE 0
+#define ACTION_PARK 1
+
+// lives on the stack of the fiber running the job
+typedef struct
+{
+  gpr_fiber_t       *fiber;
+  gpr_job_worker_t  *worker;  // worker currently running the fiber
+  gpr_job_counter_t *waiting; // counter the fiber is parked on
+} job_context_t;
+
+struct gpr_job_worker_s
+{
+  gpr_job_system_t *js;
+  thrd_t            thread;
+  gpr_fiber_t       scheduler; // context of the worker thread itself
+  job_context_t    *current;   // job running on the worker, if any
+  U32               action;
+  gpr_fiber_t      *starting;  // fiber & job handed to fiber_main
+  entry_t           entry;
+};
+
+typedef gpr_job_worker_t worker_t;
+
+static _Thread_local worker_t *tls_worker = NULL;
+
+// ---------------------------------------------------------------
+// Job queue
+// ---------------------------------------------------------------
+
+static void queue_push(gpr_job_system_t *js, const entry_t *e)
+{
+  if (js->queue_size == js->queue_capacity)
+  {
+    U32      i;
+    U32      capacity = js->queue_capacity << 1;
+    entry_t *q = (entry_t*)gpr_allocate(js->allocator, capacity*sizeof(entry_t));
+
+    for (i = 0; i < js->queue_size; ++i)
+      q[i] = js->queue[(js->queue_head + i) & (js->queue_capacity-1)];
+
+    gpr_deallocate(js->allocator, js->queue);
+    js->queue          = q;
+    js->queue_capacity = capacity;
+    js->queue_head     = 0;
+  }
+  js->queue[(js->queue_head + js->queue_size++) & (js->queue_capacity-1)] = *e;
+}
+
+static void queue_pop(gpr_job_system_t *js, entry_t *e)
+{
+  *e = js->queue[js->queue_head];
+  js->queue_head = (js->queue_head + 1) & (js->queue_capacity-1);
+  --js->queue_size;
+}
+
+// ---------------------------------------------------------------
+// Fibers & workers
+// ---------------------------------------------------------------
+
+static void job_done(gpr_job_system_t *js, gpr_job_counter_t *counter)
+{
+  // a fiber may be parked on the counter
+  if (gpr_atomic_add_U32(&counter->value, (U32)-1) == 1)
+    gpr_semaphore_post(&js->wakeup, 1);
+}
+
+static void fiber_main(void *arg)
+{
+  worker_t     *w = (worker_t*)arg;
+  entry_t       e = w->entry;
+  job_context_t ctx;
+
+  ctx.fiber   = w->starting;
+  ctx.worker  = w;
+  ctx.waiting = NULL;
+  w->current  = &ctx;
+
+  e.job.func(w->js, e.job.arg);
+
+  // the job may have been resumed by another worker
+  w = ctx.worker;
+  if (e.counter) job_done(w->js, e.counter);
+
+  w->action = ACTION_DONE;
+  gpr_fiber_switch(ctx.fiber, &w->scheduler);
+  // the fiber was acquired again: returning runs the next job
+}
+
+// returns a parked fiber whose counter reached zero
+static job_context_t *pop_ready(gpr_job_system_t *js)
+{
+  U32 i;
+  for (i = 0; i < gpr_array_size(&js->parked); ++i)
+  {
+    job_context_t *ctx = (job_context_t*)gpr_array_item(&js->parked, i);
+    if (gpr_atomic_load_U32(&ctx->waiting->value) == 0)
+    {
+      gpr_array_remove(&js->parked, i);
+      return ctx;
+    }
+  }
+  return NULL;
+}
+
+static int worker_main(void *arg)
+{
+  worker_t         *w  = (worker_t*)arg;
+  gpr_job_system_t *js = w->js;
+
+  tls_worker = w;
+  gpr_fiber_init_thread(&w->scheduler);
+
+  while (!gpr_atomic_load_U32(&js->stop))
+  {
+    job_context_t *ctx   = NULL;
+    gpr_fiber_t   *fiber = NULL;
+
+    gpr_mutex_lock(&js->lock);
+    ctx = pop_ready(js);
+    if (ctx == NULL && js->queue_size > 0)
+    {
+      queue_pop(js, &w->entry);
+      fiber = gpr_fiber_pool_acquire(&js->fibers, fiber_main, w);
+    }
+    gpr_mutex_unlock(&js->lock);
+
+    if (ctx)
+    {
+      ctx->worker = w;
+      w->current  = ctx;
+      gpr_fiber_switch(&w->scheduler, ctx->fiber);
+    }
+    else if (fiber)
+    {
+      w->starting = fiber;
+      gpr_fiber_switch(&w->scheduler, fiber);
+    }
+    else
+    {
+      gpr_semaphore_wait(&js->wakeup);
+      continue;
+    }
+
+    // the fiber switched back: it is done or waits on a counter
+    gpr_mutex_lock(&js->lock);
+    if (w->action == ACTION_PARK)
+      gpr_array_push_back(void*, &js->parked, w->current);
+    else
+      gpr_fiber_pool_release(&js->fibers, w->current->fiber);
+    gpr_mutex_unlock(&js->lock);
+    w->current = NULL;
+  }
+
+  gpr_fiber_destroy(&w->scheduler);
+  return 0;
+}
+
+// ---------------------------------------------------------------
+// Job system
+// ---------------------------------------------------------------
+
+void gpr_job_system_init(gpr_job_system_t *js, U32 num_workers,
+                         U32 num_fibers, U32 stack_size, gpr_allocator_t *a)
+{
+  U32 i;
+
+  js->allocator      = a;
+  js->stop           = 0;
+  js->queue_capacity = QUEUE_MIN_CAPACITY;
+  js->queue_head     = 0;
+  js->queue_size     = 0;
+  js->queue = (entry_t*)gpr_allocate(a, QUEUE_MIN_CAPACITY*sizeof(entry_t));
+  gpr_mutex_init(&js->lock);
+  gpr_semaphore_init(&js->wakeup, 0);
+  gpr_array_init(void*, &js->parked, a);
+  gpr_fiber_pool_init(&js->fibers, stack_size, num_fibers, a);
+
+  js->num_workers = num_workers;
+  js->workers = (worker_t*)gpr_allocate(a, num_workers*sizeof(worker_t));
+  for (i = 0; i < num_workers; ++i)
+  {
+    worker_t *w = &js->workers[i];
+    w->js      = js;
+    w->current = NULL;
+    thrd_create(&w->thread, worker_main, w);
+  }
+}
+
+void gpr_job_system_destroy(gpr_job_system_t *js)
+{
+  U32 i;
+
+  gpr_atomic_store_U32(&js->stop, 1);
+  gpr_semaphore_post(&js->wakeup, js->num_workers);
+  for (i = 0; i < js->num_workers; ++i)
+    thrd_join(js->workers[i].thread, NULL);
+
+  gpr_assert_msg(js->queue_size == 0 && gpr_array_empty(&js->parked),
+    "the job system was destroyed with pending jobs");
+
+  gpr_deallocate(js->allocator, js->workers);
+  gpr_deallocate(js->allocator, js->queue);
+  gpr_array_destroy(&js->parked);
+  gpr_fiber_pool_destroy(&js->fibers);
+}
+
+void gpr_job_run(gpr_job_system_t *js, const gpr_job_t *jobs, U32 n,
+                 gpr_job_counter_t *counter)
+{
+  U32 i;
+  entry_t e;
+
+  if (counter) gpr_atomic_add_U32(&counter->value, n);
+
+  e.counter = counter;
+  gpr_mutex_lock(&js->lock);
+  for (i = 0; i < n; ++i)
+  {
+    e.job = jobs[i];
+    queue_push(js, &e);
+  }
+  gpr_mutex_unlock(&js->lock);
+
+  gpr_semaphore_post(&js->wakeup, n);
+}
+
+void gpr_job_wait(gpr_job_system_t *js, gpr_job_counter_t *counter)
+{
+  worker_t      *w = tls_worker;
+  job_context_t *ctx;
+
+  if (gpr_atomic_load_U32(&counter->value) == 0) return;
+
+  // not called from a job: block the thread
+  if (w == NULL || w->current == NULL)
+  {
+    while (gpr_atomic_load_U32(&counter->value) != 0) thrd_yield();
+    return;
+  }
+
+  // park the fiber, the worker pushes it in the parked list once it
+  // switched away so that no other worker can resume it before
+  ctx = w->current;
+  ctx->waiting = counter;
+  w->action    = ACTION_PARK;
+  gpr_fiber_switch(ctx->fiber, &w->scheduler);
+}
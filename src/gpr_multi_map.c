@@ -0,0 +1,161 @@
+#include <string.h>
+#include "gpr_multi_map.h"
+
+typedef gpr_multi_map_run_t run_t;
+
+// ---------------------------------------------------------------
+// Multi map internals
+// ---------------------------------------------------------------
+
+#define MIN_RUN_CAPACITY 2
+
+// the buffer is compacted when it holds more holes than values
+#define MIN_HOLES 64
+
+static U32 end_of_values(gpr_multi_map_t *m, const U32 s)
+{
+  return m->values.size/s;
+}
+
+// appends room for n values, returns the position of the first one
+static U32 append(gpr_multi_map_t *m, const U32 s, U32 n)
+{
+  const U32 pos = end_of_values(m, s);
+  gpr_buffer_resize(&m->values, (pos + n)*s);
+  return pos;
+}
+
+// frees the values of a run, a run at the end of the buffer is given back
+static void release(gpr_multi_map_t *m, const U32 s, run_t *run)
+{
+  if (run->pos + run->capacity == end_of_values(m, s))
+    gpr_buffer_resize(&m->values, run->pos*s);
+  else
+    m->num_holes += run->capacity;
+}
+
+// moves every run to a new buffer, without holes nor spare capacity
+static void compact(gpr_multi_map_t *m, const U32 s)
+{
+  gpr_buffer_t values;
+  run_t *run = (run_t*)_gpr_hash_begin(&m->runs);
+  run_t *end = (run_t*)_gpr_hash_end(&m->runs, sizeof(run_t));
+
+  gpr_buffer_init(&values, m->values.allocator);
+  gpr_buffer_reserve(&values, m->num_values*s);
+  for (; run < end; ++run)
+  {
+    const U32 pos = values.size/s;
+    gpr_buffer_ncat(&values, m->values.data + run->pos*s, run->count*s);
+    run->pos      = pos;
+    run->capacity = run->count;
+  }
+  gpr_buffer_destroy(&m->values);
+  m->values    = values;
+  m->num_holes = 0;
+}
+
+static void maybe_compact(gpr_multi_map_t *m, const U32 s)
+{
+  if (m->num_holes > MIN_HOLES && m->num_holes > m->num_values) compact(m, s);
+}
+
+// ---------------------------------------------------------------
+// Multi map implementation
+// ---------------------------------------------------------------
+
+void _gpr_multi_map_init(gpr_multi_map_t *m, const U32 s, gpr_allocator_t *a)
+{
+  gpr_hash_init(run_t, &m->runs, a);
+  gpr_buffer_init(&m->values, a);
+  m->num_values = 0;
+  m->num_holes  = 0;
+}
+
+void _gpr_multi_map_destroy(gpr_multi_map_t *m)
+{
+  gpr_hash_destroy(run_t, &m->runs);
+  gpr_buffer_destroy(&m->values);
+}
+
+void _gpr_multi_map_insert(gpr_multi_map_t *m, const U32 s, U64 key, const void *value)
+{
+  run_t *run = gpr_hash_get(run_t, &m->runs, key);
+
+  if (run == NULL)
+  {
+    run_t r;
+    r.pos      = append(m, s, MIN_RUN_CAPACITY);
+    r.count    = 0;
+    r.capacity = MIN_RUN_CAPACITY;
+    gpr_hash_set(run_t, &m->runs, key, &r);
+    run = gpr_hash_get(run_t, &m->runs, key);
+  }
+  else if (run->count == run->capacity)
+  {
+    if (run->pos + run->capacity == end_of_values(m, s))
+    {
+      // the last run grows in place
+      append(m, s, run->capacity);
+    }
+    else
+    {
+      const U32 pos = append(m, s, run->capacity << 1);
+      memcpy(m->values.data + pos*s, m->values.data + run->pos*s, run->count*s);
+      m->num_holes += run->capacity;
+      run->pos = pos;
+    }
+    run->capacity <<= 1;
+  }
+
+  memcpy(m->values.data + (run->pos + run->count++)*s, value, s);
+  ++m->num_values;
+  maybe_compact(m, s);
+}
+
+void *_gpr_multi_map_range(gpr_multi_map_t *m, const U32 s, U64 key, U32 *count)
+{
+  run_t *run = gpr_hash_get(run_t, &m->runs, key);
+  if (run == NULL)
+  {
+    *count = 0;
+    return NULL;
+  }
+  *count = run->count;
+  return m->values.data + run->pos*s;
+}
+
+U32 _gpr_multi_map_count(gpr_multi_map_t *m, U64 key)
+{
+  run_t *run = gpr_hash_get(run_t, &m->runs, key);
+  return run ? run->count : 0;
+}
+
+void _gpr_multi_map_remove(gpr_multi_map_t *m, const U32 s, U64 key, void *e)
+{
+  run_t *run = gpr_hash_get(run_t, &m->runs, key);
+  char  *last;
+
+  if (run == NULL) return;
+  if (run->count == 1)
+  {
+    _gpr_multi_map_remove_all(m, s, key);
+    return;
+  }
+
+  // the last value of the run takes the place of the removed one
+  last = m->values.data + (run->pos + --run->count)*s;
+  if ((char*)e != last) memcpy(e, last, s);
+  --m->num_values;
+}
+
+void _gpr_multi_map_remove_all(gpr_multi_map_t *m, const U32 s, U64 key)
+{
+  run_t *run = gpr_hash_get(run_t, &m->runs, key);
+
+  if (run == NULL) return;
+  m->num_values -= run->count;
+  release(m, s, run);
+  gpr_hash_remove(run_t, &m->runs, key);
+  maybe_compact(m, s);
+}
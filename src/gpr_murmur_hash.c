@@ -1,47 +1,141 @@
-#include "gpr_murmur_hash.h"
-
-U64 gpr_murmur_hash_64(const void *key, U32 len, U64 seed)
-{
-  const U64 m = 0xc6a4a7935bd1e995ULL;
-  const U32 r = 47;
-
-  U64 h = seed ^ (len * m);
-
-  const U64 *data = (const U64*)key;
-  const U64 *end = data + (len/8);
-
-  while(data != end)
-  {
-    U64 k = *data++;
-#ifdef PLATFORM_BIG_ENDIAN
-    k = gpr_swap_U64(k);
-#endif
-
-    k *= m;
-    k ^= k >> r;
-    k *= m;
-
-    h ^= k;
-    h *= m;
-  }
-  {
-    const unsigned char *data2 = (const unsigned char*)data;
-    switch(len & 7)
-    {
-    case 7: h ^= ((U64)data2[6]) << 48;
-    case 6: h ^= ((U64)data2[5]) << 40;
-    case 5: h ^= ((U64)data2[4]) << 32;
-    case 4: h ^= ((U64)data2[3]) << 24;
-    case 3: h ^= ((U64)data2[2]) << 16;
-    case 2: h ^= ((U64)data2[1]) << 8;
-    case 1: h ^= ((U64)data2[0]);
-      h *= m;
-    };
-  }
-
-  h ^= h >> r;
-  h *= m;
-  h ^= h >> r;
-
-  return h;
-}
\ No newline at end of file
+#include <string.h>
+#include "gpr_murmur_hash.h"
+#include "gpr_assert.h"
+
+U64 gpr_murmur_hash_64(const void *key, U32 len, U64 seed)
+{
+  const U64 m = 0xc6a4a7935bd1e995ULL;
+  const U32 r = 47;
+
+  U64 h = seed ^ (len * m);
+
+  // the blocks are copied out: the key may be unaligned
+  const unsigned char *data = (const unsigned char*)key;
+  const unsigned char *end = data + (len/8)*8;
+
+  while(data != end)
+  {
+    U64 k;
+    memcpy(&k, data, 8);
+    data += 8;
+#ifdef PLATFORM_BIG_ENDIAN
+    k = gpr_swap_U64(k);
+#endif
+
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+
+    h ^= k;
+    h *= m;
+  }
+  {
+    const unsigned char *data2 = data;
+    switch(len & 7)
+    {
+    case 7: h ^= ((U64)data2[6]) << 48;
+    case 6: h ^= ((U64)data2[5]) << 40;
+    case 5: h ^= ((U64)data2[4]) << 32;
+    case 4: h ^= ((U64)data2[3]) << 24;
+    case 3: h ^= ((U64)data2[2]) << 16;
+    case 2: h ^= ((U64)data2[1]) << 8;
+    case 1: h ^= ((U64)data2[0]);
+      h *= m;
+    };
+  }
+
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+
+  return h;
+}
+
+// ---------------------------------------------------------------
+// Streaming form
+// ---------------------------------------------------------------
+
+#define MURMUR_M 0xc6a4a7935bd1e995ULL
+#define MURMUR_R 47
+
+static U64 mix_block(U64 h, U64 k)
+{
+  k *= MURMUR_M;
+  k ^= k >> MURMUR_R;
+  k *= MURMUR_M;
+
+  h ^= k;
+  return h*MURMUR_M;
+}
+
+void gpr_murmur_hash_64_init(gpr_murmur_hash_64_state_t *st, U32 len, U64 seed)
+{
+  st->h         = seed ^ (len * MURMUR_M);
+  st->tail      = 0;
+  st->tail_size = 0;
+  st->len_left  = len;
+}
+
+void gpr_murmur_hash_64_update(gpr_murmur_hash_64_state_t *st, const void *data,
+                               U32 size)
+{
+  const unsigned char *p   = (const unsigned char*)data;
+  const unsigned char *end = p + size;
+  U64 k;
+
+  gpr_assert_msg(size <= st->len_left, "more bytes than announced");
+  st->len_left -= size;
+
+  // complete the pending block, bytes are little endian like the blocks
+  while (st->tail_size && p != end)
+  {
+    st->tail |= (U64)*p++ << (st->tail_size*8);
+    if (++st->tail_size == 8)
+    {
+      st->h = mix_block(st->h, st->tail);
+      st->tail      = 0;
+      st->tail_size = 0;
+    }
+  }
+
+  for (; end - p >= 8; p += 8)
+  {
+    memcpy(&k, p, 8);
+#ifdef PLATFORM_BIG_ENDIAN
+    k = gpr_swap_U64(k);
+#endif
+    st->h = mix_block(st->h, k);
+  }
+
+  for (; p != end; ++st->tail_size)
+    st->tail |= (U64)*p++ << (st->tail_size*8);
+}
+
+U64 gpr_murmur_hash_64_final(gpr_murmur_hash_64_state_t *st)
+{
+  U64 h = st->h;
+
+  gpr_assert_msg(st->len_left == 0, "fewer bytes than announced");
+  if (st->tail_size)
+  {
+    h ^= st->tail;
+    h *= MURMUR_M;
+  }
+
+  h ^= h >> MURMUR_R;
+  h *= MURMUR_M;
+  h ^= h >> MURMUR_R;
+
+  return h;
+}
+
+// ---------------------------------------------------------------
+// Batch form
+// ---------------------------------------------------------------
+
+void gpr_hash_batch_64(const void *const *keys, const U32 *lens, U32 n, U64 seed,
+                       U64 *out)
+{
+  U32 i;
+  for (i = 0; i < n; ++i) out[i] = gpr_murmur_hash_64(keys[i], lens[i], seed);
+}
@@ -0,0 +1,852 @@
+#include <string.h>
+#include "gpr_radix_tree.h"
+#include "gpr_assert.h"
+
+#define PREFIX GPR_RADIX_TREE_PREFIX
+
+// ---------------------------------------------------------------
+// Nodes & leaves
+// ---------------------------------------------------------------
+// A child is a node or a tagged leaf: leaves are 8 bytes aligned, the
+// low bit of their address is set in the child pointers.
+// An inner node has at least two entries, children or its own leaf.
+// ---------------------------------------------------------------
+
+enum { NODE4, NODE16, NODE48, NODE256 };
+
+typedef struct
+{
+  U32 len;
+  U32 pad;
+  // key follows, then the value at the next multiple of 8
+} leaf_t;
+
+typedef struct
+{
+  U8      type;
+  U8      pad;
+  U16     num_children;
+  U32     prefix_len;      // bytes skipped, only the first PREFIX are kept
+  U8      prefix[PREFIX];
+  leaf_t *leaf;            // of the key ending on the node
+} node_t;
+
+typedef struct
+{
+  node_t n;
+  U8     keys[4];          // sorted
+  void  *children[4];
+} node4_t;
+
+typedef struct
+{
+  node_t n;
+  U8     keys[16];         // sorted
+  void  *children[16];
+} node16_t;
+
+typedef struct
+{
+  node_t n;
+  U8     index[256];       // slot + 1 of each byte, 0 if none
+  void  *children[48];     // the first num_children slots are used
+} node48_t;
+
+typedef struct
+{
+  node_t n;
+  void  *children[256];
+} node256_t;
+
+static const U32 node_sizes[] =
+  { sizeof(node4_t), sizeof(node16_t), sizeof(node48_t), sizeof(node256_t) };
+
+static I32 is_leaf(const void *c)
+{
+  return ((size_t)c & 1) != 0;
+}
+
+static leaf_t *as_leaf(void *c)
+{
+  return (leaf_t*)((char*)c - 1);
+}
+
+static void *tag_leaf(leaf_t *l)
+{
+  return (char*)l + 1;
+}
+
+static U8 *leaf_key(leaf_t *l)
+{
+  return (U8*)(l + 1);
+}
+
+static void *leaf_value(leaf_t *l)
+{
+  return (char*)l + gpr_next_multiple(sizeof(leaf_t) + l->len, 8);
+}
+
+static I32 leaf_matches(leaf_t *l, const U8 *key, U32 len)
+{
+  return l->len == len && memcmp(leaf_key(l), key, len) == 0;
+}
+
+static I32 leaf_is_prefix(leaf_t *l, const U8 *key, U32 len)
+{
+  return l->len <= len && memcmp(leaf_key(l), key, l->len) == 0;
+}
+
+static leaf_t *new_leaf(gpr_radix_tree_t *t, const U32 s, const U8 *key, U32 len,
+                        const void *value)
+{
+  const U32 value_pos = gpr_next_multiple(sizeof(leaf_t) + len, 8);
+  leaf_t   *l = (leaf_t*)gpr_allocate_align(t->allocator, value_pos + s, 8);
+
+  l->len = len;
+  l->pad = 0;
+  memcpy(leaf_key(l), key, len);
+  memcpy((char*)l + value_pos, value, s);
+  ++t->num_values;
+  return l;
+}
+
+static void free_leaf(gpr_radix_tree_t *t, leaf_t *l)
+{
+  gpr_deallocate(t->allocator, l);
+  --t->num_values;
+}
+
+static node_t *new_node(gpr_radix_tree_t *t, U32 type)
+{
+  node_t *n = (node_t*)gpr_allocate_align(t->allocator, node_sizes[type], 8);
+  memset(n, 0, node_sizes[type]);
+  n->type = (U8)type;
+  return n;
+}
+
+// n takes the place of old, which is freed
+static void replace_node(gpr_radix_tree_t *t, void **ref, node_t *old, node_t *n)
+{
+  n->num_children = old->num_children;
+  n->prefix_len   = old->prefix_len;
+  n->leaf         = old->leaf;
+  memcpy(n->prefix, old->prefix, PREFIX);
+  *ref = n;
+  gpr_deallocate(t->allocator, old);
+}
+
+// ---------------------------------------------------------------
+// Node16 key search
+// ---------------------------------------------------------------
+// The 16 keys are compared at once. A mask has one bit per key, at bit i
+// with SSE2 and at bit 4*i otherwise, only the first num_children count.
+// ---------------------------------------------------------------
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+
+#include <emmintrin.h>
+
+#define MASK_SHIFT 0
+
+static U64 match16(const U8 *keys, U8 byte)
+{
+  return (U32)_mm_movemask_epi8(_mm_cmpeq_epi8(
+    _mm_loadu_si128((const __m128i*)keys), _mm_set1_epi8((char)byte)));
+}
+
+// unsigned compare: both sides are shifted to signed bytes
+static U64 match16_below(const U8 *keys, U8 byte)
+{
+  const __m128i flip = _mm_set1_epi8((char)0x80);
+  return (U32)_mm_movemask_epi8(_mm_cmplt_epi8(
+    _mm_xor_si128(_mm_loadu_si128((const __m128i*)keys), flip),
+    _mm_set1_epi8((char)(byte ^ 0x80))));
+}
+
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#define MASK_SHIFT 2
+
+// narrows the byte masks of a compare to a nibble per key
+static U64 neon_mask(uint8x16_t m)
+{
+  return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(m), 4)), 0);
+}
+
+static U64 match16(const U8 *keys, U8 byte)
+{
+  return neon_mask(vceqq_u8(vld1q_u8(keys), vdupq_n_u8(byte)));
+}
+
+static U64 match16_below(const U8 *keys, U8 byte)
+{
+  return neon_mask(vcltq_u8(vld1q_u8(keys), vdupq_n_u8(byte)));
+}
+
+#else
+
+#define MASK_SHIFT 0
+
+static U64 match16(const U8 *keys, U8 byte)
+{
+  U64 m = 0;
+  U32 i;
+  for (i = 0; i < 16; ++i) m |= (U64)(keys[i] == byte) << i;
+  return m;
+}
+
+static U64 match16_below(const U8 *keys, U8 byte)
+{
+  U64 m = 0;
+  U32 i;
+  for (i = 0; i < 16; ++i) m |= (U64)(keys[i] < byte) << i;
+  return m;
+}
+
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static U32 first_key(U64 m)
+{
+  unsigned long i;
+#if defined(_M_X64)
+  _BitScanForward64(&i, m);
+#else
+  if ((U32)m) _BitScanForward(&i, (U32)m);
+  else { _BitScanForward(&i, (U32)(m >> 32)); i += 32; }
+#endif
+  return (U32)i >> MASK_SHIFT;
+}
+#else
+static U32 first_key(U64 m)
+{
+  return (U32)__builtin_ctzll(m) >> MASK_SHIFT;
+}
+#endif
+
+static U64 used_keys(U32 num_children)
+{
+  return num_children >= 16 ? ~0ull : (1ull << (num_children << MASK_SHIFT)) - 1;
+}
+
+// position of byte in the sorted keys
+static U32 node16_lower_bound(node16_t *n, U8 byte)
+{
+  const U64 used = used_keys(n->n.num_children);
+  const U64 m    = match16_below(n->keys, byte) & used;
+  return m == used ? n->n.num_children : first_key(~m);
+}
+
+// ---------------------------------------------------------------
+// Children
+// ---------------------------------------------------------------
+
+static void **find_child(node_t *n, U8 byte)
+{
+  U32 i;
+  U64 m;
+
+  switch (n->type)
+  {
+  case NODE4:
+  {
+    node4_t *n4 = (node4_t*)n;
+    for (i = 0; i < n->num_children; ++i)
+      if (n4->keys[i] == byte) return &n4->children[i];
+    return NULL;
+  }
+  case NODE16:
+  {
+    node16_t *n16 = (node16_t*)n;
+    m = match16(n16->keys, byte) & used_keys(n->num_children);
+    return m ? &n16->children[first_key(m)] : NULL;
+  }
+  case NODE48:
+  {
+    node48_t *n48 = (node48_t*)n;
+    i = n48->index[byte];
+    return i ? &n48->children[i - 1] : NULL;
+  }
+  default:
+  {
+    node256_t *n256 = (node256_t*)n;
+    return n256->children[byte] ? &n256->children[byte] : NULL;
+  }
+  }
+}
+
+// child following position *pos in key order, NULL past the last one
+static void *next_child(node_t *n, U32 *pos)
+{
+  switch (n->type)
+  {
+  case NODE4:
+    return *pos < n->num_children ? ((node4_t*)n)->children[(*pos)++] : NULL;
+  case NODE16:
+    return *pos < n->num_children ? ((node16_t*)n)->children[(*pos)++] : NULL;
+  case NODE48:
+  {
+    node48_t *n48 = (node48_t*)n;
+    for (; *pos < 256; ++*pos)
+      if (n48->index[*pos]) return n48->children[n48->index[(*pos)++] - 1];
+    return NULL;
+  }
+  default:
+  {
+    node256_t *n256 = (node256_t*)n;
+    for (; *pos < 256; ++*pos)
+      if (n256->children[*pos]) return n256->children[(*pos)++];
+    return NULL;
+  }
+  }
+}
+
+// inserts in sorted keys & children of size num
+static void insert_sorted(U8 *keys, void **children, U32 num, U32 pos, U8 byte,
+                          void *child)
+{
+  memmove(keys + pos + 1, keys + pos, num - pos);
+  memmove(children + pos + 1, children + pos, (num - pos)*sizeof(void*));
+  keys[pos]     = byte;
+  children[pos] = child;
+}
+
+static void erase_sorted(U8 *keys, void **children, U32 num, U32 pos)
+{
+  memmove(keys + pos, keys + pos + 1, num - pos - 1);
+  memmove(children + pos, children + pos + 1, (num - pos - 1)*sizeof(void*));
+}
+
+// adds a child to n, which is replaced by a larger node when full
+static void add_child(gpr_radix_tree_t *t, void **ref, node_t *n, U8 byte, void *child)
+{
+  node_t *g;
+  U32     i;
+
+  switch (n->type)
+  {
+  case NODE4:
+  {
+    node4_t  *n4 = (node4_t*)n;
+    node16_t *n16;
+    if (n->num_children < 4)
+    {
+      for (i = 0; i < n->num_children && n4->keys[i] < byte; ++i) {}
+      insert_sorted(n4->keys, n4->children, n->num_children++, i, byte, child);
+      return;
+    }
+    g   = new_node(t, NODE16);
+    n16 = (node16_t*)g;
+    memcpy(n16->keys, n4->keys, 4);
+    memcpy(n16->children, n4->children, 4*sizeof(void*));
+    break;
+  }
+  case NODE16:
+  {
+    node16_t *n16 = (node16_t*)n;
+    node48_t *n48;
+    if (n->num_children < 16)
+    {
+      i = node16_lower_bound(n16, byte);
+      insert_sorted(n16->keys, n16->children, n->num_children++, i, byte, child);
+      return;
+    }
+    g   = new_node(t, NODE48);
+    n48 = (node48_t*)g;
+    for (i = 0; i < 16; ++i)
+    {
+      n48->index[n16->keys[i]] = (U8)(i + 1);
+      n48->children[i]         = n16->children[i];
+    }
+    break;
+  }
+  case NODE48:
+  {
+    node48_t  *n48 = (node48_t*)n;
+    node256_t *n256;
+    if (n->num_children < 48)
+    {
+      n48->children[n->num_children] = child;
+      n48->index[byte] = (U8)++n->num_children;
+      return;
+    }
+    g    = new_node(t, NODE256);
+    n256 = (node256_t*)g;
+    for (i = 0; i < 256; ++i)
+      if (n48->index[i]) n256->children[i] = n48->children[n48->index[i] - 1];
+    break;
+  }
+  default:
+    ((node256_t*)n)->children[byte] = child;
+    ++n->num_children;
+    return;
+  }
+
+  replace_node(t, ref, n, g);
+  add_child(t, ref, g, byte, child);
+}
+
+// a node left with a single entry is replaced by it, its prefix and key
+// byte are prepended to the prefix of a child node
+static void collapse(gpr_radix_tree_t *t, void **ref, node_t *n)
+{
+  node4_t *n4 = (node4_t*)n;
+  node_t  *c;
+  U8       prefix[PREFIX];
+  U32      i;
+
+  if (n->num_children == 0) *ref = tag_leaf(n->leaf);
+  else if (is_leaf(n4->children[0])) *ref = n4->children[0];
+  else
+  {
+    c = (node_t*)n4->children[0];
+    i = n->prefix_len < PREFIX ? n->prefix_len : PREFIX;
+    memcpy(prefix, n->prefix, i);
+    if (i < PREFIX) prefix[i++] = n4->keys[0];
+    for (; i < PREFIX && i - n->prefix_len - 1 < c->prefix_len; ++i)
+      prefix[i] = c->prefix[i - n->prefix_len - 1];
+    memcpy(c->prefix, prefix, i);
+    c->prefix_len += n->prefix_len + 1;
+    *ref = c;
+  }
+  gpr_deallocate(t->allocator, n);
+}
+
+// removes a child from n, which is replaced by a smaller node when it
+// gets sparse enough or collapsed when one entry is left
+static void remove_child(gpr_radix_tree_t *t, void **ref, node_t *n, U8 byte)
+{
+  node_t *g = NULL;
+  U32     i, j;
+
+  switch (n->type)
+  {
+  case NODE4:
+  {
+    node4_t *n4 = (node4_t*)n;
+    for (i = 0; n4->keys[i] != byte; ++i) {}
+    erase_sorted(n4->keys, n4->children, n->num_children--, i);
+    break;
+  }
+  case NODE16:
+  {
+    node16_t *n16 = (node16_t*)n;
+    node4_t  *n4;
+    i = first_key(match16(n16->keys, byte) & used_keys(n->num_children));
+    erase_sorted(n16->keys, n16->children, n->num_children--, i);
+    if (n->num_children > 3) break;
+    g  = new_node(t, NODE4);
+    n4 = (node4_t*)g;
+    memcpy(n4->keys, n16->keys, 3);
+    memcpy(n4->children, n16->children, 3*sizeof(void*));
+    break;
+  }
+  case NODE48:
+  {
+    node48_t *n48  = (node48_t*)n;
+    node16_t *n16;
+    const U32 slot = n48->index[byte] - 1;
+
+    // the last slot fills the hole: the used slots stay first
+    n48->index[byte] = 0;
+    if (slot != --n->num_children)
+    {
+      n48->children[slot] = n48->children[n->num_children];
+      for (i = 0; n48->index[i] != n->num_children + 1; ++i) {}
+      n48->index[i] = (U8)(slot + 1);
+    }
+    n48->children[n->num_children] = NULL;
+    if (n->num_children > 12) break;
+    g   = new_node(t, NODE16);
+    n16 = (node16_t*)g;
+    for (i = 0, j = 0; i < 256; ++i)
+    {
+      if (!n48->index[i]) continue;
+      n16->keys[j]       = (U8)i;
+      n16->children[j++] = n48->children[n48->index[i] - 1];
+    }
+    break;
+  }
+  default:
+  {
+    node256_t *n256 = (node256_t*)n;
+    node48_t  *n48;
+    n256->children[byte] = NULL;
+    if (--n->num_children > 37) break;
+    g   = new_node(t, NODE48);
+    n48 = (node48_t*)g;
+    for (i = 0, j = 0; i < 256; ++i)
+    {
+      if (!n256->children[i]) continue;
+      n48->children[j] = n256->children[i];
+      n48->index[i]    = (U8)++j;
+    }
+    break;
+  }
+  }
+
+  if (g)
+  {
+    replace_node(t, ref, n, g);
+    n = g;
+  }
+  if (n->num_children + (n->leaf != NULL) == 1) collapse(t, ref, n);
+}
+
+// ---------------------------------------------------------------
+// Prefixes
+// ---------------------------------------------------------------
+
+// any leaf below c: the first one in key order
+static leaf_t *min_leaf(void *c)
+{
+  U32 pos;
+
+  while (!is_leaf(c))
+  {
+    node_t *n = (node_t*)c;
+    if (n->leaf) return n->leaf;
+    pos = 0;
+    c = next_child(n, &pos);
+  }
+  return as_leaf(c);
+}
+
+// compares the kept prefix bytes only, lookups compare the whole key at
+// the leaf
+static I32 check_prefix(node_t *n, const U8 *key, U32 len, U32 depth)
+{
+  const U32 max = n->prefix_len < PREFIX ? n->prefix_len : PREFIX;
+  U32       i;
+
+  for (i = 0; i < max && depth + i < len; ++i)
+    if (n->prefix[i] != key[depth + i]) return 0;
+  return 1;
+}
+
+// length of the prefix of n matching key, the bytes that are not kept are
+// read from a leaf below n
+static U32 prefix_mismatch(node_t *n, const U8 *key, U32 len, U32 depth)
+{
+  const U32 max = n->prefix_len < PREFIX ? n->prefix_len : PREFIX;
+  const U8 *full;
+  U32       i;
+
+  for (i = 0; i < max; ++i)
+    if (depth + i >= len || n->prefix[i] != key[depth + i]) return i;
+  if (n->prefix_len > PREFIX)
+  {
+    full = leaf_key(min_leaf(n));
+    for (; i < n->prefix_len; ++i)
+      if (depth + i >= len || full[depth + i] != key[depth + i]) return i;
+  }
+  return i;
+}
+
+// ---------------------------------------------------------------
+// Tree
+// ---------------------------------------------------------------
+
+void _gpr_radix_tree_init(gpr_radix_tree_t *t, gpr_allocator_t *a)
+{
+  t->root       = NULL;
+  t->num_values = 0;
+  t->allocator  = a;
+}
+
+static void free_subtree(gpr_radix_tree_t *t, void *c)
+{
+  node_t *n;
+  void   *child;
+  U32     pos = 0;
+
+  if (is_leaf(c))
+  {
+    free_leaf(t, as_leaf(c));
+    return;
+  }
+  n = (node_t*)c;
+  if (n->leaf) free_leaf(t, n->leaf);
+  while ((child = next_child(n, &pos)) != NULL) free_subtree(t, child);
+  gpr_deallocate(t->allocator, n);
+}
+
+void _gpr_radix_tree_destroy(gpr_radix_tree_t *t)
+{
+  if (t->root) free_subtree(t, t->root);
+  t->root = NULL;
+}
+
+static leaf_t *find_leaf(gpr_radix_tree_t *t, const U8 *key, U32 len)
+{
+  void   *c = t->root;
+  void  **child;
+  node_t *n;
+  U32     depth = 0;
+
+  while (c)
+  {
+    if (is_leaf(c)) return leaf_matches(as_leaf(c), key, len) ? as_leaf(c) : NULL;
+    n = (node_t*)c;
+    if (!check_prefix(n, key, len, depth)) return NULL;
+    depth += n->prefix_len;
+    if (depth >= len)
+      return depth == len && n->leaf && leaf_matches(n->leaf, key, len) ? n->leaf : NULL;
+    child = find_child(n, key[depth]);
+    if (child == NULL) return NULL;
+    c = *child;
+    ++depth;
+  }
+  return NULL;
+}
+
+I32 _gpr_radix_tree_has(gpr_radix_tree_t *t, const void *key, U32 len)
+{
+  return find_leaf(t, (const U8*)key, len) != NULL;
+}
+
+void *_gpr_radix_tree_get(gpr_radix_tree_t *t, const void *key, U32 len)
+{
+  leaf_t *l = find_leaf(t, (const U8*)key, len);
+  return l ? leaf_value(l) : NULL;
+}
+
+// l as the entry of n for the byte at depth, or as its own leaf
+static void add_leaf(gpr_radix_tree_t *t, void **ref, node_t *n, U32 depth, leaf_t *l)
+{
+  if (l->len == depth) n->leaf = l;
+  else add_child(t, ref, n, leaf_key(l)[depth], tag_leaf(l));
+}
+
+void _gpr_radix_tree_set(gpr_radix_tree_t *t, const U32 s, const void *key_, U32 len,
+                         const void *value)
+{
+  const U8 *key = (const U8*)key_;
+  void    **ref = &t->root, **child;
+  node_t   *n, *split;
+  leaf_t   *l;
+  U32       depth = 0, p;
+  U8        byte;
+
+  for (;;)
+  {
+    if (*ref == NULL)
+    {
+      *ref = tag_leaf(new_leaf(t, s, key, len, value));
+      return;
+    }
+
+    if (is_leaf(*ref))
+    {
+      l = as_leaf(*ref);
+      if (leaf_matches(l, key, len))
+      {
+        memcpy(leaf_value(l), value, s);
+        return;
+      }
+      // both keys below a node branching where they differ
+      for (p = depth; p < len && p < l->len && leaf_key(l)[p] == key[p]; ++p) {}
+      split = new_node(t, NODE4);
+      split->prefix_len = p - depth;
+      memcpy(split->prefix, key + depth, p - depth < PREFIX ? p - depth : PREFIX);
+      *ref = split;
+      add_leaf(t, ref, split, p, l);
+      add_leaf(t, ref, split, p, new_leaf(t, s, key, len, value));
+      return;
+    }
+
+    n = (node_t*)*ref;
+    if (n->prefix_len)
+    {
+      p = prefix_mismatch(n, key, len, depth);
+      if (p < n->prefix_len)
+      {
+        // n keeps the end of its prefix below a node branching at p
+        split = new_node(t, NODE4);
+        split->prefix_len = p;
+        memcpy(split->prefix, n->prefix, p < PREFIX ? p : PREFIX);
+        if (n->prefix_len <= PREFIX)
+        {
+          byte = n->prefix[p];
+          n->prefix_len -= p + 1;
+          memmove(n->prefix, n->prefix + p + 1, n->prefix_len);
+        }
+        else
+        {
+          const U8 *full = leaf_key(min_leaf(n)) + depth + p;
+          byte = full[0];
+          n->prefix_len -= p + 1;
+          memcpy(n->prefix, full + 1, n->prefix_len < PREFIX ? n->prefix_len : PREFIX);
+        }
+        *ref = split;
+        add_child(t, ref, split, byte, n);
+        add_leaf(t, ref, split, depth + p, new_leaf(t, s, key, len, value));
+        return;
+      }
+      depth += n->prefix_len;
+    }
+
+    if (depth == len)
+    {
+      if (n->leaf) memcpy(leaf_value(n->leaf), value, s);
+      else n->leaf = new_leaf(t, s, key, len, value);
+      return;
+    }
+
+    child = find_child(n, key[depth]);
+    if (child == NULL)
+    {
+      add_child(t, ref, n, key[depth], tag_leaf(new_leaf(t, s, key, len, value)));
+      return;
+    }
+    ref = child;
+    ++depth;
+  }
+}
+
+I32 _gpr_radix_tree_remove(gpr_radix_tree_t *t, const void *key_, U32 len)
+{
+  const U8 *key = (const U8*)key_;
+  void    **ref = &t->root, **child;
+  node_t   *n;
+  U32       depth = 0;
+
+  while (*ref)
+  {
+    if (is_leaf(*ref))
+    {
+      // only the root is reached as a leaf
+      if (!leaf_matches(as_leaf(*ref), key, len)) return 0;
+      free_leaf(t, as_leaf(*ref));
+      *ref = NULL;
+      return 1;
+    }
+
+    n = (node_t*)*ref;
+    if (!check_prefix(n, key, len, depth)) return 0;
+    depth += n->prefix_len;
+    if (depth >= len)
+    {
+      if (depth > len || !n->leaf || !leaf_matches(n->leaf, key, len)) return 0;
+      free_leaf(t, n->leaf);
+      n->leaf = NULL;
+      if (n->num_children == 1) collapse(t, ref, n);
+      return 1;
+    }
+
+    child = find_child(n, key[depth]);
+    if (child == NULL) return 0;
+    if (is_leaf(*child))
+    {
+      if (!leaf_matches(as_leaf(*child), key, len)) return 0;
+      free_leaf(t, as_leaf(*child));
+      remove_child(t, ref, n, key[depth]);
+      return 1;
+    }
+    ref = child;
+    ++depth;
+  }
+  return 0;
+}
+
+U32 _gpr_radix_tree_size(gpr_radix_tree_t *t)
+{
+  return t->num_values;
+}
+
+void *_gpr_radix_tree_longest_prefix(gpr_radix_tree_t *t, const void *key_, U32 len,
+                                     U32 *prefix_len)
+{
+  const U8 *key  = (const U8*)key_;
+  void     *c    = t->root;
+  void    **child;
+  node_t   *n;
+  leaf_t   *best = NULL;
+  U32       depth = 0;
+
+  // the keys found on the way get longer, the first one that is not a
+  // prefix of key means that the path left it
+  while (c)
+  {
+    if (is_leaf(c))
+    {
+      if (leaf_is_prefix(as_leaf(c), key, len)) best = as_leaf(c);
+      break;
+    }
+    n = (node_t*)c;
+    if (!check_prefix(n, key, len, depth)) break;
+    depth += n->prefix_len;
+    if (depth > len) break;
+    if (n->leaf)
+    {
+      if (!leaf_is_prefix(n->leaf, key, len)) break;
+      best = n->leaf;
+    }
+    if (depth == len) break;
+    child = find_child(n, key[depth]);
+    if (child == NULL) break;
+    c = *child;
+    ++depth;
+  }
+
+  if (best == NULL) return NULL;
+  if (prefix_len) *prefix_len = best->len;
+  return leaf_value(best);
+}
+
+static I32 visit_subtree(void *c, gpr_radix_tree_visit_t visit, void *arg, U32 *count)
+{
+  node_t *n;
+  leaf_t *l;
+  void   *child;
+  U32     pos = 0;
+
+  if (is_leaf(c))
+  {
+    l = as_leaf(c);
+    ++*count;
+    return visit(leaf_key(l), l->len, leaf_value(l), arg);
+  }
+  n = (node_t*)c;
+  if (n->leaf)
+  {
+    ++*count;
+    if (!visit(leaf_key(n->leaf), n->leaf->len, leaf_value(n->leaf), arg)) return 0;
+  }
+  while ((child = next_child(n, &pos)) != NULL)
+    if (!visit_subtree(child, visit, arg, count)) return 0;
+  return 1;
+}
+
+U32 _gpr_radix_tree_visit_prefix(gpr_radix_tree_t *t, const void *prefix_, U32 len,
+                                 gpr_radix_tree_visit_t visit, void *arg)
+{
+  const U8 *prefix = (const U8*)prefix_;
+  void     *c      = t->root;
+  void    **child;
+  node_t   *n;
+  leaf_t   *l;
+  U32       depth = 0, count = 0;
+
+  // down to the first node whose path covers the prefix
+  while (c && !is_leaf(c) && depth + ((node_t*)c)->prefix_len < len)
+  {
+    n = (node_t*)c;
+    if (!check_prefix(n, prefix, len, depth)) return 0;
+    depth += n->prefix_len;
+    child = find_child(n, prefix[depth]);
+    if (child == NULL) return 0;
+    c = *child;
+    ++depth;
+  }
+  if (c == NULL) return 0;
+
+  // the keys below c share their first bytes: checking one of them is enough
+  l = min_leaf(c);
+  if (l->len < len || memcmp(leaf_key(l), prefix, len) != 0) return 0;
+  visit_subtree(c, visit, arg, &count);
+  return count;
+}
@@ -0,0 +1,138 @@
+#include <string.h>
+#include "gpr_rcu_hash.h"
+#include "gpr_atomic.h"
+#include "gpr_assert.h"
+#include "gpr_memory.h"
+
+static void free_version(void *p, gpr_allocator_t *a)
+{
+  _gpr_hash_destroy((gpr_hash_t*)p);
+  gpr_deallocate(a, p);
+}
+
+// the copy is rebuilt from the dense keys & values: it is compact and
+// has no migration pending
+static gpr_hash_t *copy_version(gpr_rcu_hash_t *rh, gpr_hash_t *src)
+{
+  // 8 bytes aligned for the atomic U64 counters of GPR_HASH_STATS
+  gpr_hash_t *h = (gpr_hash_t*)gpr_allocate_align(rh->allocator, sizeof(gpr_hash_t), 8);
+  gpr_assert_alloc(h);
+  _gpr_hash_init(h, rh->value_size, rh->allocator);
+  if (src && src->num_values)
+  {
+    _gpr_hash_build(h, rh->value_size, src->keys.data, src->values.data,
+      src->num_values);
+  }
+  return h;
+}
+
+static gpr_hash_t *load_root(gpr_rcu_hash_t *rh)
+{
+  return (gpr_hash_t*)gpr_atomic_load_ptr((void*volatile*)&rh->root);
+}
+
+void _gpr_rcu_hash_init(gpr_rcu_hash_t *rh, const U32 s, gpr_epoch_t *e,
+                        gpr_allocator_t *a)
+{
+  rh->epoch      = e;
+  rh->allocator  = a;
+  rh->value_size = s;
+  rh->next       = NULL;
+  gpr_mutex_init(&rh->lock);
+  rh->root = copy_version(rh, NULL);
+}
+
+void gpr_rcu_hash_destroy(gpr_rcu_hash_t *rh)
+{
+  gpr_assert_msg(rh->next == NULL, "a write is still in progress");
+  free_version(rh->root, rh->allocator);
+}
+
+// ---------------------------------------------------------------
+// Readers
+// ---------------------------------------------------------------
+
+gpr_hash_t *gpr_rcu_hash_enter(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t)
+{
+  // the root is loaded after the thread is published in the epoch
+  gpr_epoch_enter(rh->epoch, t);
+  return load_root(rh);
+}
+
+void gpr_rcu_hash_exit(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t)
+{
+  gpr_epoch_exit(rh->epoch, t);
+}
+
+I32 gpr_rcu_hash_has(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t, U64 key)
+{
+  I32 res = _gpr_hash_has(gpr_rcu_hash_enter(rh, t), key);
+  gpr_rcu_hash_exit(rh, t);
+  return res;
+}
+
+I32 _gpr_rcu_hash_get(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t, const U32 s,
+                      U64 key, void *value)
+{
+  void *e = _gpr_hash_get(gpr_rcu_hash_enter(rh, t), key);
+  if (e) memcpy(value, e, s);
+  gpr_rcu_hash_exit(rh, t);
+  return e != NULL;
+}
+
+// ---------------------------------------------------------------
+// Writers
+// ---------------------------------------------------------------
+
+gpr_hash_t *gpr_rcu_hash_write_begin(gpr_rcu_hash_t *rh)
+{
+  gpr_mutex_lock(&rh->lock);
+  // only writers replace the root and they hold the lock
+  rh->next = copy_version(rh, rh->root);
+  return rh->next;
+}
+
+void gpr_rcu_hash_write_end(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t)
+{
+  gpr_hash_t *old = rh->root;
+
+  // the store releases the writes to the new version
+  gpr_atomic_store_ptr((void*volatile*)&rh->root, rh->next);
+  rh->next = NULL;
+  gpr_mutex_unlock(&rh->lock);
+
+  gpr_epoch_retire_func(rh->epoch, t, old, rh->allocator, free_version);
+}
+
+void gpr_rcu_hash_write_cancel(gpr_rcu_hash_t *rh)
+{
+  free_version(rh->next, rh->allocator);
+  rh->next = NULL;
+  gpr_mutex_unlock(&rh->lock);
+}
+
+void _gpr_rcu_hash_set(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t, const U32 s,
+                       U64 key, const void *value)
+{
+  _gpr_hash_set(gpr_rcu_hash_write_begin(rh), s, key, value);
+  gpr_rcu_hash_write_end(rh, t);
+}
+
+I32 _gpr_rcu_hash_remove(gpr_rcu_hash_t *rh, gpr_epoch_thread_t *t, const U32 s,
+                         U64 key)
+{
+  gpr_hash_t *h;
+
+  // checked on the current version first: a miss costs no copy
+  if (!gpr_rcu_hash_has(rh, t, key)) return 0;
+
+  h = gpr_rcu_hash_write_begin(rh);
+  if (!_gpr_hash_has(h, key))
+  {
+    gpr_rcu_hash_write_cancel(rh);
+    return 0;
+  }
+  _gpr_hash_remove(h, s, key);
+  gpr_rcu_hash_write_end(rh, t);
+  return 1;
+}
@@ -0,0 +1,667 @@
+#include "gpr_string_pool.h"
+#include "gpr_atomic.h"
+#include "gpr_assert.h"
+
+typedef gpr_string_header_t     header_t;
+typedef gpr_string_pool_shard_t shard_t;
+typedef gpr_string_pool_snapshot_t snapshot_t;
+
+#define UNIT 8
+
+static char *chars(header_t *e)
+{
+  return (char*)(e + 1);
+}
+
+static shard_t *shard_at(gpr_string_pool_t *pool, U32 i)
+{
+  return (shard_t*)(pool->shards + i*pool->shard_stride);
+}
+
+// fibonacci hashing: the high bits depend on every bit of the hash, the
+// buckets of the shard map use the low bits
+static U32 shard_index(gpr_string_pool_t *pool, U64 hash)
+{
+  return (U32)((hash*0x9e3779b97f4a7c15ull) >> 40) & ((1u << pool->shard_bits) - 1);
+}
+
+static shard_t *id_shard(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  return shard_at(pool, id & ((1u << pool->shard_bits) - 1));
+}
+
+// the directory is replaced while lock-free readers use it, its pages
+// never move
+static header_t **id_slot(shard_t *shard, U32 local)
+{
+  header_t ***pages = (header_t***)gpr_atomic_load_ptr((void*volatile*)&shard->pages);
+  return &pages[local/GPR_STRING_POOL_PAGE][local % GPR_STRING_POOL_PAGE];
+}
+
+// the mapping is read-only: the headers of a snapshot are never written
+static header_t *mapped_header(gpr_string_pool_t *pool, U32 i)
+{
+  gpr_assert_msg(pool->snapshot && i < pool->snapshot->num_strings,
+    "invalid string id");
+  return (header_t*)(pool->snapshot_map.data + pool->offsets[i]);
+}
+
+static header_t *header(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  const U32 local = id >> pool->shard_bits;
+  shard_t  *shard = id_shard(pool, id);
+
+  if (id & GPR_STRING_POOL_MAPPED)
+    return mapped_header(pool, id & ~GPR_STRING_POOL_MAPPED);
+
+  // num_ids is only stable out of concurrent pools
+  gpr_assert_msg(local != 0 && (pool->concurrent || local < shard->num_ids) &&
+    *id_slot(shard, local), "invalid string id");
+  return *id_slot(shard, local);
+}
+
+// ---------------------------------------------------------------
+// Locks, no-ops out of concurrent pools
+// ---------------------------------------------------------------
+
+static void read_lock(gpr_string_pool_t *pool, shard_t *shard)
+{
+  if (pool->concurrent) gpr_rwlock_read_lock(&shard->lock);
+}
+
+static void read_unlock(gpr_string_pool_t *pool, shard_t *shard)
+{
+  if (pool->concurrent) gpr_rwlock_read_unlock(&shard->lock);
+}
+
+static void write_lock(gpr_string_pool_t *pool, shard_t *shard)
+{
+  if (pool->concurrent) gpr_rwlock_write_lock(&shard->lock);
+}
+
+static void write_unlock(gpr_string_pool_t *pool, shard_t *shard)
+{
+  if (pool->concurrent) gpr_rwlock_write_unlock(&shard->lock);
+}
+
+static void add_ref(gpr_string_pool_t *pool, header_t *e)
+{
+  if (pool->concurrent) gpr_atomic_add_U32(&e->refs, 1);
+  else ++e->refs;
+}
+
+// ---------------------------------------------------------------
+// Slots & ids
+// ---------------------------------------------------------------
+
+// a slot of units from the free list of its class or from the current chunk
+static header_t *allocate_slot(gpr_string_pool_t *pool, shard_t *shard, U32 units)
+{
+  const U32 bytes = units*UNIT;
+  header_t *e;
+
+  if (units > GPR_STRING_POOL_CLASSES)
+  {
+    e = (header_t*)gpr_allocate_align(pool->string_allocator, bytes, UNIT);
+    e->units = 0;
+    return e;
+  }
+
+  e = shard->free_slots[units - 1];
+  if (e)
+  {
+    shard->free_slots[units - 1] = *(header_t**)e;
+    e->units = units;
+    return e;
+  }
+
+  if (shard->chunk_pos + bytes > shard->chunk_end)
+  {
+    char *chunk = (char*)gpr_allocate_align(pool->string_allocator,
+      GPR_STRING_POOL_CHUNK, UNIT);
+    gpr_array_push_back(char*, &shard->chunks, chunk);
+    shard->chunk_pos = chunk;
+    shard->chunk_end = chunk + GPR_STRING_POOL_CHUNK;
+  }
+  e = (header_t*)shard->chunk_pos;
+  shard->chunk_pos += bytes;
+  e->units = units;
+  return e;
+}
+
+static void deallocate_slot(gpr_string_pool_t *pool, shard_t *shard, header_t *e)
+{
+  if (e->units == 0)
+  {
+    gpr_deallocate(pool->string_allocator, e);
+    return;
+  }
+  *(header_t**)e = shard->free_slots[e->units - 1];
+  shard->free_slots[e->units - 1] = e;
+}
+
+// adds the page of the next id, the directory is doubled when full: the
+// copy is published once complete and the old one is kept
+static void add_page(gpr_string_pool_t *pool, shard_t *shard)
+{
+  const U32  page_i = shard->num_ids/GPR_STRING_POOL_PAGE;
+  header_t ***pages = shard->pages;
+
+  if (page_i == shard->num_pages)
+  {
+    shard->num_pages = page_i ? page_i*2 : GPR_STRING_POOL_PAGES;
+    pages = (header_t***)gpr_allocate(pool->map_allocator,
+      shard->num_pages*sizeof(header_t**));
+    if (page_i)
+    {
+      memcpy(pages, shard->pages, page_i*sizeof(header_t**));
+      gpr_array_push_back(void*, &shard->old_pages, shard->pages);
+    }
+  }
+  pages[page_i] = (header_t**)gpr_allocate(pool->map_allocator,
+    GPR_STRING_POOL_PAGE*sizeof(header_t*));
+  gpr_atomic_store_ptr((void*volatile*)&shard->pages, pages);
+}
+
+// a local id for e, 0 if the shard has none left
+static U32 allocate_id(gpr_string_pool_t *pool, shard_t *shard, header_t *e)
+{
+  U32 local;
+
+  if (gpr_array_any(&shard->free_ids)) local = gpr_array_pop_back(&shard->free_ids);
+  else
+  {
+    local = shard->num_ids;
+    if (local == GPR_STRING_POOL_MAPPED >> pool->shard_bits) return 0;
+    if (local % GPR_STRING_POOL_PAGE == 0) add_page(pool, shard);
+    ++shard->num_ids;
+  }
+  *id_slot(shard, local) = e;
+  return local;
+}
+
+static void init(gpr_string_pool_t *pool, U32 num_shards, I32 concurrent,
+                 gpr_allocator_t *map_allocator, gpr_allocator_t *string_allocator)
+{
+  U32 i, j;
+
+  num_shards = gpr_next_pow2_U32(num_shards ? num_shards : 1);
+  gpr_assert(num_shards <= GPR_STRING_POOL_MAX_SHARDS);
+
+  pool->shard_bits = 0;
+  while ((1u << pool->shard_bits) < num_shards) ++pool->shard_bits;
+  pool->concurrent       = concurrent;
+  pool->map_allocator    = map_allocator;
+  pool->string_allocator = string_allocator;
+  pool->shard_stride     = gpr_next_multiple(sizeof(shard_t), GPR_STRING_POOL_ALIGN);
+  pool->shards           = (char*)gpr_allocate_align(map_allocator,
+    num_shards*pool->shard_stride, GPR_STRING_POOL_ALIGN);
+  pool->snapshot         = NULL;
+  pool->offsets          = NULL;
+  pool->buckets          = NULL;
+
+  for (i = 0; i < num_shards; ++i)
+  {
+    shard_t *shard = shard_at(pool, i);
+    if (concurrent) gpr_rwlock_init(&shard->lock);
+    gpr_hash_init (gpr_string_t, &shard->string_map, map_allocator);
+    gpr_array_init(U32,          &shard->free_ids,   map_allocator);
+    gpr_array_init(char*,        &shard->chunks,     map_allocator);
+    gpr_array_init(void*,        &shard->old_pages,  map_allocator);
+    shard->pages     = NULL;
+    shard->num_pages = 0;
+    shard->chunk_pos = shard->chunk_end = NULL;
+    for (j = 0; j < GPR_STRING_POOL_CLASSES; ++j) shard->free_slots[j] = NULL;
+    // local id 0: id 0 of the first shard is GPR_STRING_NULL
+    shard->num_ids = 0;
+    allocate_id(pool, shard, NULL);
+  }
+}
+
+void gpr_string_pool_init(gpr_string_pool_t *pool, gpr_allocator_t *map_allocator,
+                          gpr_allocator_t *string_allocator)
+{
+  init(pool, 1, 0, map_allocator, string_allocator);
+}
+
+void gpr_string_pool_init_concurrent(gpr_string_pool_t *pool, U32 num_shards,
+                                     gpr_allocator_t *map_allocator,
+                                     gpr_allocator_t *string_allocator)
+{
+  init(pool, num_shards, 1, map_allocator, string_allocator);
+}
+
+void gpr_string_pool_destroy(gpr_string_pool_t *pool)
+{
+  U32 i, local;
+
+  for (i = 0; i < (1u << pool->shard_bits); ++i)
+  {
+    shard_t *shard = shard_at(pool, i);
+    char   **c     = gpr_array_begin(&shard->chunks);
+    void   **d     = gpr_array_begin(&shard->old_pages);
+
+    for (local = 0; local < shard->num_ids; ++local)
+    {
+      header_t *e = *id_slot(shard, local);
+      if (e && e->units == 0) gpr_deallocate(pool->string_allocator, e);
+    }
+    for (local = 0; local < shard->num_ids; local += GPR_STRING_POOL_PAGE)
+      gpr_deallocate(pool->map_allocator, shard->pages[local/GPR_STRING_POOL_PAGE]);
+    gpr_deallocate(pool->map_allocator, shard->pages);
+    for (; d < gpr_array_end(&shard->old_pages); ++d)
+      gpr_deallocate(pool->map_allocator, *d);
+    for (; c < gpr_array_end(&shard->chunks); ++c)
+      gpr_deallocate(pool->string_allocator, *c);
+
+    gpr_hash_destroy (gpr_string_t, &shard->string_map);
+    gpr_array_destroy(&shard->free_ids);
+    gpr_array_destroy(&shard->chunks);
+    gpr_array_destroy(&shard->old_pages);
+  }
+  gpr_deallocate(pool->map_allocator, pool->shards);
+  if (pool->snapshot) gpr_file_unmap(&pool->snapshot_map);
+}
+
+// ---------------------------------------------------------------
+// Ids
+// ---------------------------------------------------------------
+
+// distinct strings may share a hash: the string is compared too
+static I32 equal(const header_t *e, const char *string, U32 size)
+{
+  return e->size == size && memcmp(chars((header_t*)e), string, size) == 0;
+}
+
+// the snapshot never changes: it is probed with no lock
+static gpr_string_t find_mapped(gpr_string_pool_t *pool, U64 hash, const char *string,
+                                U32 size)
+{
+  U32       mask, i, b;
+  header_t *e;
+
+  if (pool->snapshot == NULL) return GPR_STRING_NULL;
+  mask = pool->snapshot->num_buckets - 1;
+  for (i = (U32)hash & mask; (b = pool->buckets[i]) != 0; i = (i + 1) & mask)
+  {
+    e = mapped_header(pool, b - 1);
+    if (e->hash == hash && equal(e, string, size)) return GPR_STRING_POOL_MAPPED | (b - 1);
+  }
+  return GPR_STRING_NULL;
+}
+
+// the map is a multi hash: the ids of colliding strings share its key
+static gpr_string_t find_local(gpr_string_pool_t *pool, shard_t *shard, U64 hash,
+                               const char *string, U32 size)
+{
+  gpr_hash_it         it;
+  const gpr_string_t *found = gpr_multi_hash_find_first(gpr_string_t,
+    &shard->string_map, &it, hash);
+
+  for (; found; found = gpr_multi_hash_find_next(gpr_string_t, &shard->string_map, &it))
+    if (equal(header(pool, *found), string, size)) return *found;
+  return GPR_STRING_NULL;
+}
+
+gpr_string_t gpr_string_pool_find_id(gpr_string_pool_t *pool, const char *string,
+                                     U32 size)
+{
+  const U64     hash  = gpr_murmur_hash_64(string, size, 0);
+  shard_t      *shard = shard_at(pool, shard_index(pool, hash));
+  gpr_string_t  id    = find_mapped(pool, hash, string, size);
+
+  if (id != GPR_STRING_NULL) return id;
+  read_lock(pool, shard);
+  id = find_local(pool, shard, hash, string, size);
+  read_unlock(pool, shard);
+  return id;
+}
+
+// takes a reference on the id of string, GPR_STRING_NULL if missing
+static gpr_string_t get_id(gpr_string_pool_t *pool, shard_t *shard, U64 hash,
+                           const char *string, U32 size)
+{
+  const gpr_string_t id = find_local(pool, shard, hash, string, size);
+  if (id != GPR_STRING_NULL) add_ref(pool, header(pool, id));
+  return id;
+}
+
+// interns string, whose hash is already known
+static gpr_string_t intern(gpr_string_pool_t *pool, U64 hash, const char *string,
+                           U32 size)
+{
+  const U32    shard_i = shard_index(pool, hash);
+  shard_t     *shard   = shard_at(pool, shard_i);
+  gpr_string_t id     = find_mapped(pool, hash, string, size);
+  header_t    *e;
+  U32          local;
+
+  if (id != GPR_STRING_NULL) return id;
+
+  // interned strings only need the read lock
+  read_lock(pool, shard);
+  id = get_id(pool, shard, hash, string, size);
+  read_unlock(pool, shard);
+  if (id != GPR_STRING_NULL) return id;
+
+  // another thread may have added it since
+  write_lock(pool, shard);
+  id = get_id(pool, shard, hash, string, size);
+  if (id == GPR_STRING_NULL)
+  {
+    e = allocate_slot(pool, shard, (U32)((sizeof(header_t) + size + UNIT)/UNIT));
+    local = allocate_id(pool, shard, e);
+    if (local == 0)
+    {
+      deallocate_slot(pool, shard, e);
+      write_unlock(pool, shard);
+      return GPR_STRING_NULL;
+    }
+    e->hash = hash;
+    e->size = size;
+    e->refs = 1;
+    memcpy(chars(e), string, size);
+    chars(e)[size] = '\0';
+
+    id = (local << pool->shard_bits) | shard_i;
+    e->id = id;
+    gpr_multi_hash_insert(gpr_string_t, &shard->string_map, hash, &id);
+  }
+  write_unlock(pool, shard);
+  return id;
+}
+
+gpr_string_t gpr_string_pool_nget_id(gpr_string_pool_t *pool, const char *string,
+                                     U32 size)
+{
+  return intern(pool, gpr_murmur_hash_64(string, size, 0), string, size);
+}
+
+// hashes are computed by groups of BATCH_SIZE
+#define BATCH_SIZE 64
+
+void gpr_string_pool_nget_ids(gpr_string_pool_t *pool, const char *const *strings,
+                              const U32 *sizes, U32 n, gpr_string_t *ids)
+{
+  U64 hashes[BATCH_SIZE];
+  U32 i, j, count;
+
+  for (i = 0; i < n; i += count)
+  {
+    count = n - i < BATCH_SIZE ? n - i : BATCH_SIZE;
+    gpr_hash_batch_64((const void *const*)(strings + i), sizes + i, count, 0, hashes);
+    for (j = 0; j < count; ++j)
+      ids[i + j] = intern(pool, hashes[j], strings[i + j], sizes[i + j]);
+  }
+}
+
+gpr_string_t gpr_string_pool_get_id(gpr_string_pool_t *pool, const char *string)
+{
+  return gpr_string_pool_nget_id(pool, string, (U32)strlen(string));
+}
+
+void gpr_string_pool_acquire(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  if (!(id & GPR_STRING_POOL_MAPPED)) add_ref(pool, header(pool, id));
+}
+
+// removes the map entry of id, not those of the strings sharing its hash
+static void remove_id(shard_t *shard, U64 hash, gpr_string_t id)
+{
+  gpr_hash_it   it;
+  gpr_string_t *found = gpr_multi_hash_find_first(gpr_string_t, &shard->string_map,
+    &it, hash);
+
+  while (*found != id)
+    found = gpr_multi_hash_find_next(gpr_string_t, &shard->string_map, &it);
+  gpr_multi_hash_remove(gpr_string_t, &shard->string_map, found);
+}
+
+void gpr_string_pool_release_id(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  header_t *e;
+  shard_t  *shard = id_shard(pool, id);
+  U32       refs;
+
+  if (id & GPR_STRING_POOL_MAPPED) return;
+  e = header(pool, id);
+
+  if (pool->concurrent)
+  {
+    // the last reference is dropped under the write lock: a lookup under
+    // the read lock can't revive a string being removed
+    for (;;)
+    {
+      refs = gpr_atomic_load_U32(&e->refs);
+      if (refs == 1) break;
+      if (gpr_atomic_cas_U32(&e->refs, refs, refs - 1)) return;
+    }
+    write_lock(pool, shard);
+    if (gpr_atomic_add_U32(&e->refs, (U32)-1) > 1)
+    {
+      write_unlock(pool, shard);
+      return;
+    }
+  }
+  else if (--e->refs > 0) return;
+
+  remove_id(shard, e->hash, id);
+  *id_slot(shard, id >> pool->shard_bits) = NULL;
+  gpr_array_push_back(U32, &shard->free_ids, id >> pool->shard_bits);
+  deallocate_slot(pool, shard, e);
+  write_unlock(pool, shard);
+}
+
+const char *gpr_string_pool_string(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  return chars(header(pool, id));
+}
+
+U32 gpr_string_pool_size(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  return header(pool, id)->size;
+}
+
+U64 gpr_string_pool_hash(gpr_string_pool_t *pool, gpr_string_t id)
+{
+  return header(pool, id)->hash;
+}
+
+gpr_string_t gpr_string_pool_id(const char *pooled)
+{
+  return ((const header_t*)pooled - 1)->id;
+}
+
+// ---------------------------------------------------------------
+// char* interface
+// ---------------------------------------------------------------
+
+char *gpr_string_pool_nget(gpr_string_pool_t *pool, const char *string, U32 size)
+{
+  const gpr_string_t id = gpr_string_pool_nget_id(pool, string, size);
+  return id == GPR_STRING_NULL ? NULL : chars(header(pool, id));
+}
+
+char *gpr_string_pool_get(gpr_string_pool_t *pool, const char *string)
+{
+  return gpr_string_pool_nget(pool, string, (U32)strlen(string));
+}
+
+I32 gpr_string_pool_has(gpr_string_pool_t *pool, const char *string)
+{
+  return gpr_string_pool_find_id(pool, string, (U32)strlen(string)) != GPR_STRING_NULL;
+}
+
+void gpr_string_pool_release(gpr_string_pool_t *pool, char *string)
+{
+  const gpr_string_t id = gpr_string_pool_find_id(pool, string, (U32)strlen(string));
+
+  gpr_assert_msg(id != GPR_STRING_NULL, "the string is not pooled");
+  gpr_string_pool_release_id(pool, id);
+}
+
+void gpr_string_pool_release_pooled(gpr_string_pool_t *pool, const char *pooled)
+{
+  const gpr_string_t id = gpr_string_pool_id(pooled);
+
+  gpr_assert_msg(gpr_string_pool_string(pool, id) == pooled,
+    "the string was not returned by the pool");
+  gpr_string_pool_release_id(pool, id);
+}
+
+// ---------------------------------------------------------------
+// Snapshots
+// ---------------------------------------------------------------
+
+static U32 record_size(U32 size)
+{
+  return gpr_next_multiple(sizeof(header_t) + size + 1, UNIT);
+}
+
+// copies e as string i of the snapshot blob
+static void add_record(char *blob, const snapshot_t *snapshot, U32 *pos, U32 i,
+                       const header_t *e)
+{
+  header_t *r    = (header_t*)(blob + *pos);
+  U32      *b    = (U32*)(blob + snapshot->buckets_pos);
+  const U32 mask = snapshot->num_buckets - 1;
+  U32       j;
+
+  r->hash  = e->hash;
+  r->size  = e->size;
+  r->refs  = 0;
+  r->id    = GPR_STRING_POOL_MAPPED | i;
+  r->units = 0;
+  memcpy(chars(r), chars((header_t*)e), e->size + 1);
+  ((U32*)(blob + snapshot->offsets_pos))[i] = *pos;
+  *pos += record_size(e->size);
+
+  for (j = (U32)e->hash & mask; b[j] != 0; j = (j + 1) & mask) {}
+  b[j] = i + 1;
+}
+
+I32 gpr_string_pool_save(gpr_string_pool_t *pool, const char *path)
+{
+  const U32   num_shards = 1u << pool->shard_bits;
+  const U32   num_mapped = pool->snapshot ? pool->snapshot->num_strings : 0;
+  U64         n = num_mapped, strings_size = 0, size;
+  U32         i, local, pos;
+  snapshot_t  s;
+  char       *blob;
+  I32         res = 0;
+
+  for (i = 0; i < num_shards; ++i) read_lock(pool, shard_at(pool, i));
+
+  for (i = 0; i < num_mapped; ++i)
+    strings_size += record_size(mapped_header(pool, i)->size);
+  for (i = 0; i < num_shards; ++i)
+  {
+    shard_t *shard = shard_at(pool, i);
+    for (local = 1; local < shard->num_ids; ++local)
+    {
+      const header_t *e = *id_slot(shard, local);
+      if (e == NULL) continue;
+      strings_size += record_size(e->size);
+      ++n;
+    }
+  }
+
+  // string indices must not reach the mapped flag, offsets are 32 bits
+  s.num_buckets = n < GPR_STRING_POOL_MAPPED/2 ? gpr_next_pow2_U32((U32)n*2 + 1) : 0;
+  size = gpr_next_multiple(sizeof(snapshot_t) + (n + s.num_buckets)*sizeof(U32), UNIT);
+  size += strings_size;
+  if (s.num_buckets != 0 && size <= 0xffffffffu)
+  {
+    s.offsets_pos = sizeof(snapshot_t);
+    s.buckets_pos = s.offsets_pos + (U32)n*sizeof(U32);
+    s.strings_pos = gpr_next_multiple(s.buckets_pos + s.num_buckets*sizeof(U32), UNIT);
+    s.magic       = GPR_STRING_POOL_MAGIC;
+    s.num_strings = (U32)n;
+    s.size        = (U32)size;
+    s.pad         = 0;
+
+    blob = (char*)gpr_allocate_align(pool->map_allocator, s.size, UNIT);
+    memset(blob, 0, s.size);
+    memcpy(blob, &s, sizeof(s));
+
+    // the strings of the snapshot first, at the same indices
+    pos = s.strings_pos;
+    for (i = 0; i < num_mapped; ++i)
+      add_record(blob, &s, &pos, i, mapped_header(pool, i));
+    n = num_mapped;
+    for (i = 0; i < num_shards; ++i)
+    {
+      shard_t *shard = shard_at(pool, i);
+      for (local = 1; local < shard->num_ids; ++local)
+        if (*id_slot(shard, local))
+          add_record(blob, &s, &pos, (U32)n++, *id_slot(shard, local));
+    }
+
+    res = gpr_file_write(path, blob, s.size);
+    gpr_deallocate(pool->map_allocator, blob);
+  }
+
+  for (i = 0; i < num_shards; ++i) read_unlock(pool, shard_at(pool, i));
+  return res;
+}
+
+// lookups read the record of any bucket and the chars of any record: all
+// of them must lie in the blob. an empty bucket must be left to end probes
+static I32 valid_entries(const char *data, const snapshot_t *s)
+{
+  const U32      *offsets = (const U32*)(data + s->offsets_pos);
+  const U32      *buckets = (const U32*)(data + s->buckets_pos);
+  const header_t *e;
+  U32             i, used = 0;
+
+  for (i = 0; i < s->num_buckets; ++i)
+  {
+    if (buckets[i] > s->num_strings) return 0;
+    used += buckets[i] != 0;
+  }
+  if (used > s->num_strings) return 0;
+
+  for (i = 0; i < s->num_strings; ++i)
+  {
+    if (offsets[i] % UNIT != 0 || offsets[i] < s->strings_pos ||
+        offsets[i] + (U64)sizeof(header_t) > s->size)
+      return 0;
+    e = (const header_t*)(data + offsets[i]);
+    if (offsets[i] + (U64)sizeof(header_t) + e->size + 1 > s->size ||
+        e->id != (GPR_STRING_POOL_MAPPED | i) || chars((header_t*)e)[e->size] != '\0')
+      return 0;
+  }
+  return 1;
+}
+
+I32 gpr_string_pool_map(gpr_string_pool_t *pool, const char *path)
+{
+  gpr_file_map_t    map;
+  const snapshot_t *s;
+  U32               i;
+
+  gpr_assert_msg(pool->snapshot == NULL, "a snapshot is already mapped");
+  for (i = 0; i < (1u << pool->shard_bits); ++i)
+    gpr_assert_msg(shard_at(pool, i)->string_map.num_values == 0, "the pool is not empty");
+
+  if (!gpr_file_map_read(&map, path)) return 0;
+  s = (const snapshot_t*)map.data;
+  if (map.size > 0xffffffffu || map.size < sizeof(snapshot_t) ||
+      s->magic != GPR_STRING_POOL_MAGIC || s->size > map.size ||
+      s->num_strings >= GPR_STRING_POOL_MAPPED || s->num_buckets <= s->num_strings ||
+      (s->num_buckets & (s->num_buckets - 1)) != 0 ||
+      s->offsets_pos + (U64)s->num_strings*4 > s->buckets_pos ||
+      s->buckets_pos + (U64)s->num_buckets*4 > s->strings_pos ||
+      s->strings_pos > s->size || (s->offsets_pos | s->buckets_pos) % 4 != 0 ||
+      !valid_entries(map.data, s))
+  {
+    gpr_file_unmap(&map);
+    return 0;
+  }
+
+  pool->snapshot     = s;
+  pool->offsets      = (const U32*)(map.data + s->offsets_pos);
+  pool->buckets      = (const U32*)(map.data + s->buckets_pos);
+  pool->snapshot_map = map;
+  return 1;
+}
@@ -0,0 +1,352 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+  #define _GNU_SOURCE
+#endif
+
+#include "gpr_sync.h"
+#include "gpr_atomic.h"
+
+// ---------------------------------------------------------------
+// Futex abstraction
+// ---------------------------------------------------------------
+// wait: sleeps while *addr == expected (may wake up spuriously)
+// wake: wakes up at most n threads sleeping on addr
+// ---------------------------------------------------------------
+
+#if defined(_WIN32)
+
+#ifndef WIN32_LEAN_AND_MEAN
+  #define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+
+static void futex_wait(volatile U32 *addr, U32 expected)
+{
+  WaitOnAddress(addr, &expected, sizeof(U32), INFINITE);
+}
+
+static void futex_wake(volatile U32 *addr, U32 n)
+{
+  if (n == 1) WakeByAddressSingle((PVOID)addr);
+  else        WakeByAddressAll((PVOID)addr);
+}
+
+#elif defined(__linux__)
+
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+static void futex_wait(volatile U32 *addr, U32 expected)
+{
+  syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+}
+
+static void futex_wake(volatile U32 *addr, U32 n)
+{
+  syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, n > 0x7fffffffu ? 0x7fffffff : n,
+    NULL, NULL, 0);
+}
+
+#else
+
+#include <sched.h>
+
+static void futex_wait(volatile U32 *addr, U32 expected)
+{
+  if (gpr_atomic_load_U32(addr) == expected) sched_yield();
+}
+
+static void futex_wake(volatile U32 *addr, U32 n) {}
+
+#endif
+
+// ---------------------------------------------------------------
+// Spinlock
+// ---------------------------------------------------------------
+
+void gpr_spinlock_init(gpr_spinlock_t *l)
+{
+  l->locked = 0;
+}
+
+void gpr_spinlock_lock(gpr_spinlock_t *l)
+{
+  while (gpr_atomic_xchg_U32(&l->locked, 1))
+  {
+    // wait on a plain load to keep the cache line shared
+    while (gpr_atomic_load_U32(&l->locked)) gpr_cpu_pause();
+  }
+}
+
+I32 gpr_spinlock_trylock(gpr_spinlock_t *l)
+{
+  return gpr_atomic_load_U32(&l->locked) == 0
+      && gpr_atomic_xchg_U32(&l->locked, 1) == 0;
+}
+
+void gpr_spinlock_unlock(gpr_spinlock_t *l)
+{
+  gpr_atomic_store_U32(&l->locked, 0);
+}
+
+// ---------------------------------------------------------------
+// Mutex
+// ---------------------------------------------------------------
+// Drepper, "Futexes Are Tricky", mutex #2 with a spinning prologue.
+// ---------------------------------------------------------------
+
+#define UNLOCKED 0
+#define LOCKED   1
+#define SLEEPERS 2
+
+void gpr_mutex_init(gpr_mutex_t *m)
+{
+  m->state = UNLOCKED;
+}
+
+void gpr_mutex_lock(gpr_mutex_t *m)
+{
+  U32 i, c;
+
+  for (i = 0; i < GPR_SYNC_SPIN_COUNT; ++i)
+  {
+    if (gpr_atomic_load_U32(&m->state) == UNLOCKED
+     && gpr_atomic_cas_U32(&m->state, UNLOCKED, LOCKED)) return;
+    gpr_cpu_pause();
+  }
+
+  c = gpr_atomic_xchg_U32(&m->state, SLEEPERS);
+  while (c != UNLOCKED)
+  {
+    futex_wait(&m->state, SLEEPERS);
+    c = gpr_atomic_xchg_U32(&m->state, SLEEPERS);
+  }
+}
+
+I32 gpr_mutex_trylock(gpr_mutex_t *m)
+{
+  return gpr_atomic_cas_U32(&m->state, UNLOCKED, LOCKED);
+}
+
+void gpr_mutex_unlock(gpr_mutex_t *m)
+{
+  if (gpr_atomic_xchg_U32(&m->state, UNLOCKED) == SLEEPERS)
+    futex_wake(&m->state, 1);
+}
+
+// ---------------------------------------------------------------
+// Semaphore
+// ---------------------------------------------------------------
+
+void gpr_semaphore_init(gpr_semaphore_t *s, U32 count)
+{
+  s->count   = count;
+  s->waiters = 0;
+}
+
+I32 gpr_semaphore_trywait(gpr_semaphore_t *s)
+{
+  U32 c = gpr_atomic_load_U32(&s->count);
+  while (c > 0)
+  {
+    if (gpr_atomic_cas_U32(&s->count, c, c-1)) return 1;
+    c = gpr_atomic_load_U32(&s->count);
+  }
+  return 0;
+}
+
+void gpr_semaphore_wait(gpr_semaphore_t *s)
+{
+  U32 i;
+  for (i = 0; i < GPR_SYNC_SPIN_COUNT; ++i)
+  {
+    if (gpr_semaphore_trywait(s)) return;
+    gpr_cpu_pause();
+  }
+
+  while (!gpr_semaphore_trywait(s))
+  {
+    gpr_atomic_add_U32(&s->waiters, 1);
+    futex_wait(&s->count, 0);
+    gpr_atomic_add_U32(&s->waiters, (U32)-1);
+  }
+}
+
+void gpr_semaphore_post(gpr_semaphore_t *s, U32 count)
+{
+  gpr_atomic_add_U32(&s->count, count);
+  if (gpr_atomic_load_U32(&s->waiters) > 0)
+    futex_wake(&s->count, count);
+}
+
+// ---------------------------------------------------------------
+// Auto-reset event
+// ---------------------------------------------------------------
+
+void gpr_event_init(gpr_event_t *e)
+{
+  e->signaled = 0;
+  e->waiters  = 0;
+}
+
+void gpr_event_set(gpr_event_t *e)
+{
+  gpr_atomic_xchg_U32(&e->signaled, 1);
+  if (gpr_atomic_load_U32(&e->waiters) > 0)
+    futex_wake(&e->signaled, 1);
+}
+
+void gpr_event_wait(gpr_event_t *e)
+{
+  U32 i;
+  for (i = 0; i < GPR_SYNC_SPIN_COUNT; ++i)
+  {
+    if (gpr_atomic_cas_U32(&e->signaled, 1, 0)) return;
+    gpr_cpu_pause();
+  }
+
+  while (!gpr_atomic_cas_U32(&e->signaled, 1, 0))
+  {
+    gpr_atomic_add_U32(&e->waiters, 1);
+    futex_wait(&e->signaled, 0);
+    gpr_atomic_add_U32(&e->waiters, (U32)-1);
+  }
+}
+
+// ---------------------------------------------------------------
+// Reader-writer lock
+// ---------------------------------------------------------------
+
+#define WRITER         0x80000000u
+#define WRITER_WAITING 0x40000000u
+#define READERS_MASK   0x3fffffffu
+
+static void rwlock_sleep(gpr_rwlock_t *l, U32 state)
+{
+  gpr_atomic_add_U32(&l->waiters, 1);
+  futex_wait(&l->state, state);
+  gpr_atomic_add_U32(&l->waiters, (U32)-1);
+}
+
+static void rwlock_wake(gpr_rwlock_t *l)
+{
+  if (gpr_atomic_load_U32(&l->waiters) > 0)
+    futex_wake(&l->state, 0xffffffffu);
+}
+
+void gpr_rwlock_init(gpr_rwlock_t *l)
+{
+  l->state   = 0;
+  l->waiters = 0;
+}
+
+I32 gpr_rwlock_read_trylock(gpr_rwlock_t *l)
+{
+  U32 s = gpr_atomic_load_U32(&l->state);
+  while ((s & (WRITER | WRITER_WAITING)) == 0)
+  {
+    if (gpr_atomic_cas_U32(&l->state, s, s+1)) return 1;
+    s = gpr_atomic_load_U32(&l->state);
+  }
+  return 0;
+}
+
+void gpr_rwlock_read_lock(gpr_rwlock_t *l)
+{
+  U32 i = 0;
+  while (!gpr_rwlock_read_trylock(l))
+  {
+    if (i++ < GPR_SYNC_SPIN_COUNT) 
+    {
+      gpr_cpu_pause();
+      continue;
+    }
+    {
+      U32 s = gpr_atomic_load_U32(&l->state);
+      if (s & (WRITER | WRITER_WAITING)) rwlock_sleep(l, s);
+    }
+  }
+}
+
+void gpr_rwlock_read_unlock(gpr_rwlock_t *l)
+{
+  U32 s = gpr_atomic_add_U32(&l->state, (U32)-1) - 1;
+  // the last reader lets the waiting writer in
+  if ((s & READERS_MASK) == 0 && (s & WRITER_WAITING))
+    rwlock_wake(l);
+}
+
+void gpr_rwlock_write_lock(gpr_rwlock_t *l)
+{
+  U32 i = 0;
+  for (;;)
+  {
+    U32 s = gpr_atomic_load_U32(&l->state);
+    if ((s & ~WRITER_WAITING) == 0)
+    {
+      // other waiting writers set the flag again when they retry
+      if (gpr_atomic_cas_U32(&l->state, s, WRITER)) return;
+      continue;
+    }
+    if (i++ < GPR_SYNC_SPIN_COUNT) 
+    {
+      gpr_cpu_pause();
+      continue;
+    }
+    if ((s & WRITER_WAITING) == 0)
+    {
+      if (!gpr_atomic_cas_U32(&l->state, s, s | WRITER_WAITING)) continue;
+      s |= WRITER_WAITING;
+    }
+    rwlock_sleep(l, s);
+  }
+}
+
+void gpr_rwlock_write_unlock(gpr_rwlock_t *l)
+{
+  gpr_atomic_xchg_U32(&l->state, 0);
+  rwlock_wake(l);
+}
+
+// ---------------------------------------------------------------
+// Sequence lock
+// ---------------------------------------------------------------
+
+void gpr_seqlock_init(gpr_seqlock_t *l)
+{
+  l->seq = 0;
+  gpr_spinlock_init(&l->lock);
+}
+
+void gpr_seqlock_write_lock(gpr_seqlock_t *l)
+{
+  gpr_spinlock_lock(&l->lock);
+  gpr_atomic_add_U32(&l->seq, 1);
+  // the sequence must be odd before the first data store is visible
+  gpr_atomic_fence();
+}
+
+void gpr_seqlock_write_unlock(gpr_seqlock_t *l)
+{
+  gpr_atomic_add_U32(&l->seq, 1);
+  gpr_spinlock_unlock(&l->lock);
+}
+
+U32 gpr_seqlock_read_begin(gpr_seqlock_t *l)
+{
+  U32 seq = gpr_atomic_load_U32(&l->seq);
+  while (seq & 1)
+  {
+    gpr_cpu_pause();
+    seq = gpr_atomic_load_U32(&l->seq);
+  }
+  return seq;
+}
+
+I32 gpr_seqlock_read_retry(gpr_seqlock_t *l, U32 seq)
+{
+  // the data loads must complete before the sequence is read again
+  gpr_atomic_acquire_fence();
+  return gpr_atomic_load_U32(&l->seq) != seq;
+}
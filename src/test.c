@@ -1,478 +1,2251 @@
-#include <stdio.h>
-#include <time.h>
-#include <string.h>
-
-#include "gpr_assert.h"
-#include "gpr_idlut.h"
-#include "gpr_memory.h"
-#include "gpr_array.h"
-#include "gpr_tmp_allocator.h"
-#include "gpr_pool_allocator.h"
-#include "gpr_hash.h"
-#include "gpr_murmur_hash.h"
-#include "gpr_tree.h"
-#include "gpr_string_pool.h"
-#include "gpr_json_read.h"
-#include "gpr_json_write.h"
-
-
-// ---------------------------------------------------------------
-// Default allocator tests
-// ---------------------------------------------------------------
-
-void test_memory()
-{
-  gpr_allocator_t *a;
-  void *p, *q;
-
-  gpr_memory_init(4*1024*1024);
-  a = gpr_default_allocator;
-
-  p = gpr_allocate(a, 100);
-  gpr_assert(gpr_allocated_for(a,p) >= 100);
-  gpr_assert(gpr_allocated_tot(a)   >= 100);
-  q = gpr_allocate(a, 100);
-  gpr_assert(gpr_allocated_for(a,q) >= 100);
-  gpr_assert(gpr_allocated_tot(a)   >= 200);
-
-  gpr_deallocate(a,p);
-  gpr_deallocate(a,q);
-
-  gpr_memory_shutdown();
-}
-
-void test_scratch()
-{
-  gpr_allocator_t *a;
-  char *p, *pointers[100];
-  int   i;
-
-  gpr_memory_init(256*1024);
-  a = gpr_scratch_allocator;
-
-  p = (char*)gpr_allocate(a, 10*1024);
-
-  for (i=0; i<100; ++i) pointers[i] = (char*)gpr_allocate(a, 1024);
-  for (i=0; i<100; ++i) gpr_deallocate(a, pointers[i]);
-
-  gpr_deallocate(a, p);
-
-  for (i=0; i<100; ++i) pointers[i] = (char *)gpr_allocate(a, 4*1024);
-  for (i=0; i<100; ++i) gpr_deallocate(a, pointers[i]);
-
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// Array test
-// ---------------------------------------------------------------
-
-void test_array()
-{
-  gpr_allocator_t *a;
-  gpr_array_t(int) v1, v2;
-
-  gpr_memory_init(4*1024*1024);
-  a = gpr_default_allocator;
-
-  gpr_array_init(int, &v1, a);
-
-  gpr_assert(gpr_array_size(&v1) == 0);
-  gpr_array_push_back(int, &v1, 3);
-
-  gpr_assert(gpr_array_size(&v1) == 1);
-  gpr_assert(gpr_array_item(&v1, 0) == 3);
-
-  gpr_array_init(int, &v2, a);
-  gpr_array_copy(int, &v2, &v1);
-  gpr_assert(gpr_array_item(&v2, 0) == 3);
-  gpr_array_item(&v2, 0) = 5;
-  gpr_assert(gpr_array_item(&v1,  0) == 3);
-  gpr_assert(gpr_array_item(&v2, 0) == 5);
-  gpr_array_copy(int, &v2, &v1);
-  gpr_assert(gpr_array_item(&v2, 0) == 3);
-
-  gpr_assert(gpr_array_end(&v1) - gpr_array_begin(&v1) == gpr_array_size(&v1));
-  gpr_assert(*gpr_array_begin(&v1) == 3);
-  gpr_array_pop_back(&v1);
-  gpr_assert(gpr_array_empty(&v1));
-
-  {
-    int i;
-    for (i=0; i<100; ++i) gpr_array_push_back(int, &v1, i);
-    for (i=0; i<100; ++i) gpr_assert(gpr_array_item(&v1, i) == i);
-  }
-  gpr_assert(gpr_array_size(&v1) == 100);
-
-  gpr_array_remove(&v1, 50);
-  gpr_assert(gpr_array_size(&v1) == 99);
-
-  gpr_array_destroy(&v1);
-  gpr_array_destroy(&v2);
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// Temporary allocator test
-// ---------------------------------------------------------------
-
-void test_tmp_allocator()
-{
-  gpr_memory_init(4*1024*1024);
-  {
-    gpr_tmp_allocator_128_t  ta;
-    gpr_allocator_t         *a = (gpr_allocator_t*)&ta;
-    gpr_array_t(int)         ar;
-
-    gpr_tmp_allocator_init(a, 128);
-    gpr_array_init(int, &ar, a);
-    {
-      int i;
-      for (i=0; i<100; ++i) gpr_array_push_back(int, &ar, i);
-    }
-    gpr_allocate(a, 2*1024);
-    gpr_tmp_allocator_destroy(a);
-  }
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// Pool allocator test
-// ---------------------------------------------------------------
-
-void test_pool_allocator()
-{
-  gpr_memory_init(4*1024*1024);
-  {
-    gpr_pool_allocator_t  pa;
-    gpr_allocator_t      *a = (gpr_allocator_t*)&pa;
-    gpr_array_t(int*)     ar;
-
-    gpr_pool_allocator_init(&pa, 4, 100, gpr_default_allocator);
-    gpr_array_init(int*, &ar, gpr_default_allocator);
-    {
-      int i;
-      for (i=0; i<150; ++i)
-        gpr_array_push_back(int*, &ar, (int*)gpr_allocate(a, sizeof(int)));
-
-      for (i=0; i<150; ++i) 
-        gpr_deallocate(a, gpr_array_item(&ar, i));
-    }
-    gpr_array_destroy(&ar);
-    {
-      void *p = gpr_allocate(a, 2*1024);
-      gpr_deallocate(a, p);
-    }
-    gpr_pool_allocator_destroy(a);
-  }
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// ID lookup table test
-// ---------------------------------------------------------------
-
-#define NUM_INSERT 100
-
-void test_idlut()
-{
-  I32 item;
-  U64   id1, id2, id3;
-  gpr_idlut_t t;
-  gpr_allocator_t *a;
-  U64 keys[NUM_INSERT];
-
-  gpr_memory_init(512);
-  a = gpr_default_allocator;
-
-  gpr_idlut_init(I32, &t, a);
-
-  item = 1;
-  id1 = gpr_idlut_add(I32, &t, &item);
-  gpr_assert(gpr_idlut_has(I32, &t, id1));
-  gpr_assert(*gpr_idlut_lookup(I32, &t, id1) == 1);
-
-  item = 2;
-  id2 = gpr_idlut_add(I32, &t, &item);
-  gpr_assert(gpr_idlut_has(I32, &t, id2));
-  gpr_assert(*gpr_idlut_lookup(I32, &t, id2)== 2);
-
-  gpr_idlut_remove(I32, &t, id1);
-  gpr_assert(!gpr_idlut_has(I32, &t, id1));
-
-  item = 3;
-  id3 = gpr_idlut_add(I32, &t, &item);
-  gpr_assert(gpr_idlut_has(I32, &t, id3));
-  gpr_assert(*gpr_idlut_lookup(I32, &t, id3) == 3);
-
-  {
-    int i; for (i=0; i<NUM_INSERT; ++i)
-      keys[i] = gpr_idlut_add(I32, &t, &i);
-  }
-
-  gpr_assert(*gpr_idlut_lookup(I32, &t, id2) == 2);
-  gpr_idlut_remove(I32, &t, id2);
-  gpr_assert(*gpr_idlut_lookup(I32, &t, id3) == 3);
-  gpr_idlut_remove(I32, &t, id3);
-
-  gpr_assert(gpr_idlut_end(I32, &t) - gpr_idlut_begin(I32, &t) == NUM_INSERT);
-  gpr_idlut_remove(I32, &t, keys[0]);
-  gpr_idlut_remove(I32, &t, keys[NUM_INSERT-1]);
-  {
-    int i; for (i=1; i<NUM_INSERT-1; ++i)
-      gpr_assert(*gpr_idlut_lookup(I32, &t, keys[i]) == i);
-  }
-
-  gpr_idlut_destroy(I32, &t);
-
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// Hash table tests
-// ---------------------------------------------------------------
-
-void test_hash()
-{
-  gpr_allocator_t *a;
-  gpr_hash_t       h;
-  I32              v;
-
-  gpr_memory_init(0);
-  a = gpr_default_allocator;
-
-  gpr_hash_init(I32, &h, a);
-
-  gpr_assert(!gpr_hash_has(I32, &h, 0));
-  gpr_hash_remove(I32, &h, 0);
-
-  v = 123;
-  gpr_hash_set(I32, &h, 1000, &v);
-  gpr_assert(*gpr_hash_get(I32, &h, 1000) == 123);
-
-  {
-    int i;
-    for (i=0; i<100; ++i) {
-      v = i*i;
-      gpr_hash_set(I32, &h, i, &v);
-    }
-    for (i=0; i<100; ++i)
-      gpr_assert(*gpr_hash_get(I32, &h, i) == i*i);
-  }
-
-  gpr_hash_remove(I32, &h, 1000);
-  gpr_assert(!gpr_hash_has(I32, &h, 1000));
-  gpr_hash_remove(I32, &h, 2000);
-  gpr_assert(gpr_hash_get(I32, &h, 1000) == NULL);
-  { 
-    int i;
-    for (i=0; i<100; ++i)
-      gpr_assert(*gpr_hash_get(I32, &h, i) == i*i);
-  }
-  gpr_hash_destroy(I32, &h);
-  gpr_memory_shutdown();
-}
-
-void test_multi_hash()
-{
-  gpr_hash_t       h;
-  I32              v;
-
-  gpr_memory_init(4*1024);
-
-  gpr_multi_hash_init(I32, &h, gpr_default_allocator);
-
-  gpr_assert(gpr_multi_hash_count(I32, &h, 0) == 0);
-  v = 1; gpr_multi_hash_insert(I32, &h, 0, &v);
-  v = 2; gpr_multi_hash_insert(I32, &h, 0, &v);
-  v = 3; gpr_multi_hash_insert(I32, &h, 0, &v);
-  gpr_assert(gpr_multi_hash_count(I32, &h, 0) == 3);
-
-  {
-    gpr_tmp_allocator_128_t ta;
-    gpr_array_t(I32) arr;
-    gpr_tmp_allocator_init(&ta, 128);
-    gpr_array_init(I32, &arr, (gpr_allocator_t*)&ta);
-
-    gpr_multi_hash_get(I32, &h, 0, &arr);
-
-    gpr_assert(gpr_array_size(&arr) == 3);
-
-    gpr_multi_hash_remove(I32, &h, gpr_multi_hash_find_first(I32, &h, 0, 0));
-    gpr_assert(gpr_multi_hash_count(I32, &h,0) == 2);
-    gpr_multi_hash_remove_all(I32, &h, 0);
-    gpr_assert(gpr_multi_hash_count(I32, &h, 0) == 0);
-
-    gpr_tmp_allocator_destroy(&ta);
-  }
-
-  gpr_multi_hash_destroy(I32, &h);
-
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// Murmur Hash
-// ---------------------------------------------------------------
-
-void test_murmur_hash()
-{
-  const char *s = "test_string";
-  U64 h = gpr_murmur_hash_64(s, strlen(s), 0);
-  gpr_assert(h == 0xe604acc23b568f83ull);
-}
-
-// ---------------------------------------------------------------
-// Tree
-// ---------------------------------------------------------------
-
-void test_tree()
-{
-  gpr_tree_t t;
-  I32 val = 0;
-  U64 root, n1, n2, n3, n31, n32;
-
-  gpr_memory_init(4*1024);
-  root = gpr_tree_init(I32, &t, gpr_default_allocator, &val);
-
-  val = 1;  n1  = gpr_tree_add_child(I32, &t, root, &val);
-  val = 2;  n2  = gpr_tree_add_child(I32, &t, root, &val);
-  val = 3;  n3  = gpr_tree_add_child(I32, &t, root, &val);
-  val = 31; n31 = gpr_tree_add_child(I32, &t, n3, &val);
-  val = 32; n32 = gpr_tree_add_child(I32, &t, n3, &val);
-
-  gpr_assert(*gpr_tree_get(I32, &t, n3) == 3);
-  gpr_assert(*gpr_tree_get(I32, &t, n31) == 31);
-  gpr_assert(*gpr_tree_get(I32, &t, n32) == 32);
-  gpr_tree_remove(I32, &t, n3);
-  gpr_assert(!gpr_tree_has(I32, &t, n3));
-  gpr_assert(!gpr_tree_has(I32, &t, n31));
-  gpr_assert(!gpr_tree_has(I32, &t, n32));
-
-  gpr_tree_destroy(I32, &t);
-
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// String pool test
-// --------------------------------------------------------------
-
-void test_string_pool()
-{
-  gpr_string_pool_t sp;
-  char *s1, *s2;
-
-  gpr_memory_init(1024*4);
-  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
-
-  s1 = gpr_string_pool_get(&sp, "hello world!");
-  s2 = gpr_string_pool_get(&sp, "hello world!");
-
-  gpr_assert(s1 == s2);
-  gpr_string_pool_release(&sp, "hello world!");
-  gpr_assert(strcmp(s2,"hello world!") == 0);
-  gpr_string_pool_release(&sp, "hello world!");
-  gpr_assert(!gpr_string_pool_has(&sp, "hello world!"));
-
-
-  gpr_string_pool_destroy(&sp);
-}
-
-// ---------------------------------------------------------------
-// JSON Test
-// ---------------------------------------------------------------
-
-void test_json()
-{
-  gpr_buffer_t buf, buf2;
-  gpr_json_t jsn;
-  gpr_string_pool_t sp;
-  gpr_pool_allocator_t pa;
-  U64 entity;
-
-  gpr_memory_init(1024*4);
-  gpr_pool_allocator_init(&pa, 16, 256, gpr_default_allocator);
-  gpr_string_pool_init(&sp, gpr_default_allocator, (gpr_allocator_t*)&pa);
-
-  // ---------------------------------------------------------------
-  entity = gpr_json_init(&jsn, &sp, gpr_default_allocator);
-
-  gpr_json_set_integer(&jsn, entity, "x", 10);
-  gpr_json_set_integer(&jsn, entity, "y", 20);
-  gpr_json_set_string (&jsn, entity, "desc", "this is a description string");
-  {
-    U64 matrix = gpr_json_create_object(&jsn, entity, "matrix3");
-    U64 mx = gpr_json_create_array(&jsn, matrix, "x");
-    U64 my = gpr_json_create_array(&jsn, matrix, "y");
-    U64 mz = gpr_json_create_array(&jsn, matrix, "z");
-
-    I32 values[] = {1,2,3};
-    gpr_json_array_add_integers(&jsn, mx, values, 3);
-    gpr_json_array_add_integers(&jsn, my, values, 3);
-    gpr_json_array_add_integers(&jsn, mz, values, 3);
-
-    gpr_assert(matrix == gpr_json_get(&jsn, entity, "matrix3")->object);
-    gpr_assert(mz     == gpr_json_get(&jsn, matrix, "z")->arr);
-
-    gpr_json_array_add_integer(&jsn, mz, 666);
-    gpr_assert(gpr_json_array_size(&jsn, mz) == 4);
-    gpr_assert(gpr_json_array_get(&jsn, mz, 3)->integer == 666);
-
-    gpr_json_array_remove(&jsn, mz, 3);
-    gpr_assert(gpr_json_array_size(&jsn, mz) == 3);
-
-    gpr_json_remove(&jsn, matrix, "z");
-    gpr_assert(!gpr_json_has(&jsn, matrix, "z"));
-
-    gpr_json_set_integer(&jsn, entity, "z", 666);
-    gpr_json_set_number (&jsn, entity, "z", 0.666);
-  }
-
-  gpr_buffer_init(&buf, gpr_default_allocator);
-  gpr_json_write(&jsn, entity, &buf, 1);
-  printf(buf.data);
-  printf("\r\n");
-  {
-    gpr_json_t jsn2;
-    U64 jroot = gpr_json_init(&jsn2, &sp, gpr_default_allocator);
-    gpr_assert(gpr_json_parse(&jsn2, jroot, buf.data));
-
-    gpr_buffer_init(&buf2, gpr_default_allocator);
-    gpr_json_write(&jsn2, jroot, &buf2, 1);
-    gpr_assert(strncmp(buf.data, buf2.data, buf.size) == 0);
-
-    printf(buf.data);
-    gpr_buffer_destroy(&buf2);
-    gpr_json_destroy(&jsn2);
-  }
-
-  // ---------------------------------------------------------------
-
-  gpr_buffer_destroy(&buf);
-  gpr_json_destroy(&jsn);
-  gpr_string_pool_destroy(&sp);
-  gpr_pool_allocator_destroy(&pa);
-  gpr_memory_shutdown();
-}
-
-// ---------------------------------------------------------------
-// MAIN
-// ---------------------------------------------------------------
-
-int main()
-{
-  /*test_memory();
-  test_scratch();
-  test_tmp_allocator();
-  test_pool_allocator();
-  test_array();
-  test_idlut();
-  test_hash();
-  test_multi_hash();
-  test_murmur_hash();
-  test_tree();
-  test_string_pool();*/
-  test_json();
-  return 0;
+#include <stdio.h>
+#include <time.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "gpr_assert.h"
+#include "gpr_idlut.h"
+#include "gpr_memory.h"
+#include "gpr_array.h"
+#include "gpr_tmp_allocator.h"
+#include "gpr_pool_allocator.h"
+#include "gpr_hash.h"
+#include "gpr_murmur_hash.h"
+#include "gpr_tree.h"
+#include "gpr_string_pool.h"
+#include "gpr_json_read.h"
+#include "gpr_json_write.h"
+#include "gpr_atomic.h"
+#include "gpr_sync.h"
+#include "gpr_epoch.h"
+#include "gpr_job.h"
+#include "gpr_concurrent_hash.h"
+#include "gpr_frozen_hash.h"
+#include "gpr_hash_set.h"
+#include "gpr_multi_map.h"
+#include "gpr_rcu_hash.h"
+#include "gpr_disk_hash.h"
+#include "gpr_fast_hash.h"
+#include "gpr_radix_tree.h"
+#include "tinycthread.h"
+
+
+// ---------------------------------------------------------------
+// Default allocator tests
+// ---------------------------------------------------------------
+
+void test_memory()
+{
+  gpr_allocator_t *a;
+  void *p, *q;
+
+  gpr_memory_init(4*1024*1024);
+  a = gpr_default_allocator;
+
+  p = gpr_allocate(a, 100);
+  gpr_assert(gpr_allocated_for(a,p) >= 100);
+  gpr_assert(gpr_allocated_tot(a)   >= 100);
+  q = gpr_allocate(a, 100);
+  gpr_assert(gpr_allocated_for(a,q) >= 100);
+  gpr_assert(gpr_allocated_tot(a)   >= 200);
+
+  gpr_deallocate(a,p);
+  gpr_deallocate(a,q);
+
+  gpr_memory_shutdown();
+}
+
+void test_scratch()
+{
+  gpr_allocator_t *a;
+  char *p, *pointers[100];
+  int   i;
+
+  gpr_memory_init(256*1024);
+  a = gpr_scratch_allocator;
+
+  p = (char*)gpr_allocate(a, 10*1024);
+
+  for (i=0; i<100; ++i) pointers[i] = (char*)gpr_allocate(a, 1024);
+  for (i=0; i<100; ++i) gpr_deallocate(a, pointers[i]);
+
+  gpr_deallocate(a, p);
+
+  for (i=0; i<100; ++i) pointers[i] = (char *)gpr_allocate(a, 4*1024);
+  for (i=0; i<100; ++i) gpr_deallocate(a, pointers[i]);
+
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Array test
+// ---------------------------------------------------------------
+
+void test_array()
+{
+  gpr_allocator_t *a;
+  gpr_array_t(int) v1, v2;
+
+  gpr_memory_init(4*1024*1024);
+  a = gpr_default_allocator;
+
+  gpr_array_init(int, &v1, a);
+
+  gpr_assert(gpr_array_size(&v1) == 0);
+  gpr_array_push_back(int, &v1, 3);
+
+  gpr_assert(gpr_array_size(&v1) == 1);
+  gpr_assert(gpr_array_item(&v1, 0) == 3);
+
+  gpr_array_init(int, &v2, a);
+  gpr_array_copy(int, &v2, &v1);
+  gpr_assert(gpr_array_item(&v2, 0) == 3);
+  gpr_array_item(&v2, 0) = 5;
+  gpr_assert(gpr_array_item(&v1,  0) == 3);
+  gpr_assert(gpr_array_item(&v2, 0) == 5);
+  gpr_array_copy(int, &v2, &v1);
+  gpr_assert(gpr_array_item(&v2, 0) == 3);
+
+  gpr_assert(gpr_array_end(&v1) - gpr_array_begin(&v1) == gpr_array_size(&v1));
+  gpr_assert(*gpr_array_begin(&v1) == 3);
+  gpr_array_pop_back(&v1);
+  gpr_assert(gpr_array_empty(&v1));
+
+  {
+    int i;
+    for (i=0; i<100; ++i) gpr_array_push_back(int, &v1, i);
+    for (i=0; i<100; ++i) gpr_assert(gpr_array_item(&v1, i) == i);
+  }
+  gpr_assert(gpr_array_size(&v1) == 100);
+
+  gpr_array_remove(&v1, 50);
+  gpr_assert(gpr_array_size(&v1) == 99);
+
+  gpr_array_destroy(&v1);
+  gpr_array_destroy(&v2);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Temporary allocator test
+// ---------------------------------------------------------------
+
+void test_tmp_allocator()
+{
+  gpr_memory_init(4*1024*1024);
+  {
+    gpr_tmp_allocator_128_t  ta;
+    gpr_allocator_t         *a = (gpr_allocator_t*)&ta;
+    gpr_array_t(int)         ar;
+
+    gpr_tmp_allocator_init(a, 128);
+    gpr_array_init(int, &ar, a);
+    {
+      int i;
+      for (i=0; i<100; ++i) gpr_array_push_back(int, &ar, i);
+    }
+    gpr_allocate(a, 2*1024);
+    gpr_tmp_allocator_destroy(a);
+  }
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Pool allocator test
+// ---------------------------------------------------------------
+
+void test_pool_allocator()
+{
+  gpr_memory_init(4*1024*1024);
+  {
+    gpr_pool_allocator_t  pa;
+    gpr_allocator_t      *a = (gpr_allocator_t*)&pa;
+    gpr_array_t(int*)     ar;
+
+    gpr_pool_allocator_init(&pa, 4, 100, gpr_default_allocator);
+    gpr_array_init(int*, &ar, gpr_default_allocator);
+    {
+      int i;
+      for (i=0; i<150; ++i)
+        gpr_array_push_back(int*, &ar, (int*)gpr_allocate(a, sizeof(int)));
+
+      for (i=0; i<150; ++i) 
+        gpr_deallocate(a, gpr_array_item(&ar, i));
+    }
+    gpr_array_destroy(&ar);
+    {
+      void *p = gpr_allocate(a, 2*1024);
+      gpr_deallocate(a, p);
+    }
+    gpr_pool_allocator_destroy(a);
+  }
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// ID lookup table test
+// ---------------------------------------------------------------
+
+#define NUM_INSERT 100
+
+void test_idlut()
+{
+  I32 item;
+  U64   id1, id2, id3;
+  gpr_idlut_t t;
+  gpr_allocator_t *a;
+  U64 keys[NUM_INSERT];
+
+  gpr_memory_init(512);
+  a = gpr_default_allocator;
+
+  gpr_idlut_init(I32, &t, a);
+
+  item = 1;
+  id1 = gpr_idlut_add(I32, &t, &item);
+  gpr_assert(gpr_idlut_has(I32, &t, id1));
+  gpr_assert(*gpr_idlut_lookup(I32, &t, id1) == 1);
+
+  item = 2;
+  id2 = gpr_idlut_add(I32, &t, &item);
+  gpr_assert(gpr_idlut_has(I32, &t, id2));
+  gpr_assert(*gpr_idlut_lookup(I32, &t, id2)== 2);
+
+  gpr_idlut_remove(I32, &t, id1);
+  gpr_assert(!gpr_idlut_has(I32, &t, id1));
+
+  item = 3;
+  id3 = gpr_idlut_add(I32, &t, &item);
+  gpr_assert(gpr_idlut_has(I32, &t, id3));
+  gpr_assert(*gpr_idlut_lookup(I32, &t, id3) == 3);
+
+  {
+    int i; for (i=0; i<NUM_INSERT; ++i)
+      keys[i] = gpr_idlut_add(I32, &t, &i);
+  }
+
+  // the index of id1 is reused with a new generation
+  gpr_assert(sizeof(gpr_idlut_index_t) == 8);
+  gpr_assert((U32)keys[1] == (U32)id1 && keys[1] != id1);
+  gpr_assert(!gpr_idlut_has(I32, &t, id1) && gpr_idlut_has(I32, &t, keys[1]));
+
+  gpr_assert(*gpr_idlut_lookup(I32, &t, id2) == 2);
+  gpr_idlut_remove(I32, &t, id2);
+  gpr_assert(*gpr_idlut_lookup(I32, &t, id3) == 3);
+  gpr_idlut_remove(I32, &t, id3);
+
+  gpr_assert(gpr_idlut_end(I32, &t) - gpr_idlut_begin(I32, &t) == NUM_INSERT);
+  gpr_idlut_remove(I32, &t, keys[0]);
+  gpr_idlut_remove(I32, &t, keys[NUM_INSERT-1]);
+  {
+    int i; for (i=1; i<NUM_INSERT-1; ++i)
+      gpr_assert(*gpr_idlut_lookup(I32, &t, keys[i]) == i);
+  }
+
+  gpr_idlut_destroy(I32, &t);
+
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Hash table tests
+// ---------------------------------------------------------------
+
+void test_hash()
+{
+  gpr_allocator_t *a;
+  gpr_hash_t       h;
+  I32              v;
+
+  gpr_memory_init(0);
+  a = gpr_default_allocator;
+
+  gpr_hash_init(I32, &h, a);
+
+  gpr_assert(!gpr_hash_has(I32, &h, 0));
+  gpr_hash_remove(I32, &h, 0);
+
+  v = 123;
+  gpr_hash_set(I32, &h, 1000, &v);
+  gpr_assert(*gpr_hash_get(I32, &h, 1000) == 123);
+
+  {
+    int i;
+    for (i=0; i<100; ++i) {
+      v = i*i;
+      gpr_hash_set(I32, &h, i, &v);
+    }
+    for (i=0; i<100; ++i)
+      gpr_assert(*gpr_hash_get(I32, &h, i) == i*i);
+  }
+
+  gpr_hash_remove(I32, &h, 1000);
+  gpr_assert(!gpr_hash_has(I32, &h, 1000));
+  gpr_hash_remove(I32, &h, 2000);
+  gpr_assert(gpr_hash_get(I32, &h, 1000) == NULL);
+  { 
+    int i;
+    for (i=0; i<100; ++i)
+      gpr_assert(*gpr_hash_get(I32, &h, i) == i*i);
+  }
+  gpr_hash_destroy(I32, &h);
+  gpr_memory_shutdown();
+}
+
+void test_multi_hash()
+{
+  gpr_hash_t       h;
+  I32              v;
+
+  gpr_memory_init(4*1024);
+
+  gpr_multi_hash_init(I32, &h, gpr_default_allocator);
+
+  gpr_assert(gpr_multi_hash_count(I32, &h, 0) == 0);
+  v = 1; gpr_multi_hash_insert(I32, &h, 0, &v);
+  v = 2; gpr_multi_hash_insert(I32, &h, 0, &v);
+  v = 3; gpr_multi_hash_insert(I32, &h, 0, &v);
+  gpr_assert(gpr_multi_hash_count(I32, &h, 0) == 3);
+
+  {
+    gpr_tmp_allocator_128_t ta;
+    gpr_array_t(I32) arr;
+    gpr_tmp_allocator_init(&ta, 128);
+    gpr_array_init(I32, &arr, (gpr_allocator_t*)&ta);
+
+    gpr_multi_hash_get(I32, &h, 0, &arr);
+
+    gpr_assert(gpr_array_size(&arr) == 3);
+
+    gpr_multi_hash_remove(I32, &h, gpr_multi_hash_find_first(I32, &h, 0, 0));
+    gpr_assert(gpr_multi_hash_count(I32, &h,0) == 2);
+    gpr_multi_hash_remove_all(I32, &h, 0);
+    gpr_assert(gpr_multi_hash_count(I32, &h, 0) == 0);
+
+    gpr_tmp_allocator_destroy(&ta);
+  }
+
+  gpr_multi_hash_destroy(I32, &h);
+
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Murmur Hash
+// ---------------------------------------------------------------
+
+void test_murmur_hash()
+{
+  const char *s = "test_string";
+  U64 h = gpr_murmur_hash_64(s, strlen(s), 0);
+  gpr_assert(h == 0xe604acc23b568f83ull);
+}
+
+// ---------------------------------------------------------------
+// Tree
+// ---------------------------------------------------------------
+
+void test_tree()
+{
+  gpr_tree_t t;
+  I32 val = 0;
+  U64 root, n1, n2, n3, n31, n32;
+
+  gpr_memory_init(4*1024);
+  root = gpr_tree_init(I32, &t, gpr_default_allocator, &val);
+
+  val = 1;  n1  = gpr_tree_add_child(I32, &t, root, &val);
+  val = 2;  n2  = gpr_tree_add_child(I32, &t, root, &val);
+  val = 3;  n3  = gpr_tree_add_child(I32, &t, root, &val);
+  val = 31; n31 = gpr_tree_add_child(I32, &t, n3, &val);
+  val = 32; n32 = gpr_tree_add_child(I32, &t, n3, &val);
+
+  gpr_assert(*gpr_tree_get(I32, &t, n3) == 3);
+  gpr_assert(*gpr_tree_get(I32, &t, n31) == 31);
+  gpr_assert(*gpr_tree_get(I32, &t, n32) == 32);
+  gpr_tree_remove(I32, &t, n3);
+  gpr_assert(!gpr_tree_has(I32, &t, n3));
+  gpr_assert(!gpr_tree_has(I32, &t, n31));
+  gpr_assert(!gpr_tree_has(I32, &t, n32));
+
+  gpr_tree_destroy(I32, &t);
+
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// String pool test
+// --------------------------------------------------------------
+
+void test_string_pool()
+{
+  gpr_string_pool_t sp;
+  char *s1, *s2;
+
+  gpr_memory_init(1024*4);
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+
+  s1 = gpr_string_pool_get(&sp, "hello world!");
+  s2 = gpr_string_pool_get(&sp, "hello world!");
+
+  gpr_assert(s1 == s2);
+  gpr_string_pool_release(&sp, "hello world!");
+  gpr_assert(strcmp(s2,"hello world!") == 0);
+  gpr_string_pool_release(&sp, "hello world!");
+  gpr_assert(!gpr_string_pool_has(&sp, "hello world!"));
+
+
+  gpr_string_pool_destroy(&sp);
+}
+
+// ---------------------------------------------------------------
+// JSON Test
+// ---------------------------------------------------------------
+
+void test_json()
+{
+  gpr_buffer_t buf, buf2;
+  gpr_json_t jsn;
+  gpr_string_pool_t sp;
+  gpr_pool_allocator_t pa;
+  U64 entity;
+
+  gpr_memory_init(1024*4);
+  gpr_pool_allocator_init(&pa, 16, 256, gpr_default_allocator);
+  gpr_string_pool_init(&sp, gpr_default_allocator, (gpr_allocator_t*)&pa);
+
+  // ---------------------------------------------------------------
+  entity = gpr_json_init(&jsn, &sp, gpr_default_allocator);
+
+  gpr_json_set_integer(&jsn, entity, "x", 10);
+  gpr_json_set_integer(&jsn, entity, "y", 20);
+  gpr_json_set_string (&jsn, entity, "desc", "this is a description string");
+  {
+    U64 matrix = gpr_json_create_object(&jsn, entity, "matrix3");
+    U64 mx = gpr_json_create_array(&jsn, matrix, "x");
+    U64 my = gpr_json_create_array(&jsn, matrix, "y");
+    U64 mz = gpr_json_create_array(&jsn, matrix, "z");
+
+    I32 values[] = {1,2,3};
+    gpr_json_array_add_integers(&jsn, mx, values, 3);
+    gpr_json_array_add_integers(&jsn, my, values, 3);
+    gpr_json_array_add_integers(&jsn, mz, values, 3);
+
+    gpr_assert(matrix == gpr_json_get(&jsn, entity, "matrix3")->object);
+    gpr_assert(mz     == gpr_json_get(&jsn, matrix, "z")->arr);
+
+    gpr_json_array_add_integer(&jsn, mz, 666);
+    gpr_assert(gpr_json_array_size(&jsn, mz) == 4);
+    gpr_assert(gpr_json_array_get(&jsn, mz, 3)->integer == 666);
+
+    gpr_json_array_remove(&jsn, mz, 3);
+    gpr_assert(gpr_json_array_size(&jsn, mz) == 3);
+
+    gpr_json_remove(&jsn, matrix, "z");
+    gpr_assert(!gpr_json_has(&jsn, matrix, "z"));
+
+    gpr_json_set_integer(&jsn, entity, "z", 666);
+    gpr_json_set_number (&jsn, entity, "z", 0.666);
+  }
+  {
+    // gen_hash_keys desc
+    const U64 desc = 0x30d48b98e1eee9c9ull;
+    const U64 y    = gpr_json_key("y");
+
+    gpr_assert(gpr_json_key("desc") == desc);
+    gpr_assert(gpr_json_has_key(&jsn, entity, desc));
+    gpr_assert(!gpr_json_has_key(&jsn, entity, gpr_json_key("w")));
+    gpr_assert(gpr_json_get_key(&jsn, entity, y)->integer == 20);
+    gpr_assert(gpr_json_get_key(&jsn, entity, y) == gpr_json_get(&jsn, entity, "y"));
+    gpr_json_set_key(&jsn, entity, "y", y, GPR_JSON_INTEGER, 21);
+    gpr_assert(gpr_json_get(&jsn, entity, "y")->integer == 21);
+  }
+
+  gpr_buffer_init(&buf, gpr_default_allocator);
+  gpr_json_write(&jsn, entity, &buf, 1);
+  printf(buf.data);
+  printf("\r\n");
+  {
+    gpr_json_t jsn2;
+    U64 jroot = gpr_json_init(&jsn2, &sp, gpr_default_allocator);
+    gpr_assert(gpr_json_parse(&jsn2, jroot, buf.data));
+    gpr_assert(gpr_json_get(&jsn2, jroot, "desc")->type == GPR_JSON_STRING);
+    gpr_assert(gpr_json_get_key(&jsn2, gpr_json_get(&jsn2, jroot, "matrix3")->object,
+      gpr_json_key("y"))->type == GPR_JSON_ARRAY);
+
+    gpr_buffer_init(&buf2, gpr_default_allocator);
+    gpr_json_write(&jsn2, jroot, &buf2, 1);
+    gpr_assert(strncmp(buf.data, buf2.data, buf.size) == 0);
+
+    printf(buf.data);
+    gpr_buffer_destroy(&buf2);
+    gpr_json_destroy(&jsn2);
+  }
+
+  // ---------------------------------------------------------------
+
+  gpr_buffer_destroy(&buf);
+  gpr_json_destroy(&jsn);
+  gpr_string_pool_destroy(&sp);
+  gpr_pool_allocator_destroy(&pa);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Synchronization primitives test
+// ---------------------------------------------------------------
+
+#define SYNC_THREADS 4
+#define SYNC_LOOPS   100000
+
+typedef struct
+{
+  gpr_spinlock_t  spinlock;
+  gpr_mutex_t     mutex;
+  gpr_semaphore_t sem;
+  gpr_event_t     evt;
+  U32             spin_counter;
+  U32             mutex_counter;
+} sync_test_t;
+
+static int sync_test_worker(void *arg)
+{
+  sync_test_t *st = (sync_test_t*)arg;
+  int i;
+
+  for (i = 0; i < SYNC_LOOPS; ++i)
+  {
+    gpr_spinlock_lock(&st->spinlock);
+    ++st->spin_counter;
+    gpr_spinlock_unlock(&st->spinlock);
+
+    gpr_mutex_lock(&st->mutex);
+    ++st->mutex_counter;
+    gpr_mutex_unlock(&st->mutex);
+  }
+
+  gpr_semaphore_post(&st->sem, 1);
+  gpr_event_wait(&st->evt);
+  gpr_semaphore_post(&st->sem, 1);
+  return 0;
+}
+
+void test_sync()
+{
+  sync_test_t st;
+  thrd_t      threads[SYNC_THREADS];
+  int         i;
+
+  gpr_spinlock_init(&st.spinlock);
+  gpr_mutex_init(&st.mutex);
+  gpr_semaphore_init(&st.sem, 0);
+  gpr_event_init(&st.evt);
+  st.spin_counter  = 0;
+  st.mutex_counter = 0;
+
+  gpr_assert(!gpr_semaphore_trywait(&st.sem));
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_create(&threads[i], sync_test_worker, &st);
+
+  // every worker posts once when done
+  for (i = 0; i < SYNC_THREADS; ++i)
+    gpr_semaphore_wait(&st.sem);
+
+  gpr_assert(st.spin_counter  == SYNC_THREADS*SYNC_LOOPS);
+  gpr_assert(st.mutex_counter == SYNC_THREADS*SYNC_LOOPS);
+
+  // each set releases exactly one worker
+  for (i = 0; i < SYNC_THREADS; ++i)
+  {
+    gpr_event_set(&st.evt);
+    gpr_semaphore_wait(&st.sem);
+  }
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_join(threads[i], NULL);
+
+  gpr_assert(gpr_mutex_trylock(&st.mutex));
+  gpr_assert(!gpr_mutex_trylock(&st.mutex));
+  gpr_mutex_unlock(&st.mutex);
+}
+
+// ---------------------------------------------------------------
+// Reader-writer lock & sequence lock test
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  gpr_rwlock_t  rwlock;
+  gpr_seqlock_t seqlock;
+  I32           rw_a, rw_b;  // rw_a + rw_b == 0 outside the write lock
+  I32           seq_a, seq_b;
+  U32           failures;
+} rwlock_test_t;
+
+static int rwlock_test_reader(void *arg)
+{
+  rwlock_test_t *rt = (rwlock_test_t*)arg;
+  int i;
+
+  for (i = 0; i < SYNC_LOOPS; ++i)
+  {
+    I32 a, b;
+    U32 seq;
+
+    gpr_rwlock_read_lock(&rt->rwlock);
+    if (rt->rw_a + rt->rw_b != 0) ++rt->failures;
+    gpr_rwlock_read_unlock(&rt->rwlock);
+
+    do {
+      seq = gpr_seqlock_read_begin(&rt->seqlock);
+      a = rt->seq_a;
+      b = rt->seq_b;
+    } while (gpr_seqlock_read_retry(&rt->seqlock, seq));
+    if (a + b != 0) ++rt->failures;
+  }
+  return 0;
+}
+
+static int rwlock_test_writer(void *arg)
+{
+  rwlock_test_t *rt = (rwlock_test_t*)arg;
+  int i;
+
+  for (i = 0; i < SYNC_LOOPS; ++i)
+  {
+    gpr_rwlock_write_lock(&rt->rwlock);
+    ++rt->rw_a;
+    --rt->rw_b;
+    gpr_rwlock_write_unlock(&rt->rwlock);
+
+    gpr_seqlock_write_lock(&rt->seqlock);
+    ++rt->seq_a;
+    --rt->seq_b;
+    gpr_seqlock_write_unlock(&rt->seqlock);
+  }
+  return 0;
+}
+
+void test_rwlock()
+{
+  rwlock_test_t rt;
+  thrd_t        threads[SYNC_THREADS];
+  int           i;
+
+  gpr_rwlock_init(&rt.rwlock);
+  gpr_seqlock_init(&rt.seqlock);
+  rt.rw_a = rt.rw_b = rt.seq_a = rt.seq_b = 0;
+  rt.failures = 0;
+
+  thrd_create(&threads[0], rwlock_test_writer, &rt);
+  thrd_create(&threads[1], rwlock_test_writer, &rt);
+  for (i = 2; i < SYNC_THREADS; ++i)
+    thrd_create(&threads[i], rwlock_test_reader, &rt);
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_join(threads[i], NULL);
+
+  gpr_assert(rt.failures == 0);
+  gpr_assert(rt.rw_a  == 2*SYNC_LOOPS);
+  gpr_assert(rt.seq_a == 2*SYNC_LOOPS);
+
+  gpr_assert(gpr_rwlock_read_trylock(&rt.rwlock));
+  gpr_assert(gpr_rwlock_read_trylock(&rt.rwlock));
+  gpr_rwlock_read_unlock(&rt.rwlock);
+  gpr_rwlock_read_unlock(&rt.rwlock);
+}
+
+// ---------------------------------------------------------------
+// Epoch based reclamation test
+// ---------------------------------------------------------------
+
+#define EPOCH_MAGIC 0x600dbeefu
+
+typedef struct
+{
+  U32 magic;
+  U32 value;
+} epoch_block_t;
+
+// blocks come from a preallocated array and are only poisoned when freed,
+// so a reader touching a reclaimed block always notices it
+typedef struct
+{
+  gpr_allocator_t base;
+  epoch_block_t  *blocks;
+  U32             num_allocated;
+  U32             num_freed;
+} epoch_allocator_t;
+
+static void *epoch_allocate(epoch_allocator_t *a, U32 size, U32 align)
+{
+  epoch_block_t *b = &a->blocks[a->num_allocated++];
+  b->magic = EPOCH_MAGIC;
+  return b;
+}
+
+static void epoch_deallocate(epoch_allocator_t *a, void *p)
+{
+  ((epoch_block_t*)p)->magic = 0;
+  ++a->num_freed;
+}
+
+static U32 epoch_allocated_for(epoch_allocator_t *a, void *p)
+{ return sizeof(epoch_block_t); }
+
+static U32 epoch_allocated_tot(epoch_allocator_t *a)
+{ return (a->num_allocated - a->num_freed)*sizeof(epoch_block_t); }
+
+typedef struct
+{
+  gpr_epoch_t         epoch;
+  gpr_epoch_thread_t  records[SYNC_THREADS];
+  epoch_allocator_t   blocks;
+  epoch_block_t      *volatile shared;
+  volatile U32        done;
+  U32                 failures;
+} epoch_test_t;
+
+typedef struct
+{
+  epoch_test_t *et;
+  U32           i;
+} epoch_test_arg_t;
+
+static int epoch_test_reader(void *arg)
+{
+  epoch_test_arg_t   *ea = (epoch_test_arg_t*)arg;
+  epoch_test_t       *et = ea->et;
+  gpr_epoch_thread_t *t  = &et->records[ea->i];
+
+  while (!et->done)
+  {
+    epoch_block_t *b;
+    gpr_epoch_enter(&et->epoch, t);
+    b = et->shared;
+    if (b->magic != EPOCH_MAGIC) ++et->failures;
+    gpr_epoch_exit(&et->epoch, t);
+  }
+  return 0;
+}
+
+static int epoch_test_writer(void *arg)
+{
+  epoch_test_arg_t   *ea = (epoch_test_arg_t*)arg;
+  epoch_test_t       *et = ea->et;
+  gpr_epoch_thread_t *t  = &et->records[ea->i];
+  gpr_allocator_t    *a  = (gpr_allocator_t*)&et->blocks;
+  U32 i;
+
+  for (i = 0; i < SYNC_LOOPS; ++i)
+  {
+    epoch_block_t *old = et->shared;
+    epoch_block_t *b   = (epoch_block_t*)gpr_allocate(a, sizeof(epoch_block_t));
+    b->value = i;
+    et->shared = b;
+    gpr_epoch_retire(&et->epoch, t, old, a);
+  }
+  et->done = 1;
+  return 0;
+}
+
+void test_epoch()
+{
+  epoch_test_t       et;
+  epoch_test_arg_t   args[SYNC_THREADS];
+  thrd_t             threads[SYNC_THREADS];
+  gpr_epoch_thread_t *t;
+  void *p;
+  int   i;
+
+  gpr_memory_init(4*1024);
+  gpr_epoch_init(&et.epoch, gpr_default_allocator);
+
+  // single thread: a block is freed two epochs after its retirement
+  t = &et.records[0];
+  gpr_epoch_register(&et.epoch, t, gpr_default_allocator);
+
+  gpr_epoch_enter(&et.epoch, t);
+  p = gpr_allocate(gpr_default_allocator, 16);
+  gpr_epoch_retire(&et.epoch, t, p, gpr_default_allocator);
+  gpr_assert(gpr_epoch_reclaim(&et.epoch, t) == 0);
+  gpr_assert(gpr_epoch_reclaim(&et.epoch, t) == 0);
+  gpr_epoch_exit(&et.epoch, t);
+  gpr_assert(gpr_epoch_reclaim(&et.epoch, t) == 1);
+
+  gpr_epoch_unregister(&et.epoch, t);
+
+  // one writer swapping a block, concurrent readers
+  et.blocks.blocks = (epoch_block_t*)gpr_allocate(gpr_default_allocator, 
+    (SYNC_LOOPS+1)*sizeof(epoch_block_t));
+  et.blocks.num_allocated = 0;
+  et.blocks.num_freed     = 0;
+  gpr_set_allocator_functions(&et.blocks, epoch_allocate, epoch_deallocate,
+    epoch_allocated_for, epoch_allocated_tot);
+
+  et.shared   = (epoch_block_t*)gpr_allocate((gpr_allocator_t*)&et.blocks, 
+    sizeof(epoch_block_t));
+  et.done     = 0;
+  et.failures = 0;
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+  {
+    args[i].et = &et;
+    args[i].i  = i;
+    gpr_epoch_register(&et.epoch, &et.records[i], gpr_default_allocator);
+  }
+  for (i = 1; i < SYNC_THREADS; ++i)
+    thrd_create(&threads[i], epoch_test_reader, &args[i]);
+  thrd_create(&threads[0], epoch_test_writer, &args[0]);
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_join(threads[i], NULL);
+  gpr_assert(et.failures == 0);
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    gpr_epoch_unregister(&et.epoch, &et.records[i]);
+
+  gpr_epoch_destroy(&et.epoch);
+  gpr_assert(et.blocks.num_freed == SYNC_LOOPS);
+  gpr_deallocate(gpr_default_allocator, et.blocks.blocks);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Job system test
+// ---------------------------------------------------------------
+
+#define JOB_LEAF_SIZE 1000
+
+typedef struct
+{
+  U32 begin, end;
+  U64 sum;
+} sum_job_t;
+
+// splits the range in two sub-jobs and waits for them
+static void sum_job(gpr_job_system_t *js, void *arg)
+{
+  sum_job_t *sj = (sum_job_t*)arg;
+
+  if (sj->end - sj->begin <= JOB_LEAF_SIZE)
+  {
+    U32 i;
+    sj->sum = 0;
+    for (i = sj->begin; i < sj->end; ++i) sj->sum += i;
+  }
+  else
+  {
+    sum_job_t         halves[2];
+    gpr_job_t         jobs[2];
+    gpr_job_counter_t counter;
+    const U32         mid = sj->begin + (sj->end - sj->begin)/2;
+
+    halves[0].begin = sj->begin; halves[0].end = mid;
+    halves[1].begin = mid;       halves[1].end = sj->end;
+    jobs[0].func = sum_job; jobs[0].arg = &halves[0];
+    jobs[1].func = sum_job; jobs[1].arg = &halves[1];
+
+    gpr_job_counter_init(&counter);
+    gpr_job_run(js, jobs, 2, &counter);
+    gpr_job_wait(js, &counter);
+    sj->sum = halves[0].sum + halves[1].sum;
+  }
+}
+
+void test_job()
+{
+  gpr_job_system_t  js;
+  gpr_job_counter_t counter;
+  gpr_job_t         job;
+  sum_job_t         sj;
+
+  gpr_memory_init(4*1024);
+  // far less workers than waiting jobs: the waits must yield
+  gpr_job_system_init(&js, 2, 16, GPR_FIBER_DEFAULT_STACK_SIZE, 
+    gpr_default_allocator);
+
+  sj.begin = 0;
+  sj.end   = 100000;
+  job.func = sum_job;
+  job.arg  = &sj;
+
+  gpr_job_counter_init(&counter);
+  gpr_job_run(&js, &job, 1, &counter);
+  gpr_job_wait(&js, &counter);
+  gpr_assert(sj.sum == (U64)99999*100000/2);
+  // 255 jobs ran: the fibers of the finished ones were reused
+  gpr_assert(gpr_array_size(&js.fibers.all) < 255);
+
+  gpr_job_system_destroy(&js);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Hash growth, removal & batched lookups test
+// ---------------------------------------------------------------
+
+#define GROWTH_KEYS 20000
+
+void test_hash_growth()
+{
+  gpr_hash_t h;
+  U64        i;
+  I32        v;
+
+  gpr_memory_init(0);
+  gpr_hash_init(I32, &h, gpr_default_allocator);
+
+  // every key must stay reachable while the buckets are migrated
+  for (i = 0; i < GROWTH_KEYS; ++i)
+  {
+    v = (I32)i;
+    gpr_hash_set(I32, &h, i*7, &v);
+    gpr_assert(*gpr_hash_get(I32, &h, i*7) == (I32)i);
+    gpr_assert(*gpr_hash_get(I32, &h, i/2*7) == (I32)(i/2));
+  }
+
+  for (i = 0; i < GROWTH_KEYS; i += 2)
+    gpr_hash_remove(I32, &h, i*7);
+
+  for (i = 0; i < GROWTH_KEYS; ++i)
+  {
+    I32 *e = gpr_hash_get(I32, &h, i*7);
+    if (i & 1) gpr_assert(e && *e == (I32)i);
+    else       gpr_assert(e == NULL);
+  }
+  gpr_assert(h.num_values == GROWTH_KEYS/2);
+
+  // batched lookups, with a size that is not a multiple of the batch
+  {
+    U64  keys[37];
+    I32 *values[37];
+    I32  found[37];
+    for (i = 0; i < 37; ++i) keys[i] = (i + 100)*7;
+    gpr_hash_get_many(I32, &h, keys, 37, values);
+    gpr_hash_has_many(I32, &h, keys, 37, found);
+    for (i = 0; i < 37; ++i)
+    {
+      gpr_assert(found[i] == (I32)((i + 100) & 1));
+      gpr_assert(found[i] ? *values[i] == (I32)(i + 100) : values[i] == NULL);
+    }
+  }
+
+  // multi hash removal of a value that is not the first of its key
+  {
+    gpr_hash_it it;
+    I32        *e;
+    v = 1; gpr_multi_hash_insert(I32, &h, 1, &v);
+    v = 2; gpr_multi_hash_insert(I32, &h, 1, &v);
+    e = gpr_multi_hash_find_first(I32, &h, &it, 1);
+    e = gpr_multi_hash_find_next(I32, &h, &it);
+    v = *e;
+    gpr_multi_hash_remove(I32, &h, e);
+    gpr_assert(gpr_multi_hash_count(I32, &h, 1) == 1);
+    gpr_assert(*gpr_multi_hash_find_first(I32, &h, NULL, 1) != v);
+  }
+
+  gpr_hash_destroy(I32, &h);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Hash bulk build test
+// ---------------------------------------------------------------
+
+#define BUILD_KEYS 5000
+
+void test_hash_build()
+{
+  gpr_hash_t h;
+  U64        keys[BUILD_KEYS];
+  I32        values[BUILD_KEYS];
+  U32        i;
+  I32        v;
+
+  gpr_memory_init(0);
+
+  for (i = 0; i < BUILD_KEYS; ++i)
+  {
+    keys[i]   = (U64)i*0x9e3779b97f4a7c15ull;
+    values[i] = (I32)i;
+  }
+
+  gpr_hash_init(I32, &h, gpr_default_allocator);
+  gpr_hash_build(I32, &h, keys, values, BUILD_KEYS);
+  for (i = 0; i < BUILD_KEYS; ++i)
+    gpr_assert(*gpr_hash_get(I32, &h, keys[i]) == (I32)i);
+
+  // the built hash must support the regular operations
+  for (i = 0; i < BUILD_KEYS; i += 2)
+    gpr_hash_remove(I32, &h, keys[i]);
+  for (i = 0; i < BUILD_KEYS; ++i)
+  {
+    v = -(I32)i;
+    gpr_hash_set(I32, &h, i, &v);
+  }
+  for (i = 0; i < BUILD_KEYS; ++i)
+  {
+    gpr_assert(*gpr_hash_get(I32, &h, i) == -(I32)i);
+    if (i & 1) gpr_assert(*gpr_hash_get(I32, &h, keys[i]) == (I32)i);
+    else       gpr_assert(!gpr_hash_has(I32, &h, keys[i]) || keys[i] < BUILD_KEYS);
+  }
+  gpr_hash_destroy(I32, &h);
+
+  // duplicate keys
+  for (i = 0; i < BUILD_KEYS; ++i) keys[i] = i % 10;
+  gpr_multi_hash_init(I32, &h, gpr_default_allocator);
+  gpr_multi_hash_build(I32, &h, keys, values, BUILD_KEYS);
+  for (i = 0; i < 10; ++i)
+    gpr_assert(gpr_multi_hash_count(I32, &h, i) == BUILD_KEYS/10);
+  gpr_multi_hash_destroy(I32, &h);
+
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Frozen hash test
+// ---------------------------------------------------------------
+
+#define FROZEN_KEYS 10000
+
+static void check_frozen_hash(gpr_frozen_hash_t *fh)
+{
+  U64 i;
+  for (i = 0; i < FROZEN_KEYS; ++i)
+  {
+    gpr_assert(*gpr_frozen_hash_get(I32, fh, i*i) == (I32)i);
+    gpr_assert(!gpr_frozen_hash_has(I32, fh, i*i + 2));
+  }
+}
+
+void test_frozen_hash()
+{
+  gpr_hash_t        h;
+  gpr_frozen_hash_t fh, loaded, mapped;
+  U64               i;
+  I32               v;
+
+  gpr_memory_init(0);
+  gpr_hash_init(I32, &h, gpr_default_allocator);
+  for (i = 0; i < FROZEN_KEYS; ++i)
+  {
+    v = (I32)i;
+    gpr_hash_set(I32, &h, i*i, &v);
+  }
+
+  gpr_assert(gpr_frozen_hash_build(I32, &fh, &h, gpr_default_allocator));
+  gpr_hash_destroy(I32, &h);
+  check_frozen_hash(&fh);
+
+  gpr_assert(gpr_frozen_hash_load(&loaded, fh.header, fh.header->size));
+  check_frozen_hash(&loaded);
+  gpr_assert(!gpr_frozen_hash_load(&loaded, fh.header, fh.header->size - 8));
+
+  // a remapped position past the keys is rejected
+  {
+    char *blob = (char*)gpr_allocate_align(gpr_default_allocator, fh.header->size, 8);
+    memcpy(blob, fh.header, fh.header->size);
+    ((U32*)(blob + fh.header->remap_pos))[0] = fh.num_keys;
+    gpr_assert(!gpr_frozen_hash_load(&mapped, blob, fh.header->size));
+    gpr_deallocate(gpr_default_allocator, blob);
+  }
+
+  gpr_assert(gpr_frozen_hash_save(&fh, "frozen_hash_test.bin"));
+  gpr_assert(gpr_frozen_hash_map(&mapped, "frozen_hash_test.bin"));
+  check_frozen_hash(&mapped);
+  gpr_frozen_hash_destroy(&mapped);
+  remove("frozen_hash_test.bin");
+
+  gpr_frozen_hash_destroy(&loaded);
+  gpr_frozen_hash_destroy(&fh);
+
+  // empty table
+  gpr_hash_init(I32, &h, gpr_default_allocator);
+  gpr_assert(gpr_frozen_hash_build(I32, &fh, &h, gpr_default_allocator));
+  gpr_assert(!gpr_frozen_hash_has(I32, &fh, 0));
+  gpr_frozen_hash_destroy(&fh);
+  gpr_hash_destroy(I32, &h);
+
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Hash set test
+// ---------------------------------------------------------------
+
+#define SET_KEYS 4096
+
+void test_hash_set()
+{
+  gpr_hash_set_t s;
+  static U8      ref[SET_KEYS];
+  U32            i, it, n = 0;
+
+  gpr_memory_init(0);
+  gpr_hash_set_init(&s, gpr_default_allocator);
+  memset(ref, 0, sizeof(ref));
+
+  // random insertions & removals, checked against a bitmap
+  srand(1);
+  for (it = 0; it < 100000; ++it)
+  {
+    const U64 key = (U64)(rand() % SET_KEYS);
+    if (rand() % 3)
+    {
+      gpr_assert(gpr_hash_set_insert(&s, key) == !ref[key]);
+      n += !ref[key];
+      ref[key] = 1;
+    }
+    else
+    {
+      gpr_assert(gpr_hash_set_remove(&s, key) == ref[key]);
+      n -= ref[key];
+      ref[key] = 0;
+    }
+  }
+  gpr_assert(gpr_hash_set_size(&s) == n);
+  for (i = 0; i < SET_KEYS; ++i)
+    gpr_assert(gpr_hash_set_has(&s, i) == ref[i]);
+
+  gpr_hash_set_clear(&s);
+  gpr_assert(!gpr_hash_set_has(&s, 0) && gpr_hash_set_size(&s) == 0);
+
+  gpr_hash_set_destroy(&s);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Multi map test
+// ---------------------------------------------------------------
+
+void test_multi_map()
+{
+  gpr_multi_map_t m;
+  I32            *e;
+  U32             i, key, count;
+  I32             v;
+
+  gpr_memory_init(0);
+  gpr_multi_map_init(I32, &m, gpr_default_allocator);
+
+  // interleaved insertions: the runs are moved as they grow
+  for (i = 0; i < 1000; ++i)
+  {
+    v = (I32)i;
+    gpr_multi_map_insert(I32, &m, i % 7, &v);
+  }
+  for (key = 0; key < 7; ++key)
+  {
+    e = gpr_multi_map_range(I32, &m, key, &count);
+    gpr_assert(count == gpr_multi_map_count(I32, &m, key));
+    gpr_assert(count == (1000 + 6 - key)/7);
+    for (i = 0; i < count; ++i) gpr_assert(e[i] == (I32)(key + i*7));
+  }
+
+  // single removal
+  e = gpr_multi_map_range(I32, &m, 3, &count);
+  gpr_multi_map_remove(I32, &m, 3, e);
+  e = gpr_multi_map_range(I32, &m, 3, &count);
+  gpr_assert(count == 142);
+  for (i = 0; i < count; ++i) gpr_assert(e[i] != 3 && e[i] % 7 == 3);
+
+  // removals of whole runs & compaction
+  for (key = 0; key < 6; ++key)
+    gpr_multi_map_remove_all(I32, &m, key);
+  gpr_assert(gpr_multi_map_range(I32, &m, 0, &count) == NULL && count == 0);
+  gpr_assert(m.num_values == 142);
+  for (i = 0; i < 1000; ++i)
+  {
+    v = (I32)i;
+    gpr_multi_map_insert(I32, &m, 100 + i % 3, &v);
+  }
+  gpr_assert(gpr_multi_map_count(I32, &m, 6) == 142);
+  gpr_assert(gpr_multi_map_count(I32, &m, 101) == 333);
+  gpr_assert(m.num_holes <= m.num_values);
+
+  gpr_multi_map_destroy(I32, &m);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Hash statistics test
+// ---------------------------------------------------------------
+
+void test_hash_stats()
+{
+  gpr_hash_t       h;
+  gpr_hash_stats_t stats;
+  U64              i;
+  U32              n;
+#ifdef GPR_HASH_STATS
+  U64              keys[40], *values[40], lookups;
+  I32              has[40];
+#endif
+
+  gpr_memory_init(0);
+  gpr_hash_init(U64, &h, gpr_default_allocator);
+
+  gpr_hash_stats(&h, &stats);
+  gpr_assert(stats.num_values == 0 && stats.max_probe == 0);
+
+  for (i = 0; i < 10000; ++i) gpr_hash_set(U64, &h, i*13, &i);
+  for (i = 0; i < 10000; ++i) gpr_assert(*gpr_hash_get(U64, &h, i*13) == i);
+
+  gpr_hash_stats(&h, &stats);
+  gpr_assert(stats.num_values == 10000);
+  gpr_assert(stats.num_rehashes > 0);
+  gpr_assert(stats.load_factor > 0.0f && stats.load_factor <= 1.0f);
+  gpr_assert(stats.bytes_keys >= 10000*sizeof(U64));
+  gpr_assert(stats.bytes_values >= 10000*sizeof(U64));
+
+  // every value is counted once in the histogram
+#ifdef GPR_HASH_SWISS
+  for (i = 0, n = 0; i < GPR_HASH_STATS_HISTOGRAM; ++i) n += stats.histogram[i];
+  gpr_assert(n == stats.num_values);
+#else
+  for (i = 0, n = 0; i < GPR_HASH_STATS_HISTOGRAM; ++i) n += stats.histogram[i]*(U32)i;
+  gpr_assert(stats.max_probe >= GPR_HASH_STATS_HISTOGRAM - 1 || n == stats.num_values);
+#endif
+
+#ifdef GPR_HASH_STATS
+  gpr_assert(stats.num_lookups >= 10000 && stats.avg_probes > 0.0f);
+
+  // batched lookups are counted once per key, found or not
+  for (i = 0; i < 40; ++i) keys[i] = i*13 + (i & 1);
+  lookups = stats.num_lookups;
+  gpr_hash_get_many(U64, &h, keys, 40, values);
+  gpr_hash_has_many(U64, &h, keys, 40, has);
+  gpr_hash_stats(&h, &stats);
+  gpr_assert(stats.num_lookups == lookups + 80);
+  for (i = 0; i < 40; ++i) gpr_assert((values[i] != NULL) == !(i & 1) && has[i] == !(i & 1));
+#endif
+
+  gpr_hash_destroy(U64, &h);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Hash shrink test
+// ---------------------------------------------------------------
+
+void test_hash_shrink()
+{
+  gpr_hash_t       h;
+  gpr_hash_stats_t stats;
+  U64              i;
+
+  gpr_memory_init(0);
+  gpr_hash_init(U64, &h, gpr_default_allocator);
+
+  for (i = 0; i < 100000; ++i) gpr_hash_set(U64, &h, i*11, &i);
+  for (i = 1000; i < 100000; ++i) gpr_hash_remove(U64, &h, i*11);
+
+  // the table may already have shrunk with GPR_HASH_SHRINK_LOAD_FACTOR
+  gpr_hash_shrink_to_fit(U64, &h);
+  gpr_hash_stats(&h, &stats);
+  gpr_assert(stats.num_values == 1000);
+  gpr_assert(stats.num_buckets <= 2048);
+  gpr_assert(stats.bytes_buckets + stats.bytes_indices + stats.bytes_keys + 
+    stats.bytes_values < 128*1024);
+
+  for (i = 0; i < 1000; ++i) gpr_assert(*gpr_hash_get(U64, &h, i*11) == i);
+  for (i = 1000; i < 2000; ++i) gpr_assert(!gpr_hash_has(U64, &h, i*11));
+
+  // the table grows back as usual
+  for (i = 1000; i < 5000; ++i) gpr_hash_set(U64, &h, i*11, &i);
+  for (i = 0; i < 5000; ++i) gpr_assert(*gpr_hash_get(U64, &h, i*11) == i);
+
+  gpr_hash_destroy(U64, &h);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// RCU hash test
+// ---------------------------------------------------------------
+
+#define RCU_KEYS     64
+#define RCU_VERSIONS 2000
+
+typedef struct
+{
+  gpr_rcu_hash_t     rh;
+  gpr_epoch_t        epoch;
+  gpr_epoch_thread_t records[SYNC_THREADS];
+  volatile U32       done;
+  volatile U32       failures;
+  U32                thread_i;
+} rcu_test_t;
+
+// every key of a version holds the same value
+static int rcu_test_reader(void *arg)
+{
+  rcu_test_t         *rt = (rcu_test_t*)arg;
+  gpr_epoch_thread_t *t  = &rt->records[gpr_atomic_add_U32(&rt->thread_i, 1)];
+  U32 k, v, last = 0;
+
+  while (!rt->done)
+  {
+    gpr_hash_t *h = gpr_rcu_hash_enter(&rt->rh, t);
+    v = *gpr_hash_get(U32, h, 0);
+    for (k = 1; k < RCU_KEYS; ++k)
+      if (*gpr_hash_get(U32, h, k) != v) gpr_atomic_add_U32(&rt->failures, 1);
+    gpr_rcu_hash_exit(&rt->rh, t);
+
+    // versions are never seen out of order
+    if (v < last) gpr_atomic_add_U32(&rt->failures, 1);
+    last = v;
+  }
+  return 0;
+}
+
+void test_rcu_hash()
+{
+  rcu_test_t          rt;
+  thrd_t              threads[SYNC_THREADS];
+  gpr_epoch_thread_t *t;
+  gpr_hash_t         *h;
+  U32 i, k, v;
+
+  gpr_memory_init(0);
+  gpr_epoch_init(&rt.epoch, gpr_default_allocator);
+  gpr_rcu_hash_init(U32, &rt.rh, &rt.epoch, gpr_default_allocator);
+  for (i = 0; i < SYNC_THREADS; ++i)
+    gpr_epoch_register(&rt.epoch, &rt.records[i], gpr_default_allocator);
+  t = &rt.records[0];
+
+  // single updates
+  v = 7;
+  gpr_assert(!gpr_rcu_hash_get(U32, &rt.rh, t, 1000, &v) && v == 7);
+  gpr_rcu_hash_set(U32, &rt.rh, t, 1000, &v);
+  v = 0;
+  gpr_assert(gpr_rcu_hash_get(U32, &rt.rh, t, 1000, &v) && v == 7);
+  gpr_assert(gpr_rcu_hash_remove(U32, &rt.rh, t, 1000));
+  gpr_assert(!gpr_rcu_hash_remove(U32, &rt.rh, t, 1000));
+  gpr_assert(!gpr_rcu_hash_has(&rt.rh, t, 1000));
+
+  // a cancelled write is never seen
+  h = gpr_rcu_hash_write_begin(&rt.rh);
+  gpr_hash_set(U32, h, 1000, &v);
+  gpr_rcu_hash_write_cancel(&rt.rh);
+  gpr_assert(!gpr_rcu_hash_has(&rt.rh, t, 1000));
+
+  // a snapshot is not affected by later versions
+  v = 0;
+  h = gpr_rcu_hash_write_begin(&rt.rh);
+  for (k = 0; k < RCU_KEYS; ++k) gpr_hash_set(U32, h, k, &v);
+  gpr_rcu_hash_write_end(&rt.rh, t);
+
+  h = gpr_rcu_hash_enter(&rt.rh, t);
+  v = 1;
+  gpr_rcu_hash_set(U32, &rt.rh, t, 0, &v);
+  gpr_assert(*gpr_hash_get(U32, h, 0) == 0);
+  gpr_rcu_hash_exit(&rt.rh, t);
+  v = 0;
+  gpr_rcu_hash_set(U32, &rt.rh, t, 0, &v);
+
+  // one writer publishing versions, concurrent readers
+  rt.done     = 0;
+  rt.failures = 0;
+  rt.thread_i = 1;
+  for (i = 1; i < SYNC_THREADS; ++i)
+    thrd_create(&threads[i], rcu_test_reader, &rt);
+
+  for (v = 1; v <= RCU_VERSIONS; ++v)
+  {
+    h = gpr_rcu_hash_write_begin(&rt.rh);
+    for (k = 0; k < RCU_KEYS; ++k) gpr_hash_set(U32, h, k, &v);
+    gpr_hash_set(U32, h, RCU_KEYS + v, &v);
+    gpr_rcu_hash_write_end(&rt.rh, t);
+  }
+  rt.done = 1;
+
+  for (i = 1; i < SYNC_THREADS; ++i)
+    thrd_join(threads[i], NULL);
+  gpr_assert(rt.failures == 0);
+
+  h = gpr_rcu_hash_enter(&rt.rh, t);
+  gpr_assert(h->num_values == RCU_KEYS + RCU_VERSIONS);
+  gpr_rcu_hash_exit(&rt.rh, t);
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    gpr_epoch_unregister(&rt.epoch, &rt.records[i]);
+  gpr_rcu_hash_destroy(&rt.rh);
+  gpr_epoch_destroy(&rt.epoch);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Disk hash test
+// ---------------------------------------------------------------
+
+typedef struct
+{
+  U64 id;
+  U32 count;
+} disk_record_t;
+
+void test_disk_hash()
+{
+  gpr_disk_hash_t dh;
+  disk_record_t   r, *p;
+  U64             i;
+
+  remove("disk_hash_test.bin");
+  gpr_assert(gpr_disk_hash_open(disk_record_t, &dh, "disk_hash_test.bin", 1000));
+
+  // the file grows several times
+  for (i = 0; i < 10000; ++i)
+  {
+    r.id    = i;
+    r.count = (U32)i*3;
+    gpr_assert(gpr_disk_hash_set(disk_record_t, &dh, i*7, &r));
+  }
+  for (i = 0; i < 10000; i += 2)
+    gpr_assert(gpr_disk_hash_remove(disk_record_t, &dh, i*7));
+  gpr_assert(!gpr_disk_hash_remove(disk_record_t, &dh, 0));
+
+  // removed entries are reused
+  r.id = 1000000;
+  gpr_assert(gpr_disk_hash_set(disk_record_t, &dh, 1, &r));
+  gpr_assert(((gpr_disk_hash_header_t*)dh.map.data)->num_entries == 10000);
+  gpr_assert(gpr_disk_hash_size(disk_record_t, &dh) == 5001);
+  gpr_assert(gpr_disk_hash_close(&dh));
+
+  // reopened in place
+  gpr_assert(!gpr_disk_hash_open(U32, &dh, "disk_hash_test.bin", 0));
+  gpr_assert(gpr_disk_hash_open(disk_record_t, &dh, "disk_hash_test.bin", 0));
+  gpr_assert(gpr_disk_hash_size(disk_record_t, &dh) == 5001);
+  for (i = 0; i < 10000; ++i)
+  {
+    p = gpr_disk_hash_get(disk_record_t, &dh, i*7);
+    gpr_assert((i & 1) ? (p && p->id == i && p->count == i*3) : p == NULL);
+  }
+  gpr_assert(gpr_disk_hash_get(disk_record_t, &dh, 1)->id == 1000000);
+
+  // no rebuild of the buckets while filling a reserved table
+  gpr_assert(gpr_disk_hash_reserve(disk_record_t, &dh, 100000));
+  for (i = 0; i < 100000; ++i)
+  {
+    r.id = i;
+    gpr_assert(gpr_disk_hash_set(disk_record_t, &dh, i*7 + 3, &r));
+  }
+  gpr_assert(gpr_disk_hash_has(disk_record_t, &dh, 7));
+  gpr_assert(gpr_disk_hash_has(disk_record_t, &dh, 99999*7 + 3));
+  gpr_assert(gpr_disk_hash_close(&dh));
+  remove("disk_hash_test.bin");
+}
+
+// ---------------------------------------------------------------
+// Streaming murmur hash test
+// ---------------------------------------------------------------
+
+void test_murmur_hash_stream()
+{
+  gpr_murmur_hash_64_state_t st;
+  char data[80];
+  U32  len, split, step, i;
+
+  for (i = 0; i < sizeof(data); ++i) data[i] = (char)(i*37 + 11);
+
+  for (len = 0; len <= 70; ++len)
+  {
+    const U64 expected = gpr_murmur_hash_64(data + 1, len, len);
+
+    // two pieces split anywhere
+    for (split = 0; split <= len; ++split)
+    {
+      gpr_murmur_hash_64_init(&st, len, len);
+      gpr_murmur_hash_64_update(&st, data + 1, split);
+      gpr_murmur_hash_64_update(&st, data + 1 + split, len - split);
+      gpr_assert(gpr_murmur_hash_64_final(&st) == expected);
+    }
+
+    // pieces of every size
+    for (step = 1; step <= 9; ++step)
+    {
+      gpr_murmur_hash_64_init(&st, len, len);
+      for (i = 0; i < len; i += step)
+        gpr_murmur_hash_64_update(&st, data + 1 + i, len - i < step ? len - i : step);
+      gpr_assert(gpr_murmur_hash_64_final(&st) == expected);
+    }
+  }
+}
+
+// ---------------------------------------------------------------
+// Fast hash test
+// ---------------------------------------------------------------
+
+#define FAST_HASH_DATA 2100
+
+void test_fast_hash()
+{
+  static U8     data[FAST_HASH_DATA + 8], copy[FAST_HASH_DATA + 8];
+  U64           h[GPR_FAST_HASH_NEON + 1], r;
+  gpr_hash128_t h128, r128;
+  U32           len, impl, i, def = gpr_fast_hash_impl();
+
+  for (i = 0; i < sizeof(data); ++i) data[i] = (U8)(i*131 + (i >> 5));
+
+  for (len = 0; len <= FAST_HASH_DATA; len += (len < 600 ? 1 : 37))
+  {
+    // every implementation gives the same digest
+    for (impl = 0; impl <= GPR_FAST_HASH_NEON; ++impl)
+    {
+      if (!gpr_fast_hash_use(impl)) continue;
+      h[impl] = gpr_fast_hash_64(data, len, 1);
+      gpr_assert(h[impl] == h[GPR_FAST_HASH_SCALAR]);
+      h128 = gpr_fast_hash_128(data, len, 1);
+      if (impl == GPR_FAST_HASH_SCALAR) r128 = h128;
+      gpr_assert(h128.lo == r128.lo && h128.hi == r128.hi);
+    }
+    gpr_fast_hash_use(def);
+    r = h[GPR_FAST_HASH_SCALAR];
+
+    // unaligned keys
+    memcpy(copy + 3, data, len);
+    gpr_assert(gpr_fast_hash_64(copy + 3, len, 1) == r);
+
+    // the seed, the length and every byte matter
+    gpr_assert(gpr_fast_hash_64(data, len, 2) != r);
+    gpr_assert(gpr_fast_hash_64(data, len + 1, 1) != r);
+    if (len)
+    {
+      copy[3 + len/3] ^= 0x10;
+      gpr_assert(gpr_fast_hash_64(copy + 3, len, 1) != r);
+      copy[3 + len - 1] ^= 0x01;
+      gpr_assert(gpr_fast_hash_64(copy + 3, len, 1) != r);
+    }
+    gpr_assert(r128.lo != r128.hi);
+  }
+  gpr_assert(gpr_fast_hash_impl() == def);
+}
+
+// ---------------------------------------------------------------
+// String pool interning test
+// ---------------------------------------------------------------
+
+void test_string_pool_interning()
+{
+  gpr_string_pool_t sp;
+  gpr_string_t      id, sub, full, world, big;
+  char              long_string[1000];
+
+  gpr_memory_init(0);
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+
+  // ids: only size bytes are read, equal strings have equal ids
+  id  = gpr_string_pool_get_id(&sp, "hello");
+  sub = gpr_string_pool_nget_id(&sp, "hello world!", 5);
+  gpr_assert(id == sub && id != GPR_STRING_NULL);
+  gpr_assert(gpr_string_pool_size(&sp, id) == 5);
+  gpr_assert(strcmp(gpr_string_pool_string(&sp, id), "hello") == 0);
+  gpr_assert(gpr_string_pool_hash(&sp, id) == gpr_murmur_hash_64("hello", 5, 0));
+  gpr_assert(gpr_string_pool_id(gpr_string_pool_string(&sp, id)) == id);
+  gpr_assert(gpr_string_pool_find_id(&sp, "hello!", 5) == id);
+  gpr_assert(gpr_string_pool_find_id(&sp, "hell", 4) == GPR_STRING_NULL);
+  full = gpr_string_pool_nget_id(&sp, "hello world!", 12);
+  gpr_assert(full != id);
+
+  gpr_string_pool_release_id(&sp, sub);
+  gpr_assert(gpr_string_pool_has(&sp, "hello"));
+  gpr_string_pool_release_id(&sp, id);
+  gpr_assert(!gpr_string_pool_has(&sp, "hello"));
+
+  // the slot and the id of a released string are reused
+  world = gpr_string_pool_get_id(&sp, "world");
+  gpr_assert(world == id);
+  gpr_assert(strcmp(gpr_string_pool_string(&sp, world), "world") == 0);
+
+  // strings longer than the slot classes are allocated alone
+  memset(long_string, 'x', sizeof(long_string) - 1);
+  long_string[sizeof(long_string) - 1] = '\0';
+  big = gpr_string_pool_get_id(&sp, long_string);
+  gpr_assert(gpr_string_pool_size(&sp, big) == sizeof(long_string) - 1);
+  gpr_assert(gpr_string_pool_get_id(&sp, long_string) == big);
+  gpr_string_pool_release_id(&sp, big);
+  gpr_string_pool_release_id(&sp, big);
+  gpr_assert(!gpr_string_pool_has(&sp, long_string));
+
+  // char* releases: by an equal copy, or by the pooled pointer itself
+  strcpy(long_string, "hello world!");
+  gpr_assert(gpr_string_pool_get(&sp, "hello world!") == gpr_string_pool_string(&sp, full));
+  gpr_string_pool_release(&sp, long_string);
+  gpr_assert(gpr_string_pool_has(&sp, "hello world!"));
+  gpr_string_pool_release_pooled(&sp, gpr_string_pool_string(&sp, full));
+  gpr_assert(!gpr_string_pool_has(&sp, "hello world!"));
+
+  gpr_string_pool_release_id(&sp, world);
+  gpr_string_pool_destroy(&sp);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// ID lookup table generations test
+// ---------------------------------------------------------------
+
+#define IDLUT_ITEMS 300
+
+void test_idlut_generations()
+{
+  gpr_idlut_t t;
+  U64         ids[IDLUT_ITEMS], stale;
+  U32         i, n, value;
+
+  gpr_memory_init(0);
+  gpr_idlut_init(U32, &t, gpr_default_allocator);
+  gpr_assert(sizeof(gpr_idlut_index_t) == 8);
+
+  // the index of a removed item comes back with a new generation
+  value = 7;
+  stale = gpr_idlut_add(U32, &t, &value);
+  gpr_idlut_remove(U32, &t, stale);
+  gpr_assert(!gpr_idlut_has(U32, &t, stale));
+  n = 0;
+  do
+  {
+    gpr_assert(n < IDLUT_ITEMS);
+    value  = n*3;
+    ids[n] = gpr_idlut_add(U32, &t, &value);
+  } while ((U32)ids[n++] != (U32)stale);
+  gpr_assert(ids[n-1] >> 32 == (stale >> 32) + 1);
+  gpr_assert(!gpr_idlut_has(U32, &t, stale) && gpr_idlut_has(U32, &t, ids[n-1]));
+
+  // the table grows several times
+  for (; n < IDLUT_ITEMS; ++n)
+  {
+    value  = n*3;
+    ids[n] = gpr_idlut_add(U32, &t, &value);
+  }
+  for (i = 0; i < IDLUT_ITEMS; ++i)
+    gpr_assert(gpr_idlut_has(U32, &t, ids[i]) && *gpr_idlut_lookup(U32, &t, ids[i]) == i*3);
+
+  // the last item is removed in place, a middle one is replaced by the last
+  gpr_idlut_remove(U32, &t, ids[IDLUT_ITEMS-1]);
+  gpr_idlut_remove(U32, &t, ids[10]);
+  gpr_assert(!gpr_idlut_has(U32, &t, ids[IDLUT_ITEMS-1]) && !gpr_idlut_has(U32, &t, ids[10]));
+  gpr_assert(gpr_idlut_end(U32, &t) - gpr_idlut_begin(U32, &t) == IDLUT_ITEMS - 2);
+  gpr_assert(gpr_idlut_begin(U32, &t)[10] == (IDLUT_ITEMS-2)*3);
+  for (i = 0; i < IDLUT_ITEMS - 1; ++i)
+    if (i != 10) gpr_assert(*gpr_idlut_lookup(U32, &t, ids[i]) == i*3);
+
+  gpr_idlut_destroy(U32, &t);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Batch hash test
+// ---------------------------------------------------------------
+
+#define BATCH_KEYS 203
+
+void test_hash_batch()
+{
+  static U8         data[BATCH_KEYS*3 + 64];
+  const void       *keys[BATCH_KEYS];
+  U32               lens[BATCH_KEYS];
+  U64               out[BATCH_KEYS + 1];
+  static char       names[BATCH_KEYS][8];
+  const char       *strings[BATCH_KEYS];
+  gpr_string_t      ids[BATCH_KEYS];
+  gpr_string_pool_t sp;
+  U32               i;
+
+  for (i = 0; i < sizeof(data); ++i) data[i] = (U8)(i*167 + (i >> 3));
+  // unaligned keys of every length, empty ones included
+  for (i = 0; i < BATCH_KEYS; ++i)
+  {
+    keys[i] = data + i*3;
+    lens[i] = (i*7) % 61;
+  }
+
+  out[BATCH_KEYS] = 0x1234;
+  gpr_hash_batch_64(keys, lens, BATCH_KEYS, 5, out);
+  for (i = 0; i < BATCH_KEYS; ++i)
+    gpr_assert(out[i] == gpr_murmur_hash_64(keys[i], lens[i], 5));
+  gpr_assert(out[BATCH_KEYS] == 0x1234);
+
+  // bulk interning: more strings than a hash group, duplicates included
+  gpr_memory_init(0);
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+  for (i = 0; i < BATCH_KEYS; ++i)
+  {
+    lens[i]    = (U32)sprintf(names[i], "k%u", i % 150);
+    strings[i] = names[i];
+  }
+  gpr_string_pool_nget_ids(&sp, strings, lens, BATCH_KEYS, ids);
+  for (i = 0; i < BATCH_KEYS; ++i)
+  {
+    gpr_assert(strcmp(gpr_string_pool_string(&sp, ids[i]), names[i]) == 0);
+    gpr_assert(gpr_string_pool_hash(&sp, ids[i]) == gpr_murmur_hash_64(names[i], lens[i], 0));
+    gpr_assert(gpr_string_pool_find_id(&sp, names[i], lens[i]) == ids[i]);
+  }
+  gpr_assert(ids[150] == ids[0] && ids[202] == ids[52]);
+  for (i = 0; i < BATCH_KEYS; ++i) gpr_string_pool_release_id(&sp, ids[i]);
+  gpr_assert(gpr_string_pool_find_id(&sp, "k0", 2) == GPR_STRING_NULL);
+  gpr_string_pool_destroy(&sp);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Concurrent string pool test
+// ---------------------------------------------------------------
+
+#define POOL_NAMES 500
+#define POOL_LOOPS 20
+#define POOL_BULK  40000 // per thread, enough to grow the id directories
+
+typedef struct
+{
+  gpr_string_pool_t sp;
+  gpr_string_t      ids[POOL_NAMES];   // held by the main thread
+  gpr_string_t      bulk[SYNC_THREADS][POOL_BULK]; // released by the main thread
+  volatile U32      thread_i;
+} pool_test_t;
+
+static void pool_test_name(char *name, U32 i)
+{
+  sprintf(name, "name_%u_%s", i, i % 7 ? "short" :
+    "long enough to need its own allocation, past the largest size class of "
+    "the string pool slots, which is 256 bytes: header, chars and terminator "
+    "of this string do not fit in it, so it is allocated alone and freed alone"
+    " when released");
+}
+
+static int pool_test_worker(void *arg)
+{
+  pool_test_t  *pt   = (pool_test_t*)arg;
+  gpr_string_t *bulk = pt->bulk[gpr_atomic_add_U32(&pt->thread_i, 1)];
+  gpr_string_t  ids[POOL_NAMES], id;
+  char          name[512];
+  U32           i, loop;
+
+  for (loop = 0; loop < POOL_LOOPS; ++loop)
+  {
+    // shared names: every thread gets the ids of the main thread
+    for (i = 0; i < POOL_NAMES; ++i)
+    {
+      pool_test_name(name, i);
+      ids[i] = gpr_string_pool_get_id(&pt->sp, name);
+      gpr_assert(ids[i] == pt->ids[i]);
+    }
+    // private names, created and released concurrently, while the
+    // references on the shared names are dropped
+    for (i = 0; i < POOL_NAMES; ++i)
+    {
+      gpr_string_pool_release_id(&pt->sp, ids[i]);
+      sprintf(name, "private_%p_%u", (void*)ids, i);
+      ids[i] = gpr_string_pool_get_id(&pt->sp, name);
+      gpr_assert(strcmp(gpr_string_pool_string(&pt->sp, ids[i]), name) == 0);
+    }
+    for (i = 0; i < POOL_NAMES; ++i)
+      gpr_string_pool_release_id(&pt->sp, ids[i]);
+
+    // a name held by no other thread: its last release, under the write
+    // lock, races the lookups of the other threads under the read lock
+    for (i = 0; i < POOL_NAMES; ++i)
+    {
+      id = gpr_string_pool_get_id(&pt->sp, "transient");
+      gpr_assert(strcmp(gpr_string_pool_string(&pt->sp, id), "transient") == 0);
+      gpr_string_pool_release_id(&pt->sp, id);
+    }
+  }
+
+  // the id directories are doubled while the strings are read with no lock
+  for (i = 0; i < POOL_BULK; ++i)
+  {
+    sprintf(name, "bulk_%p_%u", (void*)bulk, i);
+    bulk[i] = gpr_string_pool_get_id(&pt->sp, name);
+    sprintf(name, "bulk_%p_%u", (void*)bulk, i/2);
+    gpr_assert(strcmp(gpr_string_pool_string(&pt->sp, bulk[i/2]), name) == 0);
+  }
+  return 0;
+}
+
+void test_string_pool_concurrent()
+{
+  static pool_test_t pt;
+  thrd_t threads[SYNC_THREADS];
+  char   name[512];
+  U32    i;
+
+  gpr_memory_init(0);
+  gpr_string_pool_init_concurrent(&pt.sp, 8, gpr_default_allocator,
+    gpr_default_allocator);
+  pt.thread_i = 0;
+  for (i = 0; i < POOL_NAMES; ++i)
+  {
+    pool_test_name(name, i);
+    pt.ids[i] = gpr_string_pool_get_id(&pt.sp, name);
+  }
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_create(&threads[i], pool_test_worker, &pt);
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_join(threads[i], NULL);
+
+  // a shard holds more ids than its first directory
+  gpr_assert(((gpr_string_pool_shard_t*)pt.sp.shards)->num_pages > GPR_STRING_POOL_PAGES);
+  for (i = 0; i < SYNC_THREADS*POOL_BULK; ++i)
+    gpr_string_pool_release_id(&pt.sp, pt.bulk[i/POOL_BULK][i % POOL_BULK]);
+
+  // only the references of the main thread are left
+  for (i = 0; i < POOL_NAMES; ++i)
+  {
+    pool_test_name(name, i);
+    gpr_assert(gpr_string_pool_find_id(&pt.sp, name, (U32)strlen(name)) == pt.ids[i]);
+    gpr_string_pool_release_id(&pt.sp, pt.ids[i]);
+    gpr_assert(!gpr_string_pool_has(&pt.sp, name));
+  }
+  gpr_assert(!gpr_string_pool_has(&pt.sp, "transient"));
+  gpr_string_pool_destroy(&pt.sp);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// String pool snapshot test
+// ---------------------------------------------------------------
+
+// maps a copy of the snapshot at path with the U32 at pos set to value
+static I32 pool_map_patched(const char *path, U32 size, U32 pos, U32 value)
+{
+  char             *blob = (char*)malloc(size);
+  gpr_string_pool_t sp;
+  FILE             *f = fopen(path, "rb");
+  I32               res;
+
+  gpr_assert(fread(blob, 1, size, f) == size && pos + 4 <= size);
+  fclose(f);
+  memcpy(blob + pos, &value, 4);
+  f = fopen("string_pool_patched.bin", "wb");
+  fwrite(blob, 1, size, f);
+  fclose(f);
+  free(blob);
+
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+  res = gpr_string_pool_map(&sp, "string_pool_patched.bin");
+  gpr_string_pool_destroy(&sp);
+  remove("string_pool_patched.bin");
+  return res;
+}
+
+void test_string_pool_snapshot()
+{
+  gpr_string_pool_t          sp, mapped, remapped;
+  gpr_string_pool_snapshot_t s;
+  gpr_string_t               ids[POOL_NAMES], id, added;
+  char                       name[512];
+  U32                        i, first, bucket;
+
+  gpr_memory_init(0);
+
+  // every other name is released before the save
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+  for (i = 0; i < POOL_NAMES; ++i)
+  {
+    pool_test_name(name, i);
+    ids[i] = gpr_string_pool_get_id(&sp, name);
+  }
+  for (i = 1; i < POOL_NAMES; i += 2) gpr_string_pool_release_id(&sp, ids[i]);
+  gpr_assert(gpr_string_pool_save(&sp, "string_pool_test.bin"));
+  gpr_string_pool_destroy(&sp);
+
+  gpr_string_pool_init_concurrent(&mapped, 4, gpr_default_allocator,
+    gpr_default_allocator);
+  gpr_assert(!gpr_string_pool_map(&mapped, "missing_string_pool_test.bin"));
+  gpr_assert(gpr_string_pool_map(&mapped, "string_pool_test.bin"));
+  for (i = 0; i < POOL_NAMES; ++i)
+  {
+    pool_test_name(name, i);
+    id = gpr_string_pool_find_id(&mapped, name, (U32)strlen(name));
+    if (i & 1)
+    {
+      gpr_assert(id == GPR_STRING_NULL);
+      continue;
+    }
+    gpr_assert(id & GPR_STRING_POOL_MAPPED);
+    gpr_assert(gpr_string_pool_get_id(&mapped, name) == id);
+    gpr_assert(strcmp(gpr_string_pool_string(&mapped, id), name) == 0);
+    gpr_assert(gpr_string_pool_size(&mapped, id) == strlen(name));
+    gpr_assert(gpr_string_pool_hash(&mapped, id) ==
+      gpr_murmur_hash_64(name, (U32)strlen(name), 0));
+    gpr_assert(gpr_string_pool_id(gpr_string_pool_string(&mapped, id)) == id);
+    // mapped strings are never freed
+    gpr_string_pool_release_id(&mapped, id);
+    gpr_string_pool_release_id(&mapped, id);
+    gpr_assert(gpr_string_pool_has(&mapped, name));
+    ids[i] = id;
+  }
+
+  // new strings go to the overlay
+  added = gpr_string_pool_get_id(&mapped, "not in the snapshot");
+  gpr_assert(!(added & GPR_STRING_POOL_MAPPED));
+  gpr_assert(gpr_string_pool_find_id(&mapped, "not in the snapshot", 19) == added);
+
+  // a snapshot of both keeps the ids of the mapped strings
+  gpr_assert(gpr_string_pool_save(&mapped, "string_pool_test.bin"));
+  gpr_string_pool_destroy(&mapped);
+  gpr_string_pool_init(&remapped, gpr_default_allocator, gpr_default_allocator);
+  gpr_assert(gpr_string_pool_map(&remapped, "string_pool_test.bin"));
+  for (i = 0; i < POOL_NAMES; i += 2)
+  {
+    pool_test_name(name, i);
+    gpr_assert(gpr_string_pool_find_id(&remapped, name, (U32)strlen(name)) == ids[i]);
+  }
+  id = gpr_string_pool_find_id(&remapped, "not in the snapshot", 19);
+  gpr_assert(id & GPR_STRING_POOL_MAPPED);
+  gpr_assert(strcmp(gpr_string_pool_string(&remapped, id), "not in the snapshot") == 0);
+
+  // buckets, offsets and records out of the blob are rejected
+  s      = *remapped.snapshot;
+  first  = remapped.offsets[0];
+  bucket = remapped.buckets[0];
+  gpr_string_pool_destroy(&remapped);
+  gpr_assert(pool_map_patched("string_pool_test.bin", s.size, s.buckets_pos, bucket));
+  gpr_assert(!pool_map_patched("string_pool_test.bin", s.size, s.buckets_pos, s.num_strings + 1));
+  gpr_assert(!pool_map_patched("string_pool_test.bin", s.size, s.offsets_pos, first + 4));
+  gpr_assert(!pool_map_patched("string_pool_test.bin", s.size, s.offsets_pos, s.strings_pos - 8));
+  gpr_assert(!pool_map_patched("string_pool_test.bin", s.size, s.offsets_pos, s.size));
+  gpr_assert(!pool_map_patched("string_pool_test.bin", s.size, first + 8, s.size));
+  remove("string_pool_test.bin");
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// String pool ids test
+// ---------------------------------------------------------------
+
+// a pool of one shard has every id below GPR_STRING_POOL_MAPPED, more
+// than the 2^21 of a shard out of 1024
+#define POOL_MANY ((1u << 21) + 1000)
+
+void test_string_pool_ids()
+{
+  gpr_string_pool_t sp;
+  gpr_string_t      id = GPR_STRING_NULL;
+  char              name[32];
+  U32               i;
+
+  gpr_memory_init(0);
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+  for (i = 0; i < POOL_MANY; ++i)
+  {
+    sprintf(name, "%u", i);
+    id = gpr_string_pool_get_id(&sp, name);
+    gpr_assert(id != GPR_STRING_NULL);
+  }
+  gpr_assert(id == POOL_MANY && !(id & GPR_STRING_POOL_MAPPED));
+  gpr_assert(strcmp(gpr_string_pool_string(&sp, id), name) == 0);
+  gpr_assert(strcmp(gpr_string_pool_string(&sp, 1), "0") == 0);
+  gpr_string_pool_destroy(&sp);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// String pool collision test
+// ---------------------------------------------------------------
+
+// "b" is given the hash of "a" in the map of the only shard
+void test_string_pool_collision()
+{
+  gpr_string_pool_t        sp;
+  gpr_string_pool_shard_t *shard;
+  gpr_string_t             a, b;
+  gpr_hash_it              it;
+  const U64                hash = gpr_murmur_hash_64("b", 1, 0);
+
+  gpr_memory_init(0);
+  gpr_string_pool_init(&sp, gpr_default_allocator, gpr_default_allocator);
+  shard = (gpr_string_pool_shard_t*)sp.shards;
+  a = gpr_string_pool_get_id(&sp, "a");
+  gpr_multi_hash_insert(gpr_string_t, &shard->string_map, hash, &a);
+
+  gpr_assert(gpr_string_pool_find_id(&sp, "b", 1) == GPR_STRING_NULL);
+  b = gpr_string_pool_get_id(&sp, "b");
+  gpr_assert(b != GPR_STRING_NULL && b != a);
+  gpr_assert(strcmp(gpr_string_pool_string(&sp, b), "b") == 0);
+  gpr_assert(gpr_string_pool_get_id(&sp, "b") == b);
+  gpr_assert(gpr_string_pool_find_id(&sp, "a", 1) == a);
+  gpr_assert(gpr_multi_hash_count(gpr_string_t, &shard->string_map, hash) == 2);
+
+  gpr_string_pool_release_id(&sp, b);
+  gpr_string_pool_release_id(&sp, b);
+  gpr_assert(gpr_string_pool_find_id(&sp, "b", 1) == GPR_STRING_NULL);
+  gpr_assert(*gpr_multi_hash_find_first(gpr_string_t, &shard->string_map, &it, hash) == a);
+
+  gpr_multi_hash_remove(gpr_string_t, &shard->string_map,
+    gpr_multi_hash_find_first(gpr_string_t, &shard->string_map, &it, hash));
+  gpr_string_pool_release_id(&sp, a);
+  gpr_string_pool_destroy(&sp);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Radix tree test
+// ---------------------------------------------------------------
+
+#define RADIX_KEYS 3000
+
+typedef struct
+{
+  U8  keys[RADIX_KEYS][40];
+  U32 lens[RADIX_KEYS];
+  I32 present[RADIX_KEYS];
+} radix_test_t;
+
+typedef struct
+{
+  U8  last[40];
+  U32 last_len, num, max;
+} radix_visit_t;
+
+// keys share long prefixes, are prefixes of each other, and some branch
+// on every byte value
+static void radix_test_key(radix_test_t *rt, U32 i)
+{
+  U8 *k = rt->keys[i];
+
+  switch (i % 4)
+  {
+  case 0:  rt->lens[i] = (U32)sprintf((char*)k, "/api/v1/users/%u", i/4); break;
+  case 1:  rt->lens[i] = (U32)sprintf((char*)k, "/api/v1/users/%u/name", i/4 % 100); break;
+  case 2:
+    memcpy(k, "bin", 3);
+    k[3] = (U8)(i/4);
+    k[4] = (U8)(i/1024);
+    rt->lens[i] = 3 + i/4 % 3;
+    break;
+  default: rt->lens[i] = (U32)sprintf((char*)k, "%x", i*2654435761u); break;
+  }
+}
+
+static I32 radix_key_less(const U8 *a, U32 a_len, const U8 *b, U32 b_len)
+{
+  const I32 c = memcmp(a, b, a_len < b_len ? a_len : b_len);
+  return c < 0 || (c == 0 && a_len < b_len);
+}
+
+static I32 radix_test_visit(const U8 *key, U32 len, void *value, void *arg)
+{
+  radix_visit_t *v = (radix_visit_t*)arg;
+
+  gpr_assert(v->num == 0 || radix_key_less(v->last, v->last_len, key, len));
+  gpr_assert(*(U32*)value < RADIX_KEYS);
+  memcpy(v->last, key, len);
+  v->last_len = len;
+  return ++v->num < v->max;
+}
+
+// equal keys have one present owner, the others find its value
+static void radix_test_check(radix_test_t *rt, gpr_radix_tree_t *t,
+                             const char *prefix, U32 len)
+{
+  radix_visit_t v;
+  U32           i, n = 0;
+
+  for (i = 0; i < RADIX_KEYS; ++i)
+  {
+    const U32 *value = gpr_radix_tree_get(U32, t, rt->keys[i], rt->lens[i]);
+    if (rt->present[i]) gpr_assert(value && *value == i);
+    else gpr_assert(value == NULL || rt->present[*value]);
+    if (rt->present[i] && rt->lens[i] >= len && memcmp(rt->keys[i], prefix, len) == 0)
+      ++n;
+  }
+
+  v.num = 0;
+  v.max = 0xffffffffu;
+  gpr_assert(gpr_radix_tree_visit_prefix(U32, t, prefix, len, radix_test_visit, &v) == n);
+  gpr_assert(v.num == n);
+}
+
+void test_radix_tree()
+{
+  static radix_test_t rt;
+  gpr_radix_tree_t t;
+  radix_visit_t    v;
+  U32              i, value, len;
+  const U32       *found;
+
+  gpr_memory_init(0);
+  gpr_radix_tree_init(U32, &t, gpr_default_allocator);
+  for (i = 0; i < RADIX_KEYS; ++i)
+  {
+    radix_test_key(&rt, i);
+    gpr_radix_tree_set(U32, &t, rt.keys[i], rt.lens[i], &i);
+  }
+  // the last of equal keys holds the value
+  for (i = 0; i < RADIX_KEYS; ++i)
+  {
+    found = gpr_radix_tree_get(U32, &t, rt.keys[i], rt.lens[i]);
+    rt.present[i] = *found == i;
+  }
+  for (i = 0, len = 0; i < RADIX_KEYS; ++i) len += rt.present[i];
+  gpr_assert(gpr_radix_tree_size(U32, &t) == len);
+  gpr_assert(!gpr_radix_tree_has(U32, &t, "/api/v1/users/", 14));
+  gpr_assert(!gpr_radix_tree_has(U32, &t, "/api/v1/users/0/nam", 19));
+
+  radix_test_check(&rt, &t, "", 0);
+  radix_test_check(&rt, &t, "/api/v1/users/1", 15);
+  radix_test_check(&rt, &t, "/api/v", 6);
+  radix_test_check(&rt, &t, "bin", 3);
+  radix_test_check(&rt, &t, "/nothing", 8);
+
+  // the visit stops when asked to
+  v.num = 0;
+  v.max = 10;
+  gpr_assert(gpr_radix_tree_visit_prefix(U32, &t, "/api", 4, radix_test_visit, &v) == 10);
+
+  // longest prefix match
+  value = 1000000;
+  gpr_radix_tree_set(U32, &t, "/api", 4, &value);
+  found = gpr_radix_tree_longest_prefix(U32, &t, "/api/v1/users/12/name/first", 27, &len);
+  gpr_assert(found && len == 21 && rt.lens[*found] == 21 &&
+    memcmp(rt.keys[*found], "/api/v1/users/12/name", 21) == 0);
+  found = gpr_radix_tree_longest_prefix(U32, &t, "/api/v1/users/123456", 20, &len);
+  gpr_assert(found && len == 17 && *found < RADIX_KEYS);
+  found = gpr_radix_tree_longest_prefix(U32, &t, "/api/v2", 7, &len);
+  gpr_assert(found && *found == 1000000 && len == 4);
+  gpr_assert(gpr_radix_tree_longest_prefix(U32, &t, "/ap", 3, &len) == NULL);
+  gpr_assert(gpr_radix_tree_remove(U32, &t, "/api", 4));
+  gpr_assert(!gpr_radix_tree_remove(U32, &t, "/api", 4));
+
+  // removals shrink and collapse the nodes
+  for (i = 0; i < RADIX_KEYS; i += 3)
+  {
+    if (!rt.present[i]) continue;
+    gpr_assert(gpr_radix_tree_remove(U32, &t, rt.keys[i], rt.lens[i]));
+    rt.present[i] = 0;
+  }
+  radix_test_check(&rt, &t, "", 0);
+  radix_test_check(&rt, &t, "/api/v1/users/2", 15);
+  radix_test_check(&rt, &t, "bin", 3);
+
+  for (i = 0; i < RADIX_KEYS; ++i)
+  {
+    if (!rt.present[i]) continue;
+    gpr_assert(gpr_radix_tree_remove(U32, &t, rt.keys[i], rt.lens[i]));
+    gpr_assert(!gpr_radix_tree_has(U32, &t, rt.keys[i], rt.lens[i]));
+    rt.present[i] = 0;
+  }
+  gpr_assert(gpr_radix_tree_size(U32, &t) == 0 && t.root == NULL);
+  gpr_radix_tree_destroy(U32, &t);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// Concurrent hash test
+// ---------------------------------------------------------------
+
+#define CONCURRENT_KEYS 10000
+
+typedef struct
+{
+  gpr_concurrent_hash_t ch;
+  volatile U32          num_created;
+  U32                   thread_i;
+} concurrent_test_t;
+
+static void concurrent_test_create(U64 key, void *value, void *arg)
+{
+  concurrent_test_t *ct = (concurrent_test_t*)arg;
+  *(U64*)value = key*3;
+  gpr_atomic_add_U32(&ct->num_created, 1);
+}
+
+static int concurrent_test_worker(void *arg)
+{
+  concurrent_test_t *ct = (concurrent_test_t*)arg;
+  const U64 first = (U64)gpr_atomic_add_U32(&ct->thread_i, 1)*CONCURRENT_KEYS;
+  U64 i, v;
+
+  // private keys
+  for (i = first; i < first + CONCURRENT_KEYS; ++i)
+    gpr_concurrent_hash_set(U64, &ct->ch, i + 1000000, &i);
+  for (i = first; i < first + CONCURRENT_KEYS; i += 2)
+    gpr_concurrent_hash_remove(U64, &ct->ch, i + 1000000);
+
+  // shared keys, every thread creates them
+  for (i = 0; i < CONCURRENT_KEYS; ++i)
+  {
+    gpr_concurrent_hash_compute_if_absent(U64, &ct->ch, i, 
+      concurrent_test_create, ct, &v);
+    gpr_assert(v == i*3);
+  }
+  return 0;
+}
+
+void test_concurrent_hash()
+{
+  concurrent_test_t ct;
+  thrd_t            threads[SYNC_THREADS];
+  U64               i, v;
+
+  gpr_memory_init(0);
+  gpr_concurrent_hash_init(U64, &ct.ch, 16, gpr_default_allocator);
+  ct.num_created = 0;
+  ct.thread_i    = 0;
+
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_create(&threads[i], concurrent_test_worker, &ct);
+  for (i = 0; i < SYNC_THREADS; ++i)
+    thrd_join(threads[i], NULL);
+
+  gpr_assert(ct.num_created == CONCURRENT_KEYS);
+  gpr_assert(gpr_concurrent_hash_size(U64, &ct.ch) == 
+    CONCURRENT_KEYS + SYNC_THREADS*CONCURRENT_KEYS/2);
+  for (i = 0; i < SYNC_THREADS*CONCURRENT_KEYS; ++i)
+  {
+    const I32 found = gpr_concurrent_hash_get(U64, &ct.ch, i + 1000000, &v);
+    gpr_assert(found == (I32)(i & 1));
+    gpr_assert(!found || v == i);
+  }
+
+  gpr_concurrent_hash_destroy(U64, &ct.ch);
+  gpr_memory_shutdown();
+}
+
+// ---------------------------------------------------------------
+// MAIN
+// ---------------------------------------------------------------
+
+int main()
+{
+  /*test_memory();
+  test_scratch();
+  test_tmp_allocator();
+  test_pool_allocator();
+  test_array();
+  test_idlut();
+  test_hash();
+  test_multi_hash();
+  test_murmur_hash();
+  test_tree();
+  test_string_pool();*/
+  test_idlut_generations();
+  test_string_pool_interning();
+  test_json();
+  test_sync();
+  test_rwlock();
+  test_epoch();
+  test_job();
+  test_hash_growth();
+  test_hash_build();
+  test_frozen_hash();
+  test_hash_set();
+  test_multi_map();
+  test_hash_stats();
+  test_hash_shrink();
+  test_rcu_hash();
+  test_disk_hash();
+  test_murmur_hash_stream();
+  test_fast_hash();
+  test_hash_batch();
+  test_string_pool_concurrent();
+  test_string_pool_snapshot();
+  test_string_pool_ids();
+  test_string_pool_collision();
+  test_radix_tree();
+  test_concurrent_hash();
+  return 0;
 }
\ No newline at end of file
@@ -0,0 +1,20 @@
+// ---------------------------------------------------------------
+// Compile time keys test
+// ---------------------------------------------------------------
+// Built with the tests: a constexpr digest that differs from
+// gpr_murmur_hash_64 fails the build. The expected values are the
+// output of gen_hash_keys.
+// ---------------------------------------------------------------
+
+#include "gpr_murmur_hash_constexpr.h"
+
+// constexpr needs Visual C++ 2015
+#if !defined(_MSC_VER) || _MSC_VER >= 1900
+
+// tail only, one block, one block & a tail, nothing
+static_assert(gpr_json_key_cx("desc")       == 0x30d48b98e1eee9c9ull, "desc");
+static_assert(gpr_json_key_cx("position")   == 0x8bbeb160190f613aull, "position");
+static_assert(gpr_json_key_cx("velocity_x") == 0x1f362964838cf081ull, "velocity_x");
+static_assert(gpr_json_key_cx("")           == 0x0000000000000000ull, "empty");
+
+#endif